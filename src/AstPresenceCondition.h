@@ -2,12 +2,14 @@
 
 #include "AstNode.h"
 #include <cudd.h>
+#include <functional>
 
 namespace souffle {
 
 class AstPresenceCondition : public AstNode {
 public:
-    virtual DdNode* toBDD(DdManager* bddMgr) = 0;
+    /** Builds the BDD of this condition, given the BDD variable of each feature */
+    virtual DdNode* toBDD(DdManager* bddMgr, const std::function<int(RamDomain)>& featureVar) = 0;
 
     virtual bool isTrue() const {
         return false;
@@ -29,7 +31,7 @@ protected:
 public:
     AstPresenceConditionPrimitive(bool v) : val(v) {};
 
-    virtual DdNode* toBDD(DdManager* bddMgr) override {
+    virtual DdNode* toBDD(DdManager* bddMgr, const std::function<int(RamDomain)>& featureVar) override {
         DdNode* ret = val ? Cudd_ReadOne(bddMgr) : Cudd_ReadLogicZero(bddMgr);
         Cudd_Ref(ret);
         return ret;
@@ -79,8 +81,8 @@ public:
     AstPresenceConditionFeat(SymbolTable& _st, const std::string& sym) : 
         st(_st), index(st.lookup(sym)) {}
 
-    virtual DdNode* toBDD(DdManager* bddMgr) override {
-        DdNode* ret = Cudd_bddIthVar(bddMgr, index);
+    virtual DdNode* toBDD(DdManager* bddMgr, const std::function<int(RamDomain)>& featureVar) override {
+        DdNode* ret = Cudd_bddIthVar(bddMgr, featureVar(index));
         Cudd_Ref(ret);
         return ret;
     }
@@ -123,8 +125,8 @@ protected:
 public:
     AstPresenceConditionNeg(AstPresenceCondition& _pc) : pc(&_pc) {}
 
-    virtual DdNode* toBDD(DdManager* bddMgr) override {
-        DdNode* pcBDD = pc->toBDD(bddMgr);
+    virtual DdNode* toBDD(DdManager* bddMgr, const std::function<int(RamDomain)>& featureVar) override {
+        DdNode* pcBDD = pc->toBDD(bddMgr, featureVar);
         DdNode* ret = Cudd_Not(pcBDD);
         Cudd_Ref(ret);
         return ret;
@@ -181,10 +183,10 @@ public:
         BIN_OP _op, AstPresenceCondition& _pc1, AstPresenceCondition& _pc2
         ) : op(_op), pc1(&_pc1), pc2(&_pc2) {};
 
-    virtual DdNode* toBDD(DdManager* bddMgr) override {
+    virtual DdNode* toBDD(DdManager* bddMgr, const std::function<int(RamDomain)>& featureVar) override {
         DdNode* ret = nullptr;
-        auto bdd1 = pc1->toBDD(bddMgr);
-        auto bdd2 = pc2->toBDD(bddMgr);
+        auto bdd1 = pc1->toBDD(bddMgr, featureVar);
+        auto bdd2 = pc2->toBDD(bddMgr, featureVar);
 
 	    //if (bdd1 == bdd2) {
 		//    symmetric = true;
@@ -64,6 +64,9 @@
 /* Relation uses a hash set */
 #define HASHSET_RELATION (0x400)
 
+/* Relation uses a binary decision diagram */
+#define BDD_RELATION (0x800)
+
 namespace souffle {
 
 /*!
@@ -176,6 +179,11 @@ public:
         return (qualifier & HASHSET_RELATION) != 0;
     }
 
+    /** Check whether relation is a BDD relation */
+    bool isBdd() const {
+        return (qualifier & BDD_RELATION) != 0;
+    }
+
     /** Check whether relation is an input relation */
     bool isPrintSize() const {
         return (qualifier & PRINTSIZE_RELATION) != 0;
@@ -258,6 +266,9 @@ public:
         if (isHashset()) {
             os << "hashset ";
         }
+        if (isBdd()) {
+            os << "bdd ";
+        }
         if (isEqRel()) {
             os << "eqrel ";
         }
@@ -627,6 +627,13 @@ void AstSemanticChecker::checkRelation(ErrorReport& report, const TypeEnvironmen
         }
     }
 
+    // BDD relations are only provided by the interpreter
+    if (relation.isBdd() && (Global::config().has("compile") || Global::config().has("generate"))) {
+        report.addWarning("BDD relation " + toString(relation.getName()) +
+                                  " is synthesised with the default data structure",
+                relation.getSrcLoc());
+    }
+
     // start with declaration
     checkRelationDeclaration(report, typeEnv, program, relation);
 
@@ -317,6 +317,23 @@ public:
     }
 };
 
+/**
+ * Transformation pass ordering the atoms of rules by the relation
+ * statistics recorded in the profile of a previous run (--profile-use).
+ * Atoms are chosen greedily, preferring the one expected to produce the
+ * fewest tuples given the variables bound by the atoms before it.
+ * Clauses with a user-defined execution plan are left untouched.
+ */
+class JoinOrderTransformer : public AstTransformer {
+private:
+    bool transform(AstTranslationUnit& translationUnit) override;
+
+public:
+    std::string getName() const override {
+        return "JoinOrderTransformer";
+    }
+};
+
 /**
  * Transformer that holds an arbitrary number of sub-transformations
  */
@@ -229,7 +229,7 @@ std::unique_ptr<RamRelation> getRamRelation(const AstRelation* rel, const TypeEn
 
     return std::make_unique<RamRelation>(name, arity, attributeNames, attributeTypeQualifiers,
             getSymbolMask(*rel, *typeEnv), rel->isInput(), rel->isComputed(), rel->isOutput(), rel->isBTree(),
-            rel->isRbtset(), rel->isHashset(), rel->isBrie(), rel->isEqRel(), istemp);
+            rel->isRbtset(), rel->isHashset(), rel->isBrie(), rel->isEqRel(), rel->isBdd(), istemp);
 }
 
 }  // namespace
@@ -1011,6 +1011,13 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
     std::unique_ptr<RamSequence> updateTable(new RamSequence());
     std::unique_ptr<RamStatement> postamble;
 
+#ifdef USE_MPI
+    /* the processes of a partitioned stratum evaluate the rules on disjoint parts of the delta
+       tables, and exchange the new tuples before checking for the fixpoint */
+    const bool partitioned =
+            Global::config().get("engine") == "mpi" && std::stoi(Global::config().get("partitions")) > 1;
+#endif
+
     // --- create preamble ---
 
     // mappings for temporary relations
@@ -1044,6 +1051,14 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                                 std::unique_ptr<RamRelation>(relNew[rel]->clone())),
                         std::make_unique<RamClear>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
 
+#ifdef USE_MPI
+        /* evaluate the next iteration on the part of the delta table owned by this process */
+        if (partitioned) {
+            appendStmt(updateRelTable,
+                    std::make_unique<RamPartition>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()), 0));
+        }
+#endif
+
         /* measure update time for each relation */
         if (Global::config().has("profile")) {
             updateRelTable = std::make_unique<RamLogTimer>(std::move(updateRelTable),
@@ -1062,6 +1077,12 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
         /* Generate merge operation for temp tables */
         appendStmt(preamble, std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
                                      std::unique_ptr<RamRelation>(rrel[rel]->clone())));
+#ifdef USE_MPI
+        if (partitioned) {
+            appendStmt(preamble,
+                    std::make_unique<RamPartition>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()), 0));
+        }
+#endif
 
         /* Add update operations of relations to parallel statements */
         updateTable->add(std::move(updateRelTable));
@@ -1190,8 +1211,20 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
     std::unique_ptr<RamStatement> res;
     if (preamble) appendStmt(res, std::move(preamble));
     if (!loopSeq->getStatements().empty() && exitCond && updateTable) {
-        appendStmt(res, std::make_unique<RamLoop>(std::move(loopSeq),
-                                std::make_unique<RamExit>(std::move(exitCond)), std::move(updateTable)));
+#ifdef USE_MPI
+        if (partitioned) {
+            std::unique_ptr<RamSequence> exchange(new RamSequence());
+            for (const AstRelation* rel : scc) {
+                exchange->add(std::make_unique<RamExchange>(std::unique_ptr<RamRelation>(relNew[rel]->clone())));
+            }
+            appendStmt(res, std::make_unique<RamLoop>(std::move(loopSeq), std::move(exchange),
+                                    std::make_unique<RamExit>(std::move(exitCond)), std::move(updateTable)));
+        } else
+#endif
+        {
+            appendStmt(res, std::make_unique<RamLoop>(std::move(loopSeq),
+                                    std::make_unique<RamExit>(std::move(exitCond)), std::move(updateTable)));
+        }
     }
     if (postamble) {
         appendStmt(res, std::move(postamble));
@@ -1305,6 +1338,14 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
                                             relation->getArity(), false, relation->isHashset()))));
     };
 
+    // a function to log the statistics of relations
+    const auto& makeRamLogStats = [&](std::unique_ptr<RamStatement>& current, const AstRelation* relation) {
+        appendStmt(current, std::make_unique<RamLogStats>(
+                                    getRamRelation(relation, &typeEnv, getRelationName(relation->getName()),
+                                            relation->getArity(), false, relation->isHashset()),
+                                    LogStatement::sRelation(toString(relation->getName()))));
+    };
+
     // a function to store relations
     const auto& makeRamStore = [&](std::unique_ptr<RamStatement>& current, const AstRelation* relation,
                                        const std::string& outputDirectory, const std::string& fileExtension) {
@@ -1436,6 +1477,13 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
                 makeRamPrintSize(current, relation);
             }
         }
+
+        // record the statistics of all relations in the current SCC to guide the join order of later runs
+        if (Global::config().has("profile")) {
+            for (const auto& relation : allInterns) {
+                makeRamLogStats(current, relation);
+            }
+        }
 #ifdef USE_MPI
         // note that the order of sends is first by relation then second destination
         if (Global::config().get("engine") == "mpi") {
@@ -1600,11 +1648,6 @@ std::unique_ptr<RamTranslationUnit> AstTranslator::translateUnit(AstTranslationU
             debugReport.addSection(DebugReporter::getCodeSection(
                     "ram-program", "RAM Program " + runtimeStr, ramProgStr.str()));
         }
-
-        if (!debugReport.empty()) {
-            std::ofstream debugReportStream(Global::config().get("debug-report"));
-            debugReportStream << debugReport;
-        }
     }
     return std::make_unique<RamTranslationUnit>(std::move(ramProg), symTab, featSymTab, errReport, debugReport);
 }
@@ -0,0 +1,536 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BddRelation.cpp
+ *
+ * Implements lifted relations represented by binary decision diagrams.
+ *
+ ***********************************************************************/
+
+#include "BddRelation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace souffle {
+
+std::vector<std::vector<int>> BddRelation::domains;
+
+// -- helpers --
+
+void BddRelation::assign(DdNode*& target, DdNode* result) {
+    Cudd_Ref(result);
+    Cudd_RecursiveDeref(getManager(), target);
+    target = result;
+}
+
+void BddRelation::addDomains(size_t count) {
+    DdManager* mgr = getManager();
+    while (domains.size() < count) {
+        // each bit is placed above the same bit of the first domain, whose bits are placed
+        // above all other variables, most significant bit first
+        std::vector<int> vars(BITS);
+        for (size_t bit = 0; bit < BITS; bit++) {
+            int level = domains.empty() ? 0 : Cudd_ReadPerm(mgr, domains[0][bit]);
+            vars[bit] = Cudd_NodeReadIndex(Cudd_bddNewVarAtLevel(mgr, level));
+        }
+        domains.push_back(std::move(vars));
+    }
+}
+
+DdNode* BddRelation::getCube(const std::vector<size_t>& domainList) {
+    std::vector<DdNode*> vars;
+    for (size_t domain : domainList) {
+        addDomains(domain + 1);
+        for (int var : domains[domain]) {
+            vars.push_back(Cudd_bddIthVar(getManager(), var));
+        }
+    }
+    DdNode* res = Cudd_bddComputeCube(getManager(), vars.data(), nullptr, vars.size());
+    Cudd_Ref(res);
+    return res;
+}
+
+DdNode* BddRelation::getFeatureCube() {
+    std::vector<DdNode*> vars;
+    for (int var : PresenceCondition::featureVars) {
+        vars.push_back(Cudd_bddIthVar(getManager(), var));
+    }
+    DdNode* res = Cudd_bddComputeCube(getManager(), vars.data(), nullptr, vars.size());
+    Cudd_Ref(res);
+    return res;
+}
+
+DdNode* BddRelation::encode(const std::vector<size_t>& domainList, const RamDomain* values) {
+    std::vector<DdNode*> vars;
+    std::vector<int> phases;
+    for (size_t i = 0; i < domainList.size(); i++) {
+        addDomains(domainList[i] + 1);
+        for (size_t bit = 0; bit < BITS; bit++) {
+            vars.push_back(Cudd_bddIthVar(getManager(), domains[domainList[i]][bit]));
+            phases.push_back((static_cast<uint32_t>(values[i]) >> bit) & 1);
+        }
+    }
+    DdNode* res = Cudd_bddComputeCube(getManager(), vars.data(), phases.data(), vars.size());
+    Cudd_Ref(res);
+    return res;
+}
+
+DdNode* BddRelation::equality(size_t domain, size_t other) {
+    DdManager* mgr = getManager();
+    addDomains(std::max(domain, other) + 1);
+    DdNode* res = Cudd_ReadOne(mgr);
+    Cudd_Ref(res);
+    for (size_t bit = 0; bit < BITS; bit++) {
+        DdNode* same = Cudd_bddXnor(mgr, Cudd_bddIthVar(mgr, domains[domain][bit]),
+                Cudd_bddIthVar(mgr, domains[other][bit]));
+        Cudd_Ref(same);
+        assign(res, Cudd_bddAnd(mgr, res, same));
+        Cudd_RecursiveDeref(mgr, same);
+    }
+    return res;
+}
+
+DdNode* BddRelation::rename(DdNode* f, const std::vector<std::pair<size_t, size_t>>& moves) {
+    DdManager* mgr = getManager();
+    for (const auto& move : moves) {
+        addDomains(std::max(move.first, move.second) + 1);
+    }
+    // the substitution is simultaneous, so domains may be swapped or merged
+    std::vector<int> permutation(Cudd_ReadSize(mgr));
+    for (size_t var = 0; var < permutation.size(); var++) {
+        permutation[var] = var;
+    }
+    for (const auto& move : moves) {
+        for (size_t bit = 0; bit < BITS; bit++) {
+            permutation[domains[move.first][bit]] = domains[move.second][bit];
+        }
+    }
+    DdNode* res = Cudd_bddPermute(mgr, f, permutation.data());
+    Cudd_Ref(res);
+    return res;
+}
+
+std::vector<size_t> BddRelation::getColumns() const {
+    std::vector<size_t> columns(arity);
+    for (size_t i = 0; i < arity; i++) {
+        columns[i] = i;
+    }
+    return columns;
+}
+
+size_t BddRelation::countTuples(DdNode* tuples) const {
+    DdManager* mgr = getManager();
+    const size_t max = std::numeric_limits<size_t>::max();
+
+    // the levels of the variables of the columns, in the variable order
+    std::vector<int> levels;
+    for (size_t i = 0; i < arity; i++) {
+        for (int var : domains[i]) {
+            levels.push_back(Cudd_ReadPerm(mgr, var));
+        }
+    }
+    std::sort(levels.begin(), levels.end());
+    auto position = [&](DdNode* node) -> size_t {
+        node = Cudd_Regular(node);
+        if (Cudd_IsConstant(node)) {
+            return levels.size();
+        }
+        int level = Cudd_ReadPerm(mgr, Cudd_NodeReadIndex(node));
+        return std::lower_bound(levels.begin(), levels.end(), level) - levels.begin();
+    };
+
+    // counts saturate, as there are up to 2^(32 * arity) tuples
+    auto add = [&](size_t a, size_t b) { return a > max - b ? max : a + b; };
+    auto scale = [&](size_t a, size_t bits) -> size_t {
+        if (a == 0) {
+            return 0;
+        }
+        return (bits >= 64 || a > (max >> bits)) ? max : a << bits;
+    };
+
+    // the numbers of satisfying and falsifying assignments of the variables from the level of a
+    // node on; both are kept, as the count of a complemented node swaps them
+    std::unordered_map<DdNode*, std::pair<size_t, size_t>> counts;
+    std::function<std::pair<size_t, size_t>(DdNode*)> count = [&](DdNode* node) {
+        DdNode* regular = Cudd_Regular(node);
+        std::pair<size_t, size_t> res(1, 0);
+        if (!Cudd_IsConstant(regular)) {
+            auto pos = counts.find(regular);
+            if (pos != counts.end()) {
+                res = pos->second;
+            } else {
+                res = {0, 0};
+                size_t level = position(regular);
+                for (DdNode* child : {Cudd_T(regular), Cudd_E(regular)}) {
+                    auto sub = count(child);
+                    size_t skipped = position(child) - level - 1;
+                    res.first = add(res.first, scale(sub.first, skipped));
+                    res.second = add(res.second, scale(sub.second, skipped));
+                }
+                counts[regular] = res;
+            }
+        }
+        if (Cudd_IsComplement(node)) {
+            std::swap(res.first, res.second);
+        }
+        return res;
+    };
+    return scale(count(tuples).first, position(tuples));
+}
+
+// -- terms --
+
+BddRelation::Term::Term(const PresenceCondition* pc) {
+    auto lease = acquireManager();
+    (void)lease;
+    bdd = pc->pcBDD;
+    Cudd_Ref(bdd);
+}
+
+BddRelation::Term::Term(const Term& other) {
+    auto lease = acquireManager();
+    (void)lease;
+    bdd = other.bdd;
+    Cudd_Ref(bdd);
+}
+
+BddRelation::Term& BddRelation::Term::operator=(const Term& other) {
+    auto lease = acquireManager();
+    (void)lease;
+    assign(bdd, other.bdd);
+    return *this;
+}
+
+BddRelation::Term::~Term() {
+    auto lease = acquireManager();
+    (void)lease;
+    Cudd_RecursiveDeref(getManager(), bdd);
+}
+
+bool BddRelation::Term::isFalse() const {
+    return bdd == Cudd_ReadLogicZero(getManager());
+}
+
+void BddRelation::Term::conjoin(const Term& other) {
+    auto lease = acquireManager();
+    (void)lease;
+    assign(bdd, Cudd_bddAnd(getManager(), bdd, other.bdd));
+}
+
+void BddRelation::Term::conjoinNot(const Term& other) {
+    auto lease = acquireManager();
+    (void)lease;
+    assign(bdd, Cudd_bddAnd(getManager(), bdd, Cudd_Not(other.bdd)));
+}
+
+void BddRelation::Term::exists(const std::vector<size_t>& domainList) {
+    if (domainList.empty()) {
+        return;
+    }
+    auto lease = acquireManager();
+    (void)lease;
+    DdNode* cube = getCube(domainList);
+    assign(bdd, Cudd_bddExistAbstract(getManager(), bdd, cube));
+    Cudd_RecursiveDeref(getManager(), cube);
+}
+
+BddRelation::Term BddRelation::Term::equal(size_t domain, size_t other) {
+    auto lease = acquireManager();
+    (void)lease;
+    return Term(equality(domain, other));
+}
+
+BddRelation::Term BddRelation::Term::equal(size_t domain, RamDomain value) {
+    auto lease = acquireManager();
+    (void)lease;
+    return Term(encode({domain}, &value));
+}
+
+// -- relations --
+
+BddRelation::BddRelation(size_t arity) : arity(arity) {
+    assert(arity > 0 && "nullary relations are not represented by BDDs");
+    auto lease = acquireManager();
+    (void)lease;
+    addDomains(arity);
+    bdd = Cudd_ReadLogicZero(getManager());
+    Cudd_Ref(bdd);
+}
+
+BddRelation::~BddRelation() {
+    auto lease = acquireManager();
+    (void)lease;
+    Cudd_RecursiveDeref(getManager(), bdd);
+}
+
+bool BddRelation::empty() const {
+    return bdd == Cudd_ReadLogicZero(getManager());
+}
+
+size_t BddRelation::size() const {
+    auto lease = acquireManager();
+    (void)lease;
+    DdManager* mgr = getManager();
+    DdNode* features = getFeatureCube();
+    DdNode* tuples = Cudd_bddExistAbstract(mgr, bdd, features);
+    Cudd_Ref(tuples);
+    size_t count = countTuples(tuples);
+    Cudd_RecursiveDeref(mgr, tuples);
+    Cudd_RecursiveDeref(mgr, features);
+    return count;
+}
+
+void BddRelation::insert(const RamDomain* tuple) {
+    insertAll({tuple});
+}
+
+void BddRelation::insertAll(const std::vector<const RamDomain*>& tuples) {
+    std::vector<size_t> columns = getColumns();
+    auto lease = acquireManager();
+    (void)lease;
+    DdManager* mgr = getManager();
+    DdNode* batch = Cudd_ReadLogicZero(mgr);
+    Cudd_Ref(batch);
+    for (const RamDomain* tuple : tuples) {
+        DdNode* pc = PresenceCondition::fromId(tuple[arity])->pcBDD;
+        if (pc == Cudd_ReadLogicZero(mgr)) {
+            continue;
+        }
+        DdNode* cube = encode(columns, tuple);
+        DdNode* present = Cudd_bddAnd(mgr, cube, pc);
+        Cudd_Ref(present);
+        assign(batch, Cudd_bddOr(mgr, batch, present));
+        Cudd_RecursiveDeref(mgr, present);
+        Cudd_RecursiveDeref(mgr, cube);
+    }
+    assign(bdd, Cudd_bddOr(mgr, bdd, batch));
+    Cudd_RecursiveDeref(mgr, batch);
+}
+
+void BddRelation::insert(const BddRelation& other) {
+    assert(getArity() == other.getArity());
+    auto lease = acquireManager();
+    (void)lease;
+    assign(bdd, Cudd_bddOr(getManager(), bdd, other.bdd));
+}
+
+void BddRelation::insert(const Term& term, const std::vector<Column>& columns, const BddRelation* filter) {
+    assert(columns.size() == arity);
+    auto lease = acquireManager();
+    (void)lease;
+    DdManager* mgr = getManager();
+
+    // quantify all domains but the projected ones
+    std::vector<size_t> projected;
+    for (const Column& column : columns) {
+        assert(column.kind != Column::UNBOUND);
+        if (column.kind == Column::DOMAIN) {
+            projected.push_back(column.value);
+        }
+    }
+    for (size_t domain : projected) {
+        addDomains(domain + 1);
+    }
+    std::vector<size_t> others;
+    for (size_t domain = 0; domain < domains.size(); domain++) {
+        if (std::find(projected.begin(), projected.end(), domain) == projected.end()) {
+            others.push_back(domain);
+        }
+    }
+    DdNode* cube = getCube(others);
+    DdNode* res = Cudd_bddExistAbstract(mgr, term.bdd, cube);
+    Cudd_Ref(res);
+    Cudd_RecursiveDeref(mgr, cube);
+
+    // move each projected domain into the first column it is projected to
+    std::vector<std::pair<size_t, size_t>> moves;
+    std::vector<size_t> first(columns.size());
+    for (size_t i = 0; i < columns.size(); i++) {
+        first[i] = i;
+        for (size_t j = 0; j < i; j++) {
+            if (columns[i].kind == Column::DOMAIN && columns[j].kind == Column::DOMAIN &&
+                    columns[j].value == columns[i].value) {
+                first[i] = j;
+                break;
+            }
+        }
+        if (columns[i].kind == Column::DOMAIN && first[i] == i) {
+            moves.emplace_back(columns[i].value, i);
+        }
+    }
+    DdNode* renamed = rename(res, moves);
+    Cudd_RecursiveDeref(mgr, res);
+    res = renamed;
+
+    // the remaining columns repeat a domain or hold a constant
+    for (size_t i = 0; i < columns.size(); i++) {
+        DdNode* constraint = nullptr;
+        if (columns[i].kind == Column::CONSTANT) {
+            constraint = encode({i}, &columns[i].value);
+        } else if (first[i] != i) {
+            constraint = equality(i, first[i]);
+        } else {
+            continue;
+        }
+        assign(res, Cudd_bddAnd(mgr, res, constraint));
+        Cudd_RecursiveDeref(mgr, constraint);
+    }
+
+    if (filter) {
+        assign(res, Cudd_bddAnd(mgr, res, Cudd_Not(filter->bdd)));
+    }
+    assign(bdd, Cudd_bddOr(mgr, bdd, res));
+    Cudd_RecursiveDeref(mgr, res);
+}
+
+void BddRelation::purge() {
+    auto lease = acquireManager();
+    (void)lease;
+    assign(bdd, Cudd_ReadLogicZero(getManager()));
+}
+
+const PresenceCondition* BddRelation::getPC(const RamDomain* tuple) const {
+    DdNode* pc;
+    {
+        auto lease = acquireManager();
+        (void)lease;
+        DdNode* cube = encode(getColumns(), tuple);
+        pc = Cudd_Cofactor(getManager(), bdd, cube);
+        Cudd_Ref(pc);
+        Cudd_RecursiveDeref(getManager(), cube);
+    }
+    const PresenceCondition* res = PresenceCondition::fromBDD(pc);
+    auto lease = acquireManager();
+    (void)lease;
+    Cudd_RecursiveDeref(getManager(), pc);
+    return res;
+}
+
+BddRelation::Term BddRelation::select(const std::vector<Column>& pattern) const {
+    assert(pattern.size() == arity);
+    auto lease = acquireManager();
+    (void)lease;
+    DdManager* mgr = getManager();
+
+    std::vector<size_t> constantColumns;
+    std::vector<RamDomain> constants;
+    std::vector<size_t> unbound;
+    std::vector<std::pair<size_t, size_t>> moves;
+    for (size_t i = 0; i < arity; i++) {
+        switch (pattern[i].kind) {
+            case Column::DOMAIN:
+                moves.emplace_back(i, pattern[i].value);
+                break;
+            case Column::CONSTANT:
+                constantColumns.push_back(i);
+                constants.push_back(pattern[i].value);
+                break;
+            case Column::UNBOUND:
+                unbound.push_back(i);
+                break;
+        }
+    }
+
+    DdNode* res = bdd;
+    Cudd_Ref(res);
+    if (!constantColumns.empty()) {
+        DdNode* cube = encode(constantColumns, constants.data());
+        assign(res, Cudd_Cofactor(mgr, res, cube));
+        Cudd_RecursiveDeref(mgr, cube);
+    }
+    if (!unbound.empty()) {
+        DdNode* cube = getCube(unbound);
+        assign(res, Cudd_bddExistAbstract(mgr, res, cube));
+        Cudd_RecursiveDeref(mgr, cube);
+    }
+
+    // columns bound to the same domain are merged by the substitution
+    DdNode* renamed = rename(res, moves);
+    Cudd_RecursiveDeref(mgr, res);
+    return Term(renamed);
+}
+
+void BddRelation::decode(std::vector<RamDomain>& out) const {
+    std::vector<RamDomain> tuples;
+    std::vector<DdNode*> pcs;
+    {
+        auto lease = acquireManager();
+        (void)lease;
+        DdManager* mgr = getManager();
+        DdNode* features = getFeatureCube();
+        DdNode* present = Cudd_bddExistAbstract(mgr, bdd, features);
+        Cudd_Ref(present);
+        Cudd_RecursiveDeref(mgr, features);
+
+        // collect the tuples of all cubes, expanding the bits they do not constrain
+        DdGen* gen;
+        int* cube;
+        CUDD_VALUE_TYPE value;
+        Cudd_ForeachCube(mgr, present, gen, cube, value) {
+            std::vector<RamDomain> tuple(arity, 0);
+            std::vector<std::pair<size_t, size_t>> free;
+            for (size_t i = 0; i < arity; i++) {
+                for (size_t bit = 0; bit < BITS; bit++) {
+                    int literal = cube[domains[i][bit]];
+                    if (literal == 1) {
+                        tuple[i] |= RamDomain(uint32_t(1) << bit);
+                    } else if (literal == 2) {
+                        free.emplace_back(i, bit);
+                    }
+                }
+            }
+            std::vector<bool> set(free.size(), false);
+            while (true) {
+                tuples.insert(tuples.end(), tuple.begin(), tuple.end());
+                // advance to the next assignment of the free bits, like a binary counter
+                size_t k = 0;
+                for (; k < free.size() && set[k]; k++) {
+                    set[k] = false;
+                    tuple[free[k].first] ^= RamDomain(uint32_t(1) << free[k].second);
+                }
+                if (k == free.size()) {
+                    break;
+                }
+                set[k] = true;
+                tuple[free[k].first] ^= RamDomain(uint32_t(1) << free[k].second);
+            }
+        }
+        Cudd_RecursiveDeref(mgr, present);
+
+        // the condition of each tuple is the restriction of the relation to the tuple
+        std::vector<size_t> columns = getColumns();
+        for (size_t i = 0; i < tuples.size(); i += arity) {
+            DdNode* tupleCube = encode(columns, &tuples[i]);
+            DdNode* pc = Cudd_Cofactor(mgr, bdd, tupleCube);
+            Cudd_Ref(pc);
+            Cudd_RecursiveDeref(mgr, tupleCube);
+            pcs.push_back(pc);
+        }
+    }
+
+    for (size_t i = 0; i < pcs.size(); i++) {
+        out.insert(out.end(), tuples.begin() + i * arity, tuples.begin() + (i + 1) * arity);
+        out.push_back(PresenceCondition::fromBDD(pcs[i])->getId());
+    }
+
+    auto lease = acquireManager();
+    (void)lease;
+    for (DdNode* pc : pcs) {
+        Cudd_RecursiveDeref(getManager(), pc);
+    }
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,201 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BddRelation.h
+ *
+ * Defines lifted relations represented by binary decision diagrams.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "PresenceCondition.h"
+#include "RamTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+#include <cudd.h>
+
+namespace souffle {
+
+/**
+ * A lifted relation represented symbolically, by the characteristic function of its tuples
+ * and their presence conditions in the BDD manager of the presence conditions.
+ *
+ * Values are encoded in binary over attribute domains. A domain consists of one BDD variable
+ * per bit of a RamDomain; domains are shared by all BDD relations, and column i of a relation
+ * is encoded in domain i. The bits of all domains are interleaved, most significant bits
+ * first, above the feature variables. Restricting the BDD of a relation to the bits of a tuple
+ * yields the presence condition of the tuple, such that union, join and projection of lifted
+ * relations are plain BDD operations, and relations of many regular tuples stay small.
+ *
+ * As the BDD manager is not thread-safe, all operations are serialised.
+ */
+class BddRelation {
+public:
+    /** The number of BDD variables of a domain */
+    static const size_t BITS = sizeof(RamDomain) * 8;
+
+    /** A column of a pattern, bound to a domain or a constant, or unbound */
+    struct Column {
+        enum Kind { DOMAIN, CONSTANT, UNBOUND };
+        Kind kind;
+
+        /** The domain or the constant */
+        RamDomain value;
+    };
+
+    /**
+     * An intermediate result of a query over BDD relations, e.g. the join of the atoms of a
+     * rule with one domain per column of each atom, as a BDD over these domains and the
+     * feature variables.
+     */
+    class Term {
+    public:
+        /** The term holding under the given presence condition, independently of any domain */
+        explicit Term(const PresenceCondition* pc);
+
+        Term(const Term& other);
+
+        Term& operator=(const Term& other);
+
+        ~Term();
+
+        /** Check whether the term holds nowhere */
+        bool isFalse() const;
+
+        /** Conjoin another term */
+        void conjoin(const Term& other);
+
+        /** Conjoin the negation of another term */
+        void conjoinNot(const Term& other);
+
+        /** Quantify the given domains existentially */
+        void exists(const std::vector<size_t>& domains);
+
+        /** The term of two domains holding the same value */
+        static Term equal(size_t domain, size_t other);
+
+        /** The term of a domain holding a constant */
+        static Term equal(size_t domain, RamDomain value);
+
+    private:
+        /** Takes over a referenced BDD */
+        explicit Term(DdNode* bdd) : bdd(bdd) {}
+
+        DdNode* bdd;
+
+        friend class BddRelation;
+    };
+
+    explicit BddRelation(size_t arity);
+
+    BddRelation(const BddRelation& other) = delete;
+
+    ~BddRelation();
+
+    /** Get arity of relation */
+    size_t getArity() const {
+        return arity;
+    }
+
+    /** Check whether relation is empty */
+    bool empty() const;
+
+    /** Gets the number of contained tuples */
+    size_t size() const;
+
+    /** Insert a tuple, followed by the identifier of its presence condition */
+    void insert(const RamDomain* tuple);
+
+    /**
+     * Insert a batch of tuples, each followed by the identifier of its presence condition. The
+     * tuples are disjoined among themselves first, such that the relation is extended once.
+     */
+    void insertAll(const std::vector<const RamDomain*>& tuples);
+
+    /** Merge another relation into this relation */
+    void insert(const BddRelation& other);
+
+    /**
+     * Insert the tuples of a term. The i-th column of the tuples is given by the i-th of the
+     * columns, bound to a domain of the term or to a constant, and the tuples are present
+     * under the condition of the term. If a filter is given, only the part of a condition
+     * under which its tuple is not contained in the filter is inserted.
+     */
+    void insert(const Term& term, const std::vector<Column>& columns, const BddRelation* filter = nullptr);
+
+    /** Purge table */
+    void purge();
+
+    /** Obtains the presence condition of a tuple, which is false if the tuple is not contained */
+    const PresenceCondition* getPC(const RamDomain* tuple) const;
+
+    /**
+     * The tuples matching a pattern, as a term over the domains of the pattern. The i-th
+     * column of the tuples is encoded in the domain of the i-th column of the pattern, has
+     * to equal its constant, or is quantified if unbound.
+     */
+    Term select(const std::vector<Column>& pattern) const;
+
+    /** Append all tuples, each followed by the identifier of its presence condition, to a flat buffer */
+    void decode(std::vector<RamDomain>& out) const;
+
+private:
+    /** Arity of relation */
+    const size_t arity;
+
+    /** The tuples of the relation, in the domains of their columns */
+    DdNode* bdd;
+
+    /** The BDD variables of each domain, indexed by bit, least significant first */
+    static std::vector<std::vector<int>> domains;
+
+    /** Acquire the lock of the BDD manager */
+    static Lock::Lease acquireManager() {
+        return PresenceCondition::bddLock.acquire();
+    }
+
+    // the following helpers are to be called while holding the lock of the BDD manager
+
+    static DdManager* getManager() {
+        return PresenceCondition::bddMgr;
+    }
+
+    /** Replace a referenced BDD by a fresh result of an operation */
+    static void assign(DdNode*& target, DdNode* result);
+
+    /** Make sure that the given number of domains exists */
+    static void addDomains(size_t count);
+
+    /** The conjunction of the variables of the given domains, for quantifying them */
+    static DdNode* getCube(const std::vector<size_t>& domainList);
+
+    /** The conjunction of all feature variables, for quantifying them */
+    static DdNode* getFeatureCube();
+
+    /** The encoding of the values of the given domains */
+    static DdNode* encode(const std::vector<size_t>& domainList, const RamDomain* values);
+
+    /** The BDD of two domains holding the same value */
+    static DdNode* equality(size_t domain, size_t other);
+
+    /** Move the values of some domains into others */
+    static DdNode* rename(DdNode* f, const std::vector<std::pair<size_t, size_t>>& moves);
+
+    /** The domains of the columns of this relation */
+    std::vector<size_t> getColumns() const;
+
+    /** The exact number of tuples of a BDD over the domains of the columns of this relation */
+    size_t countTuples(DdNode* tuples) const;
+};
+
+}  // end of namespace souffle
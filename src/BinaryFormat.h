@@ -0,0 +1,79 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BinaryFormat.h
+ *
+ * Defines the layout of the binary relation format shared by the
+ * binary reader and writer.
+ *
+ * A file consists of
+ *  - a header,
+ *  - one column of RamDomain values per attribute, followed by a column of
+ *    presence condition numbers, each holding one value per tuple,
+ *  - a symbol segment listing the symbols of the file, and
+ *  - a presence condition segment listing the presence conditions of the file.
+ *
+ * Symbol columns hold numbers into the symbol segment and the presence
+ * condition column holds numbers into the presence condition segment, such
+ * that files do not depend on the symbol tables of the programs exchanging
+ * them. Each segment consists of the number n of its strings, n + 1 offsets
+ * relative to the start of its characters, and the characters. All parts
+ * start at a multiple of 8 bytes, such that a mapped file can be accessed
+ * in place.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace souffle {
+
+namespace binary {
+
+/** Identifies binary relation files */
+static const char MAGIC[8] = {'S', 'O', 'U', 'F', 'F', 'L', 'E', 'B'};
+
+/** The version of the format */
+static const uint32_t VERSION = 1;
+
+/** The header of a binary relation file */
+struct Header {
+    char magic[8];
+    uint32_t version;
+    /** The size of RamDomain values in bytes */
+    uint32_t domainSize;
+    /** The number of attribute columns */
+    uint64_t arity;
+    /** The number of tuples */
+    uint64_t tuples;
+    /** The offset of the symbol segment */
+    uint64_t symbolOffset;
+    /** The offset of the presence condition segment */
+    uint64_t pcOffset;
+};
+
+/** The size of the given number of bytes padded to a multiple of 8 */
+inline uint64_t align(uint64_t size) {
+    return (size + 7) & ~uint64_t(7);
+}
+
+/** The offset of the given column; the presence condition column follows the attribute columns */
+inline uint64_t columnOffset(const Header& header, uint64_t column) {
+    return sizeof(Header) + column * align(header.tuples * sizeof(RamDomain));
+}
+
+}  // end of namespace binary
+
+}  // end of namespace souffle
@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cassert>
 #include <exception>
 #include <iostream>
 #include <mutex>
@@ -210,6 +213,11 @@ class BlockList {
 
     mutable size_t m_size = 0;
 
+    /** copies a single element */
+    static void copy(T& to, const T& from) {
+        to = from;
+    }
+
 public:
     BlockList() : listData() {}
 
@@ -218,7 +226,11 @@ public:
         size_t othblocks = other.listData.size();
         for (size_t i = 0; i < othblocks; ++i) {
             listData.push_back(new T[BLOCKSIZE]);
-            memcpy(listData.at(i), other.listData.at(i), BLOCKSIZE);
+            // only the elements up to the size are initialised
+            size_t count = std::min(BLOCKSIZE, other.m_size - i * BLOCKSIZE);
+            for (size_t j = 0; j < count; ++j) {
+                copy(listData.at(i)[j], other.listData.at(i)[j]);
+            }
         }
         this->m_size = other.m_size;
     }
@@ -425,4 +437,98 @@ inline void BlockList<std::atomic<block_t>>::add(const std::atomic<block_t>& val
 
     ++m_size;
 }
+
+/** this is necessary for atomics, as we cannot use the copy assignment */
+template <>
+inline void BlockList<std::atomic<block_t>>::copy(std::atomic<block_t>& to, const std::atomic<block_t>& from) {
+    to.store(from.load());
+}
+
+/**
+ * A concurrent store of slots addressed by consecutive indices, each slot holding
+ * a fixed number of elements. Slots are allocated in blocks on demand, each block
+ * doubling the size of its predecessor, and are never moved, such that a slot
+ * which has been allocated is read without locking. Clearing or swapping is
+ * undefined behaviour while slots are accessed concurrently.
+ */
+template <class T>
+class BlockStore {
+    /** log2 of the number of slots in the first block */
+    static constexpr size_t FIRST_BLOCK_BITS = 10;
+
+    /** Number of blocks, each block doubling the size of its predecessor */
+    static constexpr size_t NUM_BLOCKS = 64 - FIRST_BLOCK_BITS;
+
+    /** The number of elements of each slot */
+    const size_t slotSize;
+
+    /** The blocks storing the slots by index */
+    std::array<std::atomic<T*>, NUM_BLOCKS> blocks;
+
+    /** Obtain the block holding the given index */
+    static size_t getBlock(size_t index) {
+        return 63 - __builtin_clzll(index + (size_t(1) << FIRST_BLOCK_BITS)) - FIRST_BLOCK_BITS;
+    }
+
+    /** Obtain the number of slots of the given block */
+    static size_t getBlockSize(size_t block) {
+        return size_t(1) << (block + FIRST_BLOCK_BITS);
+    }
+
+    /** Obtain the position of the given index within its block */
+    static size_t getOffset(size_t index, size_t block) {
+        return index + (size_t(1) << FIRST_BLOCK_BITS) - getBlockSize(block);
+    }
+
+public:
+    explicit BlockStore(size_t slotSize = 1) : slotSize(slotSize) {
+        for (auto& block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    BlockStore(const BlockStore&) = delete;
+    BlockStore& operator=(const BlockStore&) = delete;
+
+    ~BlockStore() {
+        clear();
+    }
+
+    /** Obtain the slot of the given index, allocating its block if necessary */
+    T* getSlot(size_t index) {
+        size_t block = getBlock(index);
+        T* cur = blocks[block].load(std::memory_order_acquire);
+        if (cur == nullptr) {
+            auto* fresh = new T[getBlockSize(block) * slotSize];
+            if (blocks[block].compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) {
+                cur = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return cur + getOffset(index, block) * slotSize;
+    }
+
+    /** Obtain the slot of an index whose block has already been allocated; does not lock */
+    const T* get(size_t index) const {
+        size_t block = getBlock(index);
+        return blocks[block].load(std::memory_order_acquire) + getOffset(index, block) * slotSize;
+    }
+
+    /** Free all blocks */
+    void clear() {
+        for (auto& block : blocks) {
+            delete[] block.exchange(nullptr);
+        }
+    }
+
+    /** Exchange the blocks of two stores of the same slot size */
+    void swap(BlockStore& other) {
+        assert(slotSize == other.slotSize && "swapping stores of different slot sizes");
+        for (size_t i = 0; i < NUM_BLOCKS; i++) {
+            blocks[i] = other.blocks[i].exchange(blocks[i]);
+        }
+    }
+};
+
 }  // namespace souffle
@@ -619,6 +619,12 @@ public:
         return index.find(key, hints);
     }
 
+    /* Obtains the presence condition column of the stored copy of the given tuple, null if absent */
+    RamDomain* getPCSlot(const key_type& key, operation_hints& hints) const {
+        auto pos = find(key, hints);
+        return (pos != index.end()) ? &(*pos).pc : nullptr;
+    }
+
     template <typename SubIndex>
     range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
         // more efficient support for full-indices
@@ -726,6 +732,12 @@ public:
         return index.find(&key, hints);
     }
 
+    /* Obtains the presence condition column of the referenced tuple equal to the given one, null if absent */
+    RamDomain* getPCSlot(const key_type& key, operation_hints& hints) const {
+        auto pos = find(key, hints);
+        return (pos != end()) ? &(*pos).pc : nullptr;
+    }
+
     template <typename SubIndex>
     range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
         // more efficient support for full-indices
@@ -797,6 +809,18 @@ public:
     }
 };
 
+// -- checks whether an index references the tuples of a table instead of storing copies --
+
+template <typename IndexType>
+struct is_indirect_index {
+    enum { value = false };
+};
+
+template <typename Tuple, typename Index>
+struct is_indirect_index<IndirectIndex<Tuple, Index>> {
+    enum { value = true };
+};
+
 // -------------------------------------------------------------
 
 template <unsigned Pos, unsigned... Order>
@@ -1189,6 +1213,131 @@ private:
         return res;
     }
 };
+// -------------------------------------------------------------
+//                  Presence Condition Column
+// -------------------------------------------------------------
+
+/* Reads the presence condition column of a stored tuple. */
+inline const PresenceCondition* readPC(const RamDomain& slot) {
+    return PresenceCondition::fromId(__atomic_load_n(&slot, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * Disjoins the given presence condition into the presence condition column of a stored tuple.
+ * Concurrent updates of the same tuple are merged by retrying, hence no lock is required.
+ *
+ * @return the id of the presence condition the column held before
+ */
+inline RamDomain widenPC(RamDomain& slot, const PresenceCondition* pc) {
+    RamDomain cur = __atomic_load_n(&slot, __ATOMIC_ACQUIRE);
+    while (true) {
+        RamDomain next = PresenceCondition::fromId(cur)->disjoin(pc)->getId();
+        if (next == cur ||
+                __atomic_compare_exchange_n(&slot, &cur, next, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return cur;
+        }
+    }
+}
+
+/**
+ * The presence condition column of the tuples maintained by an index. B-Tree based indices store
+ * the tuples themselves, hence the column is read and updated in place.
+ *
+ * @tparam T .. the tuple type
+ * @tparam IndexType .. the type of index storing the tuples
+ */
+template <typename T, typename IndexType>
+class PCColumn {
+public:
+    using operation_hints = typename IndexType::operation_hints;
+
+    // the tuples enumerated by the index carry their up-to-date column
+    enum { in_place = true };
+
+    void insert(const T&) {
+        // nothing to do here, the column is stored along with the tuple
+    }
+
+    const PresenceCondition* get(const IndexType& index, const T& tuple, operation_hints& hints) const {
+        const RamDomain* slot = index.getPCSlot(tuple, hints);
+        return (slot) ? readPC(*slot) : PresenceCondition::makeFalse();
+    }
+
+    void widen(const IndexType& index, const T& tuple, const PresenceCondition* pc, operation_hints& hints) {
+        if (RamDomain* slot = index.getPCSlot(tuple, hints)) {
+            widenPC(*slot, pc);
+        }
+    }
+
+    void insertAll(const PCColumn&) {
+        // nothing to do here, the column is merged along with the tuples
+    }
+
+    void clear() {
+        // nothing to do here
+    }
+};
+
+/**
+ * Tries do not materialise the tuples they contain, so the column of a trie index is kept
+ * in a B-Tree of the inserted tuples instead.
+ */
+template <typename T, typename Index>
+class PCColumn<T, TrieIndex<Index>> {
+protected:
+    btree_set<T, typename Index::comparator> tuples;
+
+public:
+    // the tuples enumerated by the index are reconstructed without their column
+    enum { in_place = false };
+
+    template <typename IndexType, typename Hints>
+    const PresenceCondition* get(const IndexType&, const T& tuple, Hints&) const {
+        auto pos = tuples.find(tuple);
+        return (pos != tuples.end()) ? readPC((*pos).pc) : PresenceCondition::makeFalse();
+    }
+
+    void insert(const T& tuple) {
+        // the index may be updated by another thread meanwhile, so duplicates are merged right away
+        if (!tuples.insert(tuple)) {
+            widenPC((*tuples.find(tuple)).pc, PresenceCondition::fromId(tuple.pc));
+        }
+    }
+
+    template <typename IndexType, typename Hints>
+    void widen(const IndexType&, const T& tuple, const PresenceCondition* pc, Hints&) {
+        auto pos = tuples.find(tuple);
+        if (pos != tuples.end()) {
+            widenPC((*pos).pc, pc);
+        }
+    }
+
+    void insertAll(const PCColumn& other) {
+        tuples.insertAll(other.tuples);
+    }
+
+    void clear() {
+        tuples.clear();
+    }
+};
+
+/**
+ * Disjoint sets do not materialise their pairs either; the column is kept for the inserted
+ * pairs, while pairs only implied by the closure are present unconditionally.
+ */
+template <typename T, typename Index>
+class PCColumn<T, DisjointSetIndex<Index>> : public PCColumn<T, TrieIndex<Index>> {
+public:
+    template <typename Hints>
+    const PresenceCondition* get(const DisjointSetIndex<Index>& index, const T& tuple, Hints& hints) const {
+        auto pos = this->tuples.find(tuple);
+        if (pos != this->tuples.end()) {
+            return readPC((*pos).pc);
+        }
+        return index.contains(tuple, hints) ? PresenceCondition::makeTrue() : PresenceCondition::makeFalse();
+    }
+};
+
 // -------------------------------------------------------------
 
 /* A direct index factory only supporting direct indices */
@@ -1222,8 +1371,9 @@ struct index_factory;
 /* The index structure selection for complete indices. */
 template <typename T, typename Index>
 struct index_factory<T, Index, true> {
-    // pick direct or indirect indexing based on size of tuple
-    using type = typename std::conditional<sizeof(T) <= 2 * sizeof(void*),  // if tuple smaller than a bound
+    // pick direct or indirect indexing based on size of tuple, not counting its presence condition
+    using type = typename std::conditional<T::arity * sizeof(typename T::value_type) <=
+                                                   2 * sizeof(void*),  // if tuple smaller than a bound
             typename direct_index_factory<T, Index, true>::type,            // use a direct index
             IndirectIndex<T, Index>  // otherwise use an indirect, pointer based index
             >::type;
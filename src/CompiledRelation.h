@@ -225,12 +225,17 @@ struct RelationBase {
     // the type of tuple maintained by this relation
     using tuple_type = Tuple<RamDomain, arity>;
 
+    /* Obtains the arity of this relation */
+    std::size_t getArity() const {
+        return arity;
+    }
+
     // -- contains wrapper --
 
     template <typename... Args>
     bool contains(Args... args) const {
-        RamDomain data[arity] = {RamDomain(args)...};
-        return static_cast<const Derived*>(this)->contains(reinterpret_cast<const tuple_type&>(data));
+        const tuple_type tuple = {{RamDomain(args)...}};
+        return static_cast<const Derived*>(this)->contains(tuple);
     }
 
     bool contains(const tuple_type& tuple) const {
@@ -242,8 +247,8 @@ struct RelationBase {
 
     template <typename... Args>
     bool insert(Args... args) {
-        RamDomain data[arity] = {RamDomain(args)...};
-        return static_cast<Derived*>(this)->insert(reinterpret_cast<const tuple_type&>(data));
+        const tuple_type tuple = {{RamDomain(args)...}};
+        return static_cast<Derived*>(this)->insert(tuple);
     }
 
     bool insert(const RamRecord* rec) {
@@ -251,18 +256,48 @@ struct RelationBase {
         return insert(rec->field, rec->pc);
     }
 
-    bool insert(const RamDomain* ramDomain, const PresenceCondition* pc=nullptr) {
-        RamDomain data[arity];
-        std::copy(ramDomain, ramDomain + arity, data);
-        const auto& tuple = reinterpret_cast<const tuple_type&>(data);
+    /* Inserts the tuple given by its arity values, present under pc */
+    bool insert(const RamDomain* ramDomain, const PresenceCondition* pc) {
+        tuple_type tuple;
+        std::copy(ramDomain, ramDomain + arity, tuple.data);
+        return insertLifted(tuple, pc);
+    }
+
+    bool insert(const tuple_type& tuple) {
+        return insertLifted(tuple, PresenceCondition::makeTrue());
+    }
+
+    bool insertLifted(const tuple_type& tuple, const PresenceCondition* pc) {
         typename Derived::operation_context ctxt;
+        return insertLifted(tuple, pc, ctxt);
+    }
+
+    /* Inserts a tuple present under pc; the presence conditions of duplicates are disjoined */
+    template <typename Context>
+    bool insertLifted(const tuple_type& tuple, const PresenceCondition* pc, Context& ctxt) {
+        assert(pc);
+        if (!pc->isSAT()) {
+            return false;
+        }
 
-        return static_cast<Derived*>(this)->insert(tuple, ctxt);
+        // new tuples are stored along with their presence condition column
+        tuple_type lifted = tuple;
+        lifted.pc = pc->getId();
+        if (asDerived().insert(lifted, ctxt)) {
+            return true;
+        }
+        asDerived().widenPC(lifted, pc, ctxt);
+        return false;
     }
 
-    bool insert(const tuple_type& tuple) {
+    /* Merges all tuples of another relation into this relation, including their presence conditions */
+    template <typename Other>
+    void insertAllLifted(const Other& other) {
         typename Derived::operation_context ctxt;
-        return static_cast<Derived*>(this)->insert(tuple, ctxt);
+        typename Other::operation_context otherCtxt;
+        for (const auto& cur : other) {
+            insertLifted(cur, other.getPC(cur, otherCtxt), ctxt);
+        }
     }
 
     // -- IO --
@@ -281,9 +316,37 @@ struct RelationBase {
         static_cast<const Derived*>(this)->printHintStatistics(out, prefix);
     }
 
+    // -- presence conditions --
+
+    /* Obtains the presence condition of the given tuple, false if it is not contained */
     const PresenceCondition* getPC(const tuple_type& tuple) const {
-        //TODO
-        return PresenceCondition::makeTrue();
+        typename Derived::operation_context ctxt;
+        return asDerived().getPC(tuple, ctxt);
+    }
+
+    /* Obtains the presence condition under which any of the tuples in the given range is present */
+    template <typename Range>
+    const PresenceCondition* getRangePC(const Range& range) const {
+        typename Derived::operation_context ctxt;
+        const PresenceCondition* res = PresenceCondition::makeFalse();
+        for (const auto& cur : range) {
+            res = res->disjoin(asDerived().getPC(cur, ctxt));
+            if (res == PresenceCondition::makeTrue() || res->isTrue()) {
+                break;
+            }
+        }
+        return res;
+    }
+
+    /* Obtains the presence condition of a tuple enumerated by a full scan of this relation */
+    const PresenceCondition* getScanPC(const tuple_type& tuple) const {
+        return getPC(tuple);
+    }
+
+    /* Obtains the presence condition of a tuple enumerated by an equal range on the given columns */
+    template <unsigned... Columns>
+    const PresenceCondition* getEqualRangePC(const tuple_type& tuple) const {
+        return getPC(tuple);
     }
 
 private:
@@ -338,12 +401,19 @@ private:
     using primary_index = typename index_utils::get_first_full_index<arity, Indices...,
             typename index_utils::get_full_index<arity>::type>::type;
 
+    // the type of the primary index
+    using primary_t =
+            typename std::decay<decltype(std::declval<indices_t&>().getIndex(primary_index()))>::type;
+
     // the data stored in this relation (main copy, referenced by indices)
     table_t data;
 
     // all other indices
     indices_t indices;
 
+    // the presence conditions of the tuples, kept by the primary index
+    index_utils::PCColumn<tuple_type, primary_t> pcs;
+
     // the lock utilized to synchronize inserts
     Lock insert_lock;
 
@@ -359,6 +429,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::getPC;
     using base::insert;
 
     // --- most general implementation ---
@@ -414,10 +485,31 @@ public:
 
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
-        operation_context context;
-        for (const tuple_type& cur : other) {
-            insert(cur, context);
-        }
+        this->insertAllLifted(other);
+    }
+
+    const PresenceCondition* getPC(const tuple_type& tuple, operation_context& context) const {
+        return pcs.get(indices.getIndex(primary_index()), tuple, context.getForIndex(primary_index()));
+    }
+
+    void widenPC(const tuple_type& tuple, const PresenceCondition* pc, operation_context& context) {
+        pcs.widen(indices.getIndex(primary_index()), tuple, pc, context.getForIndex(primary_index()));
+    }
+
+    const PresenceCondition* getScanPC(const tuple_type& tuple) const {
+        // the master copies are only updated if the primary index references them
+        return (index_utils::is_indirect_index<primary_t>::value) ? index_utils::readPC(tuple.pc)
+                                                                   : getPC(tuple);
+    }
+
+    template <unsigned... Columns>
+    const PresenceCondition* getEqualRangePC(const tuple_type& tuple) const {
+        // ranges of the primary index or of indices referencing updated master copies are up to date
+        using range_iter = typename indices_t::template iter_type<index<Columns...>>::type;
+        return (index_utils::is_indirect_index<primary_t>::value ||
+                       std::is_same<range_iter, typename primary_t::iterator>::value)
+                       ? index_utils::readPC(tuple.pc)
+                       : getPC(tuple);
     }
 
     template <typename Index>
@@ -517,9 +609,16 @@ private:
     // define the primary index for existence checks
     using primary_index = typename index_utils::extend_to_full_index<arity, Primary>::type;
 
+    // the type of the primary index
+    using primary_t =
+            typename std::decay<decltype(std::declval<indices_t&>().getIndex(primary_index()))>::type;
+
     // all other indices
     indices_t indices;
 
+    // the presence conditions of the tuples, kept by the primary index
+    index_utils::PCColumn<tuple_type, primary_t> pcs;
+
 public:
     /* iterator type */
     using iterator = decltype(indices.getIndex(primary_index()).begin());
@@ -530,6 +629,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::getPC;
     using base::insert;
 
     // --- most general implementation ---
@@ -551,6 +651,8 @@ public:
     }
 
     bool insert(const tuple_type& tuple, operation_context& context) {
+        // record the presence condition for indices not storing it in place
+        pcs.insert(tuple);
         // insert in primary index first ...
         if (indices.getIndex(primary_index()).insert(tuple, context.getForIndex(primary_index()))) {
             // and if new, to all other indices
@@ -563,16 +665,40 @@ public:
     }
 
     void insertAll(const DirectIndexedRelation& other) {
+        // merging indices would drop the presence conditions of duplicates
+        if (!empty()) {
+            this->insertAllLifted(other);
+            return;
+        }
         // merge indices using index-specific implementation
         indices.insertAll(other.indices);
+        pcs.insertAll(other.pcs);
     }
 
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
-        operation_context context;
-        for (const tuple_type& cur : other) {
-            insert(cur, context);
-        }
+        this->insertAllLifted(other);
+    }
+
+    const PresenceCondition* getPC(const tuple_type& tuple, operation_context& context) const {
+        return pcs.get(indices.getIndex(primary_index()), tuple, context.getForIndex(primary_index()));
+    }
+
+    void widenPC(const tuple_type& tuple, const PresenceCondition* pc, operation_context& context) {
+        pcs.widen(indices.getIndex(primary_index()), tuple, pc, context.getForIndex(primary_index()));
+    }
+
+    const PresenceCondition* getScanPC(const tuple_type& tuple) const {
+        return (decltype(pcs)::in_place) ? index_utils::readPC(tuple.pc) : getPC(tuple);
+    }
+
+    template <unsigned... Columns>
+    const PresenceCondition* getEqualRangePC(const tuple_type& tuple) const {
+        // only the primary index keeps the column up to date, the others store stale copies
+        using range_iter = typename indices_t::template iter_type<index<Columns...>>::type;
+        return (decltype(pcs)::in_place && std::is_same<range_iter, iterator>::value)
+                       ? index_utils::readPC(tuple.pc)
+                       : getPC(tuple);
     }
 
     template <typename Index>
@@ -613,6 +739,7 @@ public:
     }
 
     void purge() {
+        pcs.clear();
         indices.clear();
     }
 
@@ -681,6 +808,9 @@ class AutoRelation<0> : public RelationBase<0, AutoRelation<0>> {
     /* The flag indicating whether the empty tuple () is present or not. */
     bool present = false;
 
+    /* The presence condition column of the empty tuple; 0 is the id of false. */
+    RamDomain pc = 0;
+
 public:
     /* The type of tuple stored in this relation. */
     using tuple_type = typename base::tuple_type;
@@ -756,19 +886,20 @@ public:
         return present;
     }
 
-    bool insert(const RamDomain* ramDomain) {
-        return insert();
-    }
-
     bool insert(const RamDomain* ramDomain, const PresenceCondition* pc) {
-        return insert();
+        return base::insert(ramDomain, pc);
     }
 
     bool insert(const RamRecord* rec) {
-        return insert();
+        return base::insert(rec);
     }
-    
-    bool insert(const tuple_type& = tuple_type(), const operation_context& = operation_context()) {
+
+    bool insert(const tuple_type& tuple = tuple_type()) {
+        return base::insert(tuple);
+    }
+
+    bool insert(const tuple_type& tuple, const operation_context&) {
+        index_utils::widenPC(pc, PresenceCondition::fromId(tuple.pc));
         bool res = !present;
         present = true;
         return res;
@@ -776,7 +907,17 @@ public:
 
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, 0, Idxs...>& other) {
-        present = present || other.present;
+        this->insertAllLifted(other);
+    }
+
+    using base::getPC;
+
+    const PresenceCondition* getPC(const tuple_type&, const operation_context&) const {
+        return (present) ? index_utils::readPC(pc) : PresenceCondition::makeFalse();
+    }
+
+    void widenPC(const tuple_type&, const PresenceCondition* cond, const operation_context&) {
+        index_utils::widenPC(pc, cond);
     }
 
     template <typename Index>
@@ -817,6 +958,7 @@ public:
 
     void purge() {
         present = false;
+        pc = 0;
     }
 
     std::vector<range<iterator>> partition() const {
@@ -857,12 +999,16 @@ private:
     /* The indexed data stored in this relation. */
     table_t data;
 
+    /* The presence conditions of the stored tuples. */
+    index_utils::PCColumn<tuple_type, table_t> pcs;
+
 public:
     /* The iterator type utilized by this relation. */
     using iterator = typename table_t::iterator;
 
     // import generic signatures from the base class
     using base::contains;
+    using base::getPC;
     using base::insert;
 
     using operation_context = typename table_t::operation_hints;
@@ -890,11 +1036,19 @@ public:
     }
 
     bool insert(const tuple_type& tuple, operation_context& ctxt) {
+        // record the presence condition for indices not storing it in place
+        pcs.insert(tuple);
         return data.insert(tuple, ctxt);
     }
 
     void insertAll(const SingleIndexRelation& other) {
+        // merging the data would drop the presence conditions of duplicates
+        if (!empty()) {
+            this->insertAllLifted(other);
+            return;
+        }
         data.insertAll(other.data);
+        pcs.insertAll(other.pcs);
     }
 
     /** Extend this relation with the knowledge created by inserting into other. */
@@ -905,10 +1059,25 @@ public:
 
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
-        operation_context ctxt;
-        for (const tuple_type& cur : other) {
-            insert(cur, ctxt);
-        }
+        this->insertAllLifted(other);
+    }
+
+    const PresenceCondition* getPC(const tuple_type& tuple, operation_context& ctxt) const {
+        return pcs.get(data, tuple, ctxt);
+    }
+
+    void widenPC(const tuple_type& tuple, const PresenceCondition* pc, operation_context& ctxt) {
+        pcs.widen(data, tuple, pc, ctxt);
+    }
+
+    const PresenceCondition* getScanPC(const tuple_type& tuple) const {
+        return (decltype(pcs)::in_place) ? index_utils::readPC(tuple.pc) : getPC(tuple);
+    }
+
+    template <unsigned... Columns>
+    const PresenceCondition* getEqualRangePC(const tuple_type& tuple) const {
+        // all ranges enumerate the tuples of the single index
+        return getScanPC(tuple);
     }
 
     template <typename I>
@@ -968,6 +1137,7 @@ public:
 
     void purge() {
         data.clear();
+        pcs.clear();
     }
 
     std::vector<range<iterator>> partition() const {
@@ -1157,6 +1327,10 @@ public:
         return data.find(element) != data.end();
     }
 
+    iterator find(const tuple_type& element) const {
+        return data.find(element);
+    }
+
     void insert(const tuple_type& element) {
         data.insert(element);
         nested.insert(element);
@@ -1184,8 +1358,12 @@ template <typename config, unsigned arity, typename... Indices>
 class GenericRelation : public RelationBase<arity, GenericRelation<config, arity, Indices...>> {
     using base = RelationBase<arity, GenericRelation<config, arity, Indices...>>;
 
+public:
+    /* The type of tuple stored in this relation. */
     using tuple_type = typename base::tuple_type;
 
+private:
+
     // the indices group type
     using group_type = typename std::conditional<index_utils::contains_full_index<arity, Indices...>::value,
             GenericRelationGroup<config, arity, Indices...>,
@@ -1210,6 +1388,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::getPC;
     using base::insert;
 
     // the empty operation context (no data needed)
@@ -1242,9 +1421,17 @@ public:
 
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
-        for (const tuple_type& cur : other) {
-            insert(cur);
-        }
+        this->insertAllLifted(other);
+    }
+
+    const PresenceCondition* getPC(const tuple_type& tuple, operation_context&) const {
+        auto pos = getMainIndex().find(tuple);
+        return (pos != end()) ? index_utils::readPC((*pos).pc) : PresenceCondition::makeFalse();
+    }
+
+    void widenPC(const tuple_type& tuple, const PresenceCondition* pc, operation_context&) {
+        std::lock_guard<std::mutex> guard(lock);
+        index_utils::widenPC((*getMainIndex().find(tuple)).pc, pc);
     }
 
     template <typename I>
@@ -1411,5 +1598,27 @@ struct std_unordered_config {
 
 }  // end of namespace detail
 
+/**
+ * An adapter inserting the tuples delivered by the readers into a relation. Readers deliver
+ * lifted tuples, i.e. the values of a tuple followed by the id of its presence condition.
+ */
+template <typename Rel>
+class RelationLoader {
+    Rel& relation;
+
+public:
+    RelationLoader(Rel& relation) : relation(relation) {}
+
+    void insert(const RamDomain* tuple) {
+        relation.insert(tuple, PresenceCondition::fromId(tuple[relation.getArity()]));
+    }
+};
+
+/* Creates a loader inserting the tuples delivered by the readers into the given relation. */
+template <typename Rel>
+RelationLoader<Rel> makeRelationLoader(Rel& relation) {
+    return RelationLoader<Rel>(relation);
+}
+
 }  // end of namespace ram
 }  // end of namespace souffle
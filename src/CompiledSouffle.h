@@ -25,10 +25,13 @@
 #include "souffle/CompiledTuple.h"
 #include "souffle/IODirectives.h"
 #include "souffle/IOSystem.h"
+#include "souffle/LiftedAggregate.h"
 #include "souffle/Logger.h"
 #include "souffle/ParallelUtils.h"
 #include "souffle/ProfileEvent.h"
 #include "souffle/RamTypes.h"
+#include "souffle/RegexCache.h"
+#include "souffle/RelationStats.h"
 #include "souffle/SignalHandler.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolMask.h"
@@ -38,6 +41,7 @@
 #include "souffle/WriteStream.h"
 //#include "souffle/LiftedRelation.h"
 #ifdef USE_MPI
+#include "souffle/LiftedMpi.h"
 #include "souffle/Mpi.h"
 #endif
 
@@ -74,7 +78,13 @@ DdManager*   PresenceCondition::bddMgr = nullptr;
 DdNode* PresenceCondition::FF;
 DdNode* PresenceCondition::TT;
 PresenceCondition* PresenceCondition::fmPC;
-std::map<DdNode*, PresenceCondition*> PresenceCondition::pcMap;
+PresenceCondition* PresenceCondition::ttPC;
+PresenceCondition* PresenceCondition::ffPC;
+PresenceCondition::PCShard PresenceCondition::pcTable[PresenceCondition::PC_SHARDS];
+PresenceCondition::PCIdTable PresenceCondition::pcIds;
+Lock PresenceCondition::bddLock;
+std::vector<int> PresenceCondition::featureVars;
+std::vector<RamDomain> PresenceCondition::varFeatures;
 
 size_t WriteStream::recordCount;
 size_t WriteStream::pcCount;
@@ -111,6 +121,7 @@ private:
             for (size_t i = 0; i < Arity; i++) {
                 t[i] = (*it)[i];
             }
+            t.setPC(static_cast<const RelationWrapper*>(relation)->relation.getPC(*it));
             return t;
         }
         iterator_base* clone() const override {
@@ -140,7 +151,7 @@ public:
         for (size_t i = 0; i < Arity; i++) {
             t[i] = arg[i];
         }
-        relation.insert(t);
+        relation.insertLifted(t, arg.getPC());
     }
     bool contains(const tuple& arg) const override {
         TupleType t;
@@ -150,6 +161,14 @@ public:
         }
         return relation.contains(t);
     }
+    const PresenceCondition* getPC(const tuple& arg) const override {
+        TupleType t;
+        assert(arg.size() == Arity && "wrong tuple arity");
+        for (size_t i = 0; i < Arity; i++) {
+            t[i] = arg[i];
+        }
+        return relation.getPC(t);
+    }
     bool isInput() const override {
         return IsInputRel;
     }
@@ -41,6 +41,10 @@ struct Tuple {
     // the stored data
     Domain data[arity];
 
+    // the trailing column holding the id of the presence condition of a stored tuple; it is not
+    // part of the value of the tuple, hence ignored by comparisons, and updated in place
+    mutable Domain pc;
+
     // constructores, destructors and assignment are default
 
     souffle::RamRecord toRecord() const {
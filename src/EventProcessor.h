@@ -472,6 +472,24 @@ public:
     }
 } programResourceUtilisationProcessor;
 
+/**
+ * Relation Statistics Profile Event Processor
+ */
+const class RelationStatisticsProcessor : public EventProcessor {
+public:
+    RelationStatisticsProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@s-relation", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        size_t number = va_arg(args, size_t);
+        std::vector<std::string> path = {"program", "relation", relation, "statistics"};
+        path.insert(path.end(), signature.begin() + 2, signature.end());
+        db.addSizeEntry(path, number);
+    }
+} relationStatisticsProcessor;
+
 /**
  * Frequency Atom Processor
  */
@@ -16,10 +16,12 @@
 
 #include "IODirectives.h"
 #include "ReadStream.h"
+#include "ReadStreamBinary.h"
 #include "ReadStreamCSV.h"
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 #include "WriteStream.h"
+#include "WriteStreamBinary.h"
 #include "WriteStreamCSV.h"
 
 #ifdef USE_SQLITE
@@ -78,9 +80,11 @@ private:
         registerReadStreamFactory(std::make_shared<ReadCinCSVFactory>());
         registerWriteStreamFactory(std::make_shared<WriteFileCSVFactory>());
         registerWriteStreamFactory(std::make_shared<WriteCoutCSVFactory>());
+        registerReadStreamFactory(std::make_shared<ReadFileBinaryFactory>());
+        registerWriteStreamFactory(std::make_shared<WriteFileBinaryFactory>());
 #ifdef USE_SQLITE
         //registerReadStreamFactory(std::make_shared<ReadSQLiteFactory>());
-        //registerWriteStreamFactory(std::make_shared<WriteSQLiteFactory>());
+        registerWriteStreamFactory(std::make_shared<WriteSQLiteFactory>());
 #endif
     };
     std::map<std::string, std::shared_ptr<WriteStreamFactory>> outputFactories;
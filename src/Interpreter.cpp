@@ -15,6 +15,7 @@
  ***********************************************************************/
 
 #include "Interpreter.h"
+#include "BddRelation.h"
 #include "BinaryConstraintOps.h"
 #include "BinaryFunctorOps.h"
 #include "Global.h"
@@ -22,6 +23,7 @@
 #include "IOSystem.h"
 #include "InterpreterIndex.h"
 #include "InterpreterRecords.h"
+#include "LiftedAggregate.h"
 #include "LogStatement.h"
 #include "Logger.h"
 #include "ParallelUtils.h"
@@ -31,20 +33,22 @@
 #include "RamValue.h"
 #include "RamVisitor.h"
 #include "ReadStream.h"
+#include "RelationStats.h"
 #include "SignalHandler.h"
 #include "SymbolTable.h"
 #include "TernaryFunctorOps.h"
 #include "UnaryFunctorOps.h"
 #include "WriteStream.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
-#include <regex>
 #include <stdexcept>
 #include <typeinfo>
 #include <utility>
@@ -226,13 +230,12 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
         // -- connectors operators --
 
         const PresenceCondition* visitAnd(const RamAnd& a) override {
-            //const PresenceCondition* pc = ctxt.getPC();
-            const PresenceCondition* ret = PresenceCondition::makeFalse();
-            if (visit(a.getLHS()) && visit(a.getRHS())) {
-                ret = ctxt.getPC();
+            // a conjunction holds where both of its operands hold
+            const PresenceCondition* lhs = visit(a.getLHS());
+            if (!lhs->isSAT()) {
+                return lhs;
             }
-            //ctxt.resetPC(pc);
-            return ret;
+            return lhs->conjoin(visit(a.getRHS()));
         }
 
         // -- relation operations --
@@ -255,7 +258,7 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
                 for (size_t i = 0; i < arity; i++) {
                     tuple[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
                 }
-                tuple[arity] = (RamDomain) ctxt.getPC();
+                tuple[arity] = ctxt.getPC()->getId();
                 const RamDomain* out = nullptr;
                 const PresenceCondition* ex = rel.exists(tuple, out);
                 return ex->negate();
@@ -268,12 +271,18 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
                 low[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
                 high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
             }
-            low[arity] = high[arity] = (RamDomain) ctxt.getPC();
+            low[arity] = high[arity] = ctxt.getPC()->getId();
 
             // obtain index
             auto idx = rel.getIndex(ne.getKey());
             auto range = idx->lowerUpperBound(low, high);
-            return (range.first == range.second) ? PresenceCondition::makeTrue() : ctxt.getPC();  // if there are none => done
+
+            // the negation holds where none of the matching tuples is present
+            const PresenceCondition* present = PresenceCondition::makeFalse();
+            for (auto it = range.first; it != range.second && !present->isTrue(); ++it) {
+                present = present->disjoin(rel.getPC(*it));
+            }
+            return present->negate();
         }
 
         // -- comparison operators --
@@ -296,13 +305,11 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
                 case BinaryConstraintOp::GE:
                     return lhs >= rhs ? tt : ff;
                 case BinaryConstraintOp::MATCH: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
+                    const std::string& pattern = interpreter.getSymbolTable().resolve(lhs);
+                    const std::string& text = interpreter.getSymbolTable().resolve(rhs);
                     bool result = false;
                     try {
-                        result = std::regex_match(text, std::regex(pattern));
+                        result = interpreter.getRegexCache().match(lhs, pattern, text);
                     } catch (...) {
                         std::cerr << "warning: wrong pattern provided for match(\"" << pattern << "\",\""
                                   << text << "\").\n";
@@ -310,13 +317,11 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
                     return result ? tt : ff;
                 }
                 case BinaryConstraintOp::NOT_MATCH: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
+                    const std::string& pattern = interpreter.getSymbolTable().resolve(lhs);
+                    const std::string& text = interpreter.getSymbolTable().resolve(rhs);
                     bool result = false;
                     try {
-                        result = !std::regex_match(text, std::regex(pattern));
+                        result = !interpreter.getRegexCache().match(lhs, pattern, text);
                     } catch (...) {
                         std::cerr << "warning: wrong pattern provided for !match(\"" << pattern << "\",\""
                                   << text << "\").\n";
@@ -324,17 +329,13 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
                     return result ? tt : ff;
                 }
                 case BinaryConstraintOp::CONTAINS: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
+                    const std::string& pattern = interpreter.getSymbolTable().resolve(lhs);
+                    const std::string& text = interpreter.getSymbolTable().resolve(rhs);
                     return text.find(pattern) != std::string::npos ? tt : ff;
                 }
                 case BinaryConstraintOp::NOT_CONTAINS: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
+                    const std::string& pattern = interpreter.getSymbolTable().resolve(lhs);
+                    const std::string& text = interpreter.getSymbolTable().resolve(rhs);
                     return text.find(pattern) == std::string::npos ? tt : ff;
                 }
                 default:
@@ -353,84 +354,112 @@ const PresenceCondition* Interpreter::evalCond(const RamCondition& cond, const I
     return ConditionEvaluator(*this, ctxt)(cond);
 }
 
-class LiftedAggregate {
-public:
-    std::vector<std::pair<RamDomain, const PresenceCondition*> > vals;
+namespace {
 
-public:
-    LiftedAggregate(RamDomain init) {
-        vals.push_back(std::make_pair(init,PresenceCondition::makeTrue()));
-    }
+/** Number of parts a range is split into for parallelForEach, like the partitions of compiled relations */
+const size_t PARALLEL_PARTS = 400;
 
-    void accumulate(RamAggregate::Function f, RamDomain v, const PresenceCondition* pc) {
-        size_t curSize = vals.size();
-        for(size_t i=0; i < curSize; i++) {
-            auto& it = vals[i];
-            const PresenceCondition* cjn = it.second->conjoin(pc);
-            if (!cjn->isSAT()) {
-                continue;
+/**
+ * Applies a body to each element of a range which has been split into parts up front. The
+ * parts are claimed by the threads one by one, and each thread uses its own body obtained from
+ * the given factory. Exceptions must not escape the parallel region, so the first one thrown is
+ * rethrown once all threads have finished.
+ */
+template <typename Iter, typename BodyFactory>
+void parallelForEach(std::vector<range<Iter>> parts, const BodyFactory& makeBody) {
+    std::atomic<size_t> nextPart(0);
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    Lock errorLock;
+#pragma omp parallel
+    {
+        try {
+            auto body = makeBody();
+            for (size_t part = nextPart++; part < parts.size() && !failed; part = nextPart++) {
+                for (const RamDomain* cur : parts[part]) {
+                    body(cur);
+                }
             }
-            
-            RamDomain newVal = it.first;
-            switch (f) {
-            case RamAggregate::MAX:
-                newVal = std::max(newVal, v);
-                break;
-            case RamAggregate::MIN:
-                newVal = std::min(newVal, v);
-                break;
-            case RamAggregate::COUNT:
-                newVal++;
-                break;
-            case RamAggregate::SUM:
-                newVal += v;
-                break;
-            }
-
-            const PresenceCondition* rmdr = it.second->conjoin(pc->negate());
-            if (rmdr->isSAT()) {
-                // rmdr is satisfiable implies it.second and pc are not identical
-                it.second = rmdr;
-                vals.push_back(std::make_pair(newVal, cjn));
-            } else {
-                it.first = newVal;
+        } catch (...) {
+            auto lease = errorLock.acquire();
+            (void)lease;
+            if (!failed) {
+                error = std::current_exception();
+                failed = true;
             }
         }
     }
-};
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-std::ostream& operator<<(std::ostream& out, const LiftedAggregate& a) {
-    out << "{";
-    for (const auto& v: a.vals) {
-        out << "(" << v.first << ", " << v.second->getText() << "), ";
+/**
+ * Disjoins the presence conditions of the tuples of a range of a relation, the condition under
+ * which the range is not empty; stops once the disjunction holds in all configurations
+ */
+template <typename Iter>
+const PresenceCondition* getRangePC(const InterpreterRelation& rel, Iter begin, Iter end) {
+    const PresenceCondition* tt = PresenceCondition::makeTrue();
+    const PresenceCondition* res = PresenceCondition::makeFalse();
+    for (Iter cur = begin; cur != end && res != tt && !res->isTrue(); ++cur) {
+        res = res->disjoin(rel.getPC(*cur));
     }
-    out << "}";
-    return out;
+    return res;
 }
 
+}  // namespace
+
 /** Evaluate RAM operation */
 void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args) {
     class OperationEvaluator : public RamVisitor<void> {
         Interpreter& interpreter;
         InterpreterContext& ctxt;
 
+        /** whether the outermost scan may be split among threads */
+        bool parallel;
+
+        /** create the body binding the tuples of a parallel scan, with its own context for one thread */
+        std::function<void(const RamDomain*)> makeScanBody(
+                const RamScan& scan, const InterpreterRelation& rel) {
+            auto local = std::make_shared<InterpreterContext>(ctxt);
+            auto evaluator = std::make_shared<OperationEvaluator>(interpreter, *local);
+            const PresenceCondition* curPC = ctxt.getPC();
+            return [&scan, &rel, local, evaluator, curPC](const RamDomain* tuple) {
+                (*local)[scan.getLevel()] = tuple;
+                local->conjoinPCWith(rel.getPC(tuple));
+                if (local->getPC()->isSAT()) {
+                    evaluator->visitSearch(scan);
+                }
+                local->resetPC(curPC);
+            };
+        }
+
+        /** process the nested operation of an existence check under the condition of the matching tuples */
+        void visitExistenceCheck(const RamScan& scan, const PresenceCondition* matchPC) {
+            const PresenceCondition* curPC = ctxt.getPC();
+            ctxt.conjoinPCWith(matchPC);
+            if (ctxt.getPC()->isSAT()) {
+                visitSearch(scan);
+            }
+            ctxt.resetPC(curPC);
+        }
+
     public:
-        OperationEvaluator(Interpreter& interp, InterpreterContext& ctxt) : interpreter(interp), ctxt(ctxt) {}
+        OperationEvaluator(Interpreter& interp, InterpreterContext& ctxt, bool parallel = false)
+                : interpreter(interp), ctxt(ctxt), parallel(parallel) {}
 
         // -- Operations -----------------------------
 
         void visitSearch(const RamSearch& search) override {
             auto curPC = ctxt.getPC();
-            if (search.pc) {
-                ctxt.conjoinPCWith(search.pc);
-            }
             // check condition
             auto condition = search.getCondition();
             const PresenceCondition* condPC = condition ? interpreter.evalCond(*condition, ctxt) : nullptr;
-            if (condPC && condPC != PresenceCondition::makeFalse()) {
+            if (condPC) {
                 ctxt.conjoinPCWith(condPC);
             }
-            if (!condition || condPC != PresenceCondition::makeFalse()) {    
+            if (ctxt.getPC()->isSAT()) {
                 // process nested
                 visit(*search.getNestedOperation());
             }
@@ -450,17 +479,26 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             if (scan.getRangeQueryColumns() == 0) {
                 // if scan is not binding anything => check for emptiness
                 if (scan.isPureExistenceCheck() && !rel.empty()) {
-                    visitSearch(scan);
+                    visitExistenceCheck(scan, getRangePC(rel, rel.begin(), rel.end()));
+                    return;
+                }
+
+                // if this is the outermost scan => split it among threads
+                if (parallel && scan.getLevel() == 0) {
+                    parallelForEach(rel.partition(PARALLEL_PARTS), [&]() { return makeScanBody(scan, rel); });
                     return;
                 }
 
                 const PresenceCondition* curPC = ctxt.getPC();
                 // if scan is unrestricted => use simple iterator
                 for (const RamDomain* cur : rel) {
-                    const PresenceCondition* pc = rel.getPC(cur);
                     ctxt[scan.getLevel()] = cur;
-                    ((RamScan&)scan).pc = pc;
-                    visitSearch(scan);
+                    // the presence condition of the bound tuple lives in the context, not the RAM node,
+                    // so that concurrent evaluations of this scan do not interfere
+                    ctxt.conjoinPCWith(rel.getPC(cur));
+                    if (ctxt.getPC()->isSAT()) {
+                        visitSearch(scan);
+                    }
                     ctxt.resetPC(curPC);
                 }
                 return;
@@ -479,18 +517,27 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                     hig[i] = MAX_RAM_DOMAIN;
                 }
             }
-            low[arity] = hig[arity] = (RamDomain) ctxt.getPC();
+            low[arity] = hig[arity] = ctxt.getPC()->getId();
 
             // obtain index
             auto idx = rel.getIndex(scan.getRangeQueryColumns(), nullptr);
 
+            // skip the range if none of its tuples is compatible with the current context
+            if (pattern[idx->order()[0]] != nullptr && !idx->mayMatch(low, ctxt.getPC())) {
+                if (scan.isPureExistenceCheck() && Global::config().has("profile") &&
+                        !scan.getProfileText().empty()) {
+                    interpreter.frequencies[scan.getProfileText()][interpreter.getIterationNumber()]++;
+                }
+                return;
+            }
+
             // get iterator range
             auto range = idx->lowerUpperBound(low, hig);
 
             // if this scan is not binding anything ...
             if (scan.isPureExistenceCheck()) {
                 if (range.first != range.second) {
-                    visitSearch(scan);
+                    visitExistenceCheck(scan, getRangePC(rel, range.first, range.second));
                 }
                 if (Global::config().has("profile") && !scan.getProfileText().empty()) {
                     interpreter.frequencies[scan.getProfileText()][interpreter.getIterationNumber()]++;
@@ -498,14 +545,21 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                 return;
             }
 
+            if (parallel && scan.getLevel() == 0) {
+                parallelForEach(make_range(range.first, range.second).partition(PARALLEL_PARTS),
+                        [&]() { return makeScanBody(scan, rel); });
+                return;
+            }
+
             const PresenceCondition* curPC = ctxt.getPC();
             // conduct range query
             for (auto ip = range.first; ip != range.second; ++ip) {
                 const RamDomain* data = *(ip);
-                const PresenceCondition* pc = rel.getPC(data);
-                ((RamScan&)scan).pc = pc;
                 ctxt[scan.getLevel()] = data;
-                visitSearch(scan);
+                ctxt.conjoinPCWith(rel.getPC(data));
+                if (ctxt.getPC()->isSAT()) {
+                    visitSearch(scan);
+                }
                 ctxt.resetPC(curPC);
             }
         }
@@ -538,18 +592,23 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             auto arity = rel.getArity();
             // initialize result
             RamDomain res = 0;
+            LiftedAggregate::Function fun = LiftedAggregate::COUNT;
             switch (aggregate.getFunction()) {
                 case RamAggregate::MIN:
                     res = MAX_RAM_DOMAIN;
+                    fun = LiftedAggregate::MIN;
                     break;
                 case RamAggregate::MAX:
                     res = MIN_RAM_DOMAIN;
+                    fun = LiftedAggregate::MAX;
                     break;
                 case RamAggregate::COUNT:
                     res = 0;
+                    fun = LiftedAggregate::COUNT;
                     break;
                 case RamAggregate::SUM:
                     res = 0;
+                    fun = LiftedAggregate::SUM;
                     break;
             }
             LiftedAggregate aggr(res);
@@ -568,7 +627,7 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                     hig[i] = MAX_RAM_DOMAIN;
                 }
             }
-            low[arity] = hig[arity] = (RamDomain) ctxt.getPC();
+            low[arity] = hig[arity] = ctxt.getPC()->getId();
 
             // obtain index
             auto idx = rel.getIndex(aggregate.getRangeQueryColumns());
@@ -588,11 +647,11 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                 // link tuple
                 const RamDomain* data = *(ip);
                 ctxt[aggregate.getLevel()] = data;
-                const PresenceCondition* pc = (const PresenceCondition*) data[arity];
+                const PresenceCondition* pc = PresenceCondition::fromId(data[arity]);
 
                 // count is easy
                 if (aggregate.getFunction() == RamAggregate::COUNT) {
-                    aggr.accumulate(RamAggregate::COUNT, 1, pc); 
+                    aggr.accumulate(LiftedAggregate::COUNT, 1, pc);
                     continue;
                 }
 
@@ -601,7 +660,7 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                 // eval target expression
                 RamDomain cur = interpreter.evalVal(*aggregate.getTargetExpression(), ctxt);
 
-                aggr.accumulate(aggregate.getFunction(), cur, pc);
+                aggr.accumulate(fun, cur, pc);
             }
 
             const PresenceCondition* curPC = ctxt.getPC();
@@ -616,11 +675,11 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                 // check whether result is used in a condition
                 auto condition = aggregate.getCondition();
                 if (condition) {
-                    auto condPC = interpreter.evalCond(*condition, ctxt);
-                    if (condPC == PresenceCondition::makeFalse()) {
-                        return;  // condition not valid => skip nested
+                    ctxt.conjoinPCWith(interpreter.evalCond(*condition, ctxt));
+                    if (!ctxt.getPC()->isSAT()) {
+                        ctxt.resetPC(curPC);
+                        continue;  // condition not valid => skip nested for this partition
                     }
-                    ctxt.conjoinPCWith(condPC);
                 }
 
                 // run nested part - using base class visitor
@@ -635,11 +694,11 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             RamCondition* condition = project.getCondition();
             auto curPC = ctxt.getPC();
             if (condition) { 
-                auto condPC = interpreter.evalCond(*condition, ctxt); 
-                if (condPC == PresenceCondition::makeFalse()) {
+                ctxt.conjoinPCWith(interpreter.evalCond(*condition, ctxt));
+                if (!ctxt.getPC()->isSAT()) {
+                    ctxt.resetPC(curPC);
                     return;  // condition not valid => skip nested
                 }
-                ctxt.conjoinPCWith(condPC);
             }
 
             // create a tuple of the proper arity (also supports arity 0)
@@ -650,17 +709,19 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
                 assert(values[i]);
                 tuple[i] = interpreter.evalVal(*values[i], ctxt);
             }
-            tuple[arity] = (RamDomain) ctxt.getPC();
+            tuple[arity] = ctxt.getPC()->getId();
 
-            // check filter relation
-            const RamDomain* out = nullptr;
-            const PresenceCondition* ff = PresenceCondition::makeFalse();
-            if (project.hasFilter() && interpreter.getRelation(project.getFilter()).exists(tuple, out) != ff) {
-                assert(out);
-                const PresenceCondition* pcOther = (const PresenceCondition*)out[arity];
-                if (ctxt.getPC()->conjSat(pcOther)) {
+            // check filter relation; only the part of the presence condition under which the
+            // tuple is not known yet is inserted, such that a growing condition forms a delta
+            if (project.hasFilter()) {
+                const RamDomain* out = nullptr;
+                const PresenceCondition* known = interpreter.getRelation(project.getFilter()).exists(tuple, out);
+                ctxt.conjoinPCWith(known->negate());
+                if (!ctxt.getPC()->isSAT()) {
+                    ctxt.resetPC(curPC);
                     return;
                 }
+                tuple[arity] = ctxt.getPC()->getId();
             }
 
             // insert in target relation
@@ -669,6 +730,13 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             ctxt.resetPC(curPC);
         }
 
+        void visitBranch(const RamBranch& branch) override {
+            // nested operations restore the presence condition of the context
+            for (const RamOperation* cur : branch.getBranches()) {
+                visit(*cur);
+            }
+        }
+
         // -- return from subroutine --
         void visitReturn(const RamReturn& ret) override {
             for (auto val : ret.getValues()) {
@@ -687,12 +755,218 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
         }
     };
 
+    // the outermost scan is only split among threads if the operation does not
+    // profile, return values or use records, which are not synchronised
+    bool parallel = false;
+#ifdef _OPENMP
+    parallel = omp_get_max_threads() > 1 && !omp_in_parallel() && !Global::config().has("profile");
+#endif
+    if (parallel) {
+        visitDepthFirst(op, [&](const RamReturn&) { parallel = false; });
+        visitDepthFirst(op, [&](const RamLookup&) { parallel = false; });
+        visitDepthFirst(op, [&](const RamPack&) { parallel = false; });
+    }
+
     // create and run interpreter for operations
     InterpreterContext ctxt(op.getDepth());
     ctxt.setReturnValues(args.getReturnValues());
     ctxt.setReturnErrors(args.getReturnErrors());
     ctxt.setArguments(args.getArguments());
-    OperationEvaluator(*this, ctxt).visit(op);
+    OperationEvaluator(*this, ctxt, parallel).visit(op);
+}
+
+/** Evaluate RAM operation over BDD relations symbolically */
+bool Interpreter::evalSymbolic(const RamOperation& op) {
+    using Column = BddRelation::Column;
+    using Term = BddRelation::Term;
+
+    // collect the chain of scans over BDD relations leading to a projection
+    std::vector<const RamScan*> scans;
+    const RamOperation* cur = &op;
+    while (const auto* scan = dynamic_cast<const RamScan*>(cur)) {
+        if (scan->getLevel() != scans.size() || !getRelation(scan->getRelation()).getBdd()) {
+            return false;
+        }
+        scans.push_back(scan);
+        cur = scan->getNestedOperation();
+    }
+    const auto* project = dynamic_cast<const RamProject*>(cur);
+    if (scans.empty() || !project || !getRelation(project->getRelation()).getBdd() ||
+            (project->hasFilter() && !getRelation(project->getFilter()).getBdd())) {
+        return false;
+    }
+
+    // the columns of the relation scanned on each level are bound to consecutive domains
+    std::vector<size_t> offsets;
+    size_t domainCount = 0;
+    for (const RamScan* scan : scans) {
+        offsets.push_back(domainCount);
+        domainCount += scan->getRelation().getArity();
+    }
+
+    // map a value to a column, if it is an element, a constant or unbound
+    auto toColumn = [&](const RamValue* value, Column& column) {
+        if (!value) {
+            column = {Column::UNBOUND, 0};
+            return true;
+        }
+        if (const auto* access = dynamic_cast<const RamElementAccess*>(value)) {
+            if (access->getLevel() >= scans.size()) {
+                return false;
+            }
+            column = {Column::DOMAIN, RamDomain(offsets[access->getLevel()] + access->getElement())};
+            return true;
+        }
+        if (const auto* number = dynamic_cast<const RamNumber*>(value)) {
+            column = {Column::CONSTANT, number->getConstant()};
+            return true;
+        }
+        return false;
+    };
+
+    std::vector<Column> columns(project->getRelation().getArity());
+    auto values = project->getValues();
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (!values[i] || !toColumn(values[i], columns[i])) {
+            return false;
+        }
+    }
+
+    // the last level on which each domain is referenced; later on, it is quantified
+    std::vector<size_t> lastUse(domainCount);
+    for (size_t level = 0; level < scans.size(); level++) {
+        for (size_t i = 0; i < scans[level]->getRelation().getArity(); i++) {
+            lastUse[offsets[level] + i] = level;
+        }
+    }
+    auto markUses = [&](const RamNode& node, size_t level) {
+        visitDepthFirst(node, [&](const RamElementAccess& access) {
+            if (access.getLevel() < scans.size()) {
+                size_t domain = offsets[access.getLevel()] + access.getElement();
+                lastUse[domain] = std::max(lastUse[domain], level);
+            }
+        });
+    };
+    for (size_t level = 0; level < scans.size(); level++) {
+        for (const RamValue* value : scans[level]->getRangePattern()) {
+            if (value) {
+                markUses(*value, level);
+            }
+        }
+        if (scans[level]->getCondition()) {
+            markUses(*scans[level]->getCondition(), level);
+        }
+    }
+    for (const RamValue* value : values) {
+        markUses(*value, scans.size());
+    }
+    if (project->getCondition()) {
+        markUses(*project->getCondition(), scans.size());
+    }
+
+    // conjoin a condition, if it compares elements and constants or negates a BDD relation
+    std::function<bool(const RamCondition&, Term&)> conjoinCondition = [&](const RamCondition& cond,
+                                                                               Term& term) {
+        if (const auto* conj = dynamic_cast<const RamAnd*>(&cond)) {
+            return conjoinCondition(conj->getLHS(), term) && conjoinCondition(conj->getRHS(), term);
+        }
+        if (const auto* empty = dynamic_cast<const RamEmpty*>(&cond)) {
+            if (!getRelation(empty->getRelation()).empty()) {
+                term = Term(PresenceCondition::makeFalse());
+            }
+            return true;
+        }
+        if (const auto* notExists = dynamic_cast<const RamNotExists*>(&cond)) {
+            const InterpreterRelation& rel = getRelation(notExists->getRelation());
+            if (!rel.getBdd()) {
+                return false;
+            }
+            std::vector<Column> pattern(rel.getArity());
+            auto args = notExists->getValues();
+            for (size_t i = 0; i < pattern.size(); i++) {
+                if (!toColumn(args[i], pattern[i])) {
+                    return false;
+                }
+            }
+            term.conjoinNot(rel.getBdd()->select(pattern));
+            return true;
+        }
+        if (const auto* relOp = dynamic_cast<const RamBinaryRelation*>(&cond)) {
+            BinaryConstraintOp cmp = relOp->getOperator();
+            Column lhs;
+            Column rhs;
+            if ((cmp != BinaryConstraintOp::EQ && cmp != BinaryConstraintOp::NE) ||
+                    !toColumn(relOp->getLHS(), lhs) || !toColumn(relOp->getRHS(), rhs)) {
+                return false;
+            }
+            if (lhs.kind == Column::CONSTANT && rhs.kind == Column::CONSTANT) {
+                if ((lhs.value == rhs.value) != (cmp == BinaryConstraintOp::EQ)) {
+                    term = Term(PresenceCondition::makeFalse());
+                }
+                return true;
+            }
+            if (lhs.kind == Column::CONSTANT) {
+                std::swap(lhs, rhs);
+            }
+            Term equal = (rhs.kind == Column::DOMAIN) ? Term::equal(size_t(lhs.value), size_t(rhs.value))
+                                                      : Term::equal(size_t(lhs.value), rhs.value);
+            if (cmp == BinaryConstraintOp::EQ) {
+                term.conjoin(equal);
+            } else {
+                term.conjoinNot(equal);
+            }
+            return true;
+        }
+        return false;
+    };
+
+    // join the scanned relations level by level, quantifying domains after their last use
+    Term term(PresenceCondition::makeTrue());
+    for (size_t level = 0; level < scans.size(); level++) {
+        const RamScan& scan = *scans[level];
+        const BddRelation& rel = *getRelation(scan.getRelation()).getBdd();
+        std::vector<Column> pattern(rel.getArity());
+        for (size_t i = 0; i < pattern.size(); i++) {
+            pattern[i] = {Column::DOMAIN, RamDomain(offsets[level] + i)};
+        }
+        term.conjoin(rel.select(pattern));
+
+        auto range = scan.getRangePattern();
+        for (size_t i = 0; i < range.size(); i++) {
+            if (!range[i]) {
+                continue;
+            }
+            Column value;
+            if (!toColumn(range[i], value)) {
+                return false;
+            }
+            term.conjoin((value.kind == Column::DOMAIN)
+                                 ? Term::equal(offsets[level] + i, size_t(value.value))
+                                 : Term::equal(offsets[level] + i, value.value));
+        }
+        if (scan.getCondition() && !conjoinCondition(*scan.getCondition(), term)) {
+            return false;
+        }
+        if (term.isFalse()) {
+            return true;
+        }
+
+        std::vector<size_t> unused;
+        for (size_t domain = 0; domain < offsets[level] + rel.getArity(); domain++) {
+            if (lastUse[domain] == level) {
+                unused.push_back(domain);
+            }
+        }
+        term.exists(unused);
+    }
+    if (project->getCondition() && !conjoinCondition(*project->getCondition(), term)) {
+        return false;
+    }
+
+    // project the join into the target relation
+    const BddRelation* filter = project->hasFilter() ? getRelation(project->getFilter()).getBdd() : nullptr;
+    getRelation(project->getRelation()).insert(term, columns, filter);
+    return true;
 }
 
 /** Evaluate RAM statement */
@@ -750,7 +1024,7 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
         }
 
         bool visitExit(const RamExit& exit) override {
-            return interpreter.evalCond(exit.getCondition()) == PresenceCondition::makeFalse();
+            return !interpreter.evalCond(exit.getCondition())->isSAT();
         }
 
         bool visitLogTimer(const RamLogTimer& timer) override {
@@ -799,14 +1073,21 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             return true;
         }
 
+        bool visitLogStats(const RamLogStats& log) override {
+            const InterpreterRelation& rel = interpreter.getRelation(log.getRelation());
+            RelationStats::extractFrom(rel).log(log.getMessage());
+            return true;
+        }
+
         bool visitLoad(const RamLoad& load) override {
             for (IODirectives ioDirectives : load.getIODirectives()) {
                 try {
-                    InterpreterRelation& relation = interpreter.getRelation(load.getRelation());
+                    InterpreterRelationLoader loader(interpreter.getRelation(load.getRelation()),
+                            [&](const PresenceCondition* pc) { return interpreter.specialise(pc); });
                     IOSystem::getInstance()
                             .getReader(load.getRelation().getSymbolMask(), interpreter.getSymbolTable(),
                                     interpreter.getFeatSymbolTable(), ioDirectives, Global::config().has("provenance"))
-                            ->readAll(relation);
+                            ->readAll(loader);
                 } catch (std::exception& e) {
                     std::cerr << "Error loading data: " << e.what() << "\n";
                 }
@@ -814,6 +1095,10 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             return true;
         }
         bool visitStore(const RamStore& store) override {
+            if (interpreter.storeHandler) {
+                interpreter.storeHandler(store, interpreter.getRelation(store.getRelation()));
+                return true;
+            }
             for (IODirectives ioDirectives : store.getIODirectives()) {
                 try {
                     IOSystem::getInstance()
@@ -836,15 +1121,21 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             for (size_t i = 0; i < arity; ++i) {
                 tuple[i] = interpreter.evalVal(*values[i]);
             }
-            tuple[arity] = (RamDomain) fact.getPC();
+            tuple[arity] = interpreter.specialise(fact.getPC())->getId();
 
             interpreter.getRelation(fact.getRelation()).insert(tuple);
             return true;
         }
 
         bool visitInsert(const RamInsert& insert) override {
-            // run generic query executor
-            interpreter.evalOp(insert.getOperation());
+            // joins over BDD relations are evaluated on the BDDs, anything else by the generic query executor
+            if (!interpreter.evalSymbolic(insert.getOperation())) {
+                interpreter.evalOp(insert.getOperation());
+                // merge the tuples buffered by BDD relations
+                visitDepthFirst(insert.getOperation(), [&](const RamProject& project) {
+                    interpreter.getRelation(project.getRelation()).flush();
+                });
+            }
             return true;
         }
 
@@ -892,6 +1183,16 @@ void Interpreter::executeMain() {
     }
     const RamStatement& main = *translationUnit.getP().getMain();
 
+#ifdef _OPENMP
+    // set up number of threads
+    if (Global::config().has("jobs")) {
+        int numThreads = std::stoi(Global::config().get("jobs"));
+        if (numThreads > 0) {
+            omp_set_num_threads(numThreads);
+        }
+    }
+#endif
+
     if (!Global::config().has("profile")) {
         evalStmt(main);
     } else {
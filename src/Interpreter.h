@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "Global.h"
 #include "InterpreterContext.h"
 #include "InterpreterRelation.h"
 #include "RamCondition.h"
@@ -23,10 +24,14 @@
 #include "RamStatement.h"
 #include "RamTranslationUnit.h"
 #include "RamTypes.h"
+#include "RegexCache.h"
 
+#include <atomic>
 #include <cassert>
+#include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace souffle {
@@ -57,11 +62,26 @@ private:
     std::map<std::string, std::map<size_t, size_t>> frequencies;
 
     /** counter for $ operator */
-    int counter;
+    std::atomic<int> counter;
 
     /** iteration number (in a fix-point calculation) */
     size_t iteration;
 
+    /** compiled patterns of match constraints */
+    RegexCache regexCache;
+
+    /** the configuration of the evaluated product, if not evaluating lifted */
+    const PresenceCondition::Configuration* configuration = nullptr;
+
+    /** the presence conditions of facts evaluated in the configuration */
+    std::unordered_map<const PresenceCondition*, const PresenceCondition*> specialised;
+
+    /** lock for the evaluated presence conditions */
+    Lock specialisedLock;
+
+    /** handler replacing the output of stored relations */
+    std::function<void(const RamStore&, const InterpreterRelation&)> storeHandler;
+
 protected:
     /** Evaluate value */
     RamDomain evalVal(const RamValue& value, const InterpreterContext& ctxt = InterpreterContext());
@@ -69,6 +89,9 @@ protected:
     /** Evaluate operation */
     void evalOp(const RamOperation& op, const InterpreterContext& args = InterpreterContext());
 
+    /** Evaluate an operation over BDD relations on the BDDs; returns false if not supported */
+    bool evalSymbolic(const RamOperation& op);
+
     /** Evaluate conditions */
     const PresenceCondition* evalCond(const RamCondition& cond, const InterpreterContext& ctxt = InterpreterContext());
 
@@ -84,6 +107,25 @@ protected:
         return translationUnit.getFeatSymbolTable();
     }
 
+    /** Get regex cache */
+    RegexCache& getRegexCache() {
+        return regexCache;
+    }
+
+    /** Evaluate the presence condition of a fact in the configuration of the evaluated product */
+    const PresenceCondition* specialise(const PresenceCondition* pc) {
+        if (!configuration) {
+            return pc;
+        }
+        auto lease = specialisedLock.acquire();
+        (void)lease;
+        auto pos = specialised.find(pc);
+        if (pos != specialised.end()) {
+            return pos->second;
+        }
+        return specialised[pc] = pc->evaluate(*configuration);
+    }
+
     /** Get counter */
     int getCounter() const {
         return counter;
@@ -113,7 +155,8 @@ protected:
     void createRelation(const RamRelation& id) {
         InterpreterRelation* res = nullptr;
         assert(environment.find(id.getName()) == environment.end());
-        res = new InterpreterRelation(id.getArity(), id.isEqRel());
+        res = new InterpreterRelation(id.getArity(), id.isEqRel(),
+                id.isBdd() || Global::config().get("data-structure") == "bdd");
         environment[id.getName()] = res;
     }
 
@@ -163,6 +206,16 @@ public:
         return translationUnit;
     }
 
+    /** Evaluate a single product, i.e., fix all features as given by the configuration */
+    void setConfiguration(const PresenceCondition::Configuration& config) {
+        configuration = &config;
+    }
+
+    /** Hand stored relations to the given handler instead of writing them */
+    void setStoreHandler(std::function<void(const RamStore&, const InterpreterRelation&)> handler) {
+        storeHandler = std::move(handler);
+    }
+
     /** Execute main program */
     void executeMain();
 
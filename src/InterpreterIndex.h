@@ -18,9 +18,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "BTree.h"
+#include "ParallelUtils.h"
+#include "PresenceCondition.h"
 #include "RamTypes.h"
 #include "Util.h"
 
@@ -132,7 +139,16 @@ public:
     }
 };
 
-/* B-Tree indexes as default implementation for indexes */
+/**
+ * B-Tree indexes as default implementation for indexes.
+ *
+ * Besides the tuples, an index summarises the presence conditions of the
+ * tuples sharing a value in its leading column by their disjunction, such
+ * that range queries binding this column can skip all tuples of the value
+ * at once if none of them is compatible with the presence condition of the
+ * query. Only complete orders, whose tuples end in their presence
+ * condition, are summarised.
+ */
 class InterpreterIndex {
 protected:
     /* lexicographical comparison operation on two tuple pointers */
@@ -181,8 +197,44 @@ private:
     const InterpreterIndexOrder theOrder;  // retain the index order used to construct an object of this class
     index_set set;                         // set storing tuple pointers of table
 
+    /* the disjunction of the presence conditions of the tuples of a value of the leading column */
+    struct Summary {
+        const PresenceCondition* pc = nullptr;
+
+        // the outcome of the last compatibility check, packed as (id of the checked condition << 2 |
+        // valid << 1 | satisfiable), since a scan checks the same context for many values
+        mutable std::atomic<uint64_t> check{0};
+    };
+
+    // only complete orders end in the presence condition column, partial ones are not summarised
+    const bool summarised;
+
+    // summaries of the tuples of each value of the leading column
+    std::unordered_map<RamDomain, Summary> summaries;
+
+    // scans check summaries while other threads insert into the relation
+    mutable ReadWriteLock summaryLock;
+
+    /* widen the summary of the leading value of the given tuple by the tuple's presence condition */
+    void summarise(const RamDomain* tuple) {
+        // complete orders cover all columns but the trailing presence condition
+        const PresenceCondition* pc = PresenceCondition::fromId(tuple[theOrder.size()]);
+        Summary& summary = summaries[tuple[theOrder[0]]];
+        if (summary.pc == nullptr) {
+            summary.pc = pc;
+        } else if (summary.pc != pc && !summary.pc->isTrue()) {
+            const PresenceCondition* widened = summary.pc->disjoin(pc);
+            if (widened != summary.pc) {
+                summary.pc = widened;
+                summary.check.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
 public:
-    InterpreterIndex(InterpreterIndexOrder order) : theOrder(std::move(order)), set(comparator(theOrder)) {}
+    InterpreterIndex(InterpreterIndexOrder order)
+            : theOrder(std::move(order)), set(comparator(theOrder)),
+              summarised(theOrder.size() > 0 && theOrder.isComplete()) {}
 
     const InterpreterIndexOrder& order() const {
         return theOrder;
@@ -195,6 +247,7 @@ public:
      */
     void insert(const RamDomain* tuple) {
         set.insert(tuple);
+        widen(tuple);
     }
 
     /**
@@ -205,8 +258,69 @@ public:
     template <class Iter>
     void insert(const Iter& a, const Iter& b) {
         set.insert(a, b);
+        if (!summarised) {
+            return;
+        }
+        summaryLock.start_write();
+        for (Iter it = a; it != b; ++it) {
+            summarise(*it);
+        }
+        summaryLock.end_write();
     };
 
+    /**
+     * account for the widened presence condition of a tuple of the index
+     *
+     * precondition: the tuple exists in the index
+     */
+    void widen(const RamDomain* tuple) {
+        if (!summarised) {
+            return;
+        }
+        summaryLock.start_write();
+        summarise(tuple);
+        summaryLock.end_write();
+    }
+
+    /**
+     * check whether the range of tuples agreeing with the given value in the
+     * leading column of this index may contain a tuple whose presence
+     * condition is compatible with the given one
+     */
+    bool mayMatch(const RamDomain* value, const PresenceCondition* pc) const {
+        if (!summarised) {
+            return true;
+        }
+        bool res = false;
+        summaryLock.start_read();
+        auto pos = summaries.find(value[theOrder[0]]);
+        if (pos != summaries.end()) {
+            const Summary& summary = pos->second;
+            uint64_t id = static_cast<uint64_t>(pc->getId());
+            uint64_t check = summary.check.load(std::memory_order_relaxed);
+            if ((check & 2) != 0 && (check >> 2) == id) {
+                res = (check & 1) != 0;
+            } else {
+                res = summary.pc->conjSat(pc);
+                summary.check.store((id << 2) | 2 | (res ? 1 : 0), std::memory_order_relaxed);
+            }
+        }
+        summaryLock.end_read();
+        return res;
+    }
+
+    /** sort the given tuples along the order of this index */
+    void sort(std::vector<const RamDomain*>& tuples) const {
+        comparator comp(theOrder);
+        std::sort(tuples.begin(), tuples.end(),
+                [&](const RamDomain* x, const RamDomain* y) { return comp.less(x, y); });
+    }
+
+    /** check whether two tuples agree on all columns of this index */
+    bool equal(const RamDomain* x, const RamDomain* y) const {
+        return comparator(theOrder).equal(x, y);
+    }
+
     /** check whether tuple exists in index */
     const RamDomain* exists(const RamDomain* value) {
         auto it = set.find(value);
@@ -216,6 +330,9 @@ public:
     /** purge all hashes of index */
     void purge() {
         set.clear();
+        summaryLock.start_write();
+        summaries.clear();
+        summaryLock.end_write();
     }
 
     /** enables the index to be printed */
@@ -26,15 +26,16 @@
 namespace souffle {
 
 /**
- * Helper function to convert a tuple to a RamDomain pointer
+ * Helper function to convert a tuple to the lifted RamDomain representation,
+ * i.e., followed by the id of its presence condition
  */
-// TODO (#541): Check whether this helper function causes a memory leak
-inline RamDomain* convertTupleToNums(const tuple& t) {
-    auto* newTuple = new RamDomain[t.size()];
+inline std::vector<RamDomain> convertTupleToNums(const tuple& t) {
+    std::vector<RamDomain> newTuple(t.size() + 1);
 
     for (size_t i = 0; i < t.size(); i++) {
         newTuple[i] = t[i];
     }
+    newTuple[t.size()] = t.getPC()->getId();
 
     return newTuple;
 }
@@ -103,6 +104,7 @@ protected:
                     tup << (*it)[i];
                 }
             }
+            tup.setPC(ramRelationInterface->relation.getPC(*it));
             tup.rewind();
             return tup;
         }
@@ -133,13 +135,18 @@ public:
 
     /** Insert tuple */
     void insert(const tuple& t) override {
-        relation.insert(convertTupleToNums(t));
+        relation.insert(convertTupleToNums(t).data());
     }
 
     /** Check whether tuple exists */
     bool contains(const tuple& t) const override {
+        return getPC(t)->isSAT();
+    }
+
+    /** Get the presence condition of a tuple */
+    const PresenceCondition* getPC(const tuple& t) const override {
         const RamDomain* out = nullptr;
-        return relation.exists(convertTupleToNums(t), out);
+        return relation.exists(convertTupleToNums(t).data(), out);
     }
 
     /** Iterator to first tuple */
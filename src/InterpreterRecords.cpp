@@ -15,75 +15,113 @@
  ***********************************************************************/
 
 #include "InterpreterRecords.h"
+#include "BlockList.h"
+#include "ParallelUtils.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
-#include <iostream>
 
 namespace souffle {
 
 namespace {
 
-using namespace std;
-
 /**
  * A bidirectional mapping between tuples and reference indices.
+ *
+ * The tuples are stored one after the other in blocks, which are allocated on
+ * demand and never moved, such that a reference is unpacked without locking.
+ * The mapping from tuples to references is split into shards which are locked
+ * independently, and its keys point into the blocks, such that packing an
+ * existing tuple does not copy it.
  */
 class RecordMap {
+    /** Number of independently locked parts of the tuple-to-index map */
+    static constexpr size_t NUM_SHARDS = 64;
+
+    /** Hashes the tuple a key points to */
+    struct TupleHash {
+        size_t arity;
+        size_t operator()(const RamDomain* tuple) const {
+            size_t hash = arity;
+            for (size_t i = 0; i < arity; i++) {
+                hash ^= std::hash<RamDomain>()(tuple[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+    /** Compares the tuples keys point to */
+    struct TupleEqual {
+        size_t arity;
+        bool operator()(const RamDomain* a, const RamDomain* b) const {
+            return std::equal(a, a + arity, b);
+        }
+    };
+
+    /** A part of the tuple-to-index map */
+    struct Shard {
+        SpinLock lock;
+        std::unordered_map<const RamDomain*, RamDomain, TupleHash, TupleEqual> r2i;
+    };
+
     /** The arity of the stored tuples */
-    int arity;
+    const size_t arity;
+
+    /** The blocks storing the tuples by index */
+    BlockStore<RamDomain> tuples;
 
-    /** The mapping from tuples to references/indices */
-    map<vector<RamDomain>, RamDomain> r2i;
+    /** The next index to be handed out; index 0 is left free for the null reference */
+    std::atomic<size_t> next;
 
-    /** The mapping from indices to tuples */
-    vector<vector<RamDomain>> i2r;
+    /** The mapping from tuples to indices */
+    std::array<Shard, NUM_SHARDS> shards;
 
 public:
-    RecordMap(int arity) : arity(arity), i2r(1) {}  // note: index 0 element left free
+    RecordMap(size_t arity) : arity(arity), tuples(arity), next(1) {
+        for (auto& shard : shards) {
+            shard.r2i = std::unordered_map<const RamDomain*, RamDomain, TupleHash, TupleEqual>(
+                    0, TupleHash{arity}, TupleEqual{arity});
+        }
+    }
+
+    RecordMap(const RecordMap&) = delete;
+    RecordMap& operator=(const RecordMap&) = delete;
 
     /**
      * Packs the given tuple -- and may create a new reference if necessary.
      */
     RamDomain pack(const RamDomain* tuple) {
-        vector<RamDomain> tmp(arity);
-        for (int i = 0; i < arity; i++) {
-            tmp[i] = tuple[i];
+        Shard& shard = shards[TupleHash{arity}(tuple) % NUM_SHARDS];
+        std::lock_guard<SpinLock> guard(shard.lock);
+        auto pos = shard.r2i.find(tuple);
+        if (pos != shard.r2i.end()) {
+            return pos->second;
         }
 
-        RamDomain index;
-#pragma omp critical(record_pack)
-        {
-            auto pos = r2i.find(tmp);
-            if (pos != r2i.end()) {
-                index = pos->second;
-            } else {
-#pragma omp critical(record_unpack)
-                {
-                    i2r.push_back(tmp);
-                    index = i2r.size() - 1;
-                    r2i[tmp] = index;
-
-                    // assert that new index is smaller than the range
-                    assert(index != std::numeric_limits<RamDomain>::max());
-                }
-            }
-        }
+        size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        // assert that new index is smaller than the range
+        assert(index < (size_t)std::numeric_limits<RamDomain>::max());
 
+        RamDomain* stored = tuples.getSlot(index);
+        std::copy(tuple, tuple + arity, stored);
+        shard.r2i.emplace(stored, index);
         return index;
     }
 
     /**
      * Obtains a pointer to the tuple addressed by the given index.
      */
-    RamDomain* unpack(RamDomain index) {
-        RamDomain* res;
-
-#pragma omp critical(record_unpack)
-        res = &(i2r[index][0]);
-
-        return res;
+    const RamDomain* unpack(RamDomain index) const {
+        return tuples.get(index);
     }
 };
 
@@ -91,27 +129,40 @@ public:
  * The static access function for record maps of certain arities.
  */
 RecordMap& getForArity(int arity) {
-    // the static container -- filled on demand
-    static map<int, RecordMap> maps;
+    // each thread remembers the maps it has accessed, to avoid locking the container
+    thread_local std::vector<RecordMap*> cache;
+    if ((size_t)arity < cache.size() && cache[arity] != nullptr) {
+        return *cache[arity];
+    }
 
-    // get container if present
-    auto pos = maps.find(arity);
-    if (pos != maps.end()) {
-        return pos->second;
+    // the static container -- filled on demand
+    static std::map<int, std::unique_ptr<RecordMap>> maps;
+    static SpinLock lock;
+
+    RecordMap* map;
+    {
+        std::lock_guard<SpinLock> guard(lock);
+        auto& entry = maps[arity];
+        if (!entry) {
+            entry = std::make_unique<RecordMap>(arity);
+        }
+        map = entry.get();
     }
 
-    // create new container if required
-    maps.emplace(arity, arity);
-    return getForArity(arity);
+    if (cache.size() <= (size_t)arity) {
+        cache.resize(arity + 1, nullptr);
+    }
+    cache[arity] = map;
+    return *map;
 }
 }  // namespace
 
-RamDomain pack(RamDomain* tuple, int arity) {
+RamDomain pack(const RamDomain* tuple, int arity) {
     // conduct the packing
     return getForArity(arity).pack(tuple);
 }
 
-RamDomain* unpack(RamDomain ref, int arity) {
+const RamDomain* unpack(RamDomain ref, int arity) {
     // conduct the unpacking
     return getForArity(arity).unpack(ref);
 }
@@ -22,14 +22,17 @@
 namespace souffle {
 
 /**
- * A function packing a tuple of the given arity into a reference.
+ * A function packing a tuple of the given arity into a reference; equal tuples
+ * obtain the same reference. References only depend on the values of a record,
+ * in lifted evaluation as well: the presence condition of a record is the one of
+ * the tuple referencing it. May be called concurrently.
  */
-RamDomain pack(RamDomain* tuple, int arity);
+RamDomain pack(const RamDomain* tuple, int arity);
 
 /**
  * A function obtaining a pointer to the tuple addressed by the given reference.
  */
-RamDomain* unpack(RamDomain ref, int arity);
+const RamDomain* unpack(RamDomain ref, int arity);
 
 /**
  * Obtains the null-reference constant.
@@ -16,13 +16,22 @@
 
 #pragma once
 
+#include "BddRelation.h"
 #include "InterpreterIndex.h"
 #include "ParallelUtils.h"
+#include "PresenceCondition.h"
 #include "RamTypes.h"
+#include "UnionFind.h"
+#include "Util.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace souffle {
@@ -46,8 +55,8 @@ private:
     /** List of indices */
     mutable std::map<InterpreterIndexOrder, std::unique_ptr<InterpreterIndex>> indices;
 
-    /** Total index for existence checks */
-    mutable InterpreterIndex* totalIndex;
+    /** Total index for existence checks, created on first use */
+    mutable std::atomic<InterpreterIndex*> totalIndex;
 
     /** Lock for parallel execution */
     mutable Lock lock;
@@ -90,7 +99,7 @@ public:
         assert(tuple);
 
         const size_t pcIndex = arity - 1;
-        PresenceCondition* pcTuple = (PresenceCondition*) tuple[pcIndex];
+        const PresenceCondition* pcTuple = PresenceCondition::fromId(tuple[pcIndex]);
         if (!pcTuple->isSAT()) {
             return;
         }
@@ -101,33 +110,84 @@ public:
 
         if (exists(tuple, out) != ff) {
             assert(out);
-            PresenceCondition* pc = (PresenceCondition*) out[pcIndex];
+            const PresenceCondition* pc = PresenceCondition::fromId(out[pcIndex]);
             // check PCs
             if (pcTuple != pc) {
-                ((RamDomain*)out)[pcIndex] = (RamDomain)pc->disjoin(pcTuple);
+                ((RamDomain*)out)[pcIndex] = pc->disjoin(pcTuple)->getId();
+                widen(out);
             }
             return;
         }
 
-        int blockIndex = num_tuples / (BLOCK_SIZE / arity);
-        int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
+        RamDomain* newTuple = append(tuple);
 
-        if (tupleIndex == 0) {
-            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
+        // update all indexes with new tuple
+        for (const auto& cur : indices) {
+            cur.second->insert(newTuple);
         }
+    }
 
-        RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
-        for (size_t i = 0; i < arity; ++i) {
-            newTuple[i] = tuple[i];
+    /**
+     * Insert a batch of tuples. The batch is sorted and deduplicated once,
+     * disjoining the presence conditions of duplicates, and the new tuples
+     * are added to each index as a sorted run.
+     */
+    virtual void insertAll(std::vector<const RamDomain*> tuples) {
+        if (tuples.empty()) {
+            return;
         }
 
-        // update all indexes with new tuple
-        for (const auto& cur : indices) {
-            cur.second->insert(newTuple);
+        // check for null-arity
+        if (isNullary()) {
+            num_tuples = 1;
+            return;
         }
 
-        // increment relation size
-        num_tuples++;
+        const size_t pcIndex = arity - 1;
+        tuples.erase(std::remove_if(tuples.begin(), tuples.end(),
+                             [&](const RamDomain* tuple) {
+                                 return !PresenceCondition::fromId(tuple[pcIndex])->isSAT();
+                             }),
+                tuples.end());
+
+        InterpreterIndex* totalIndex = getTotalIndex();
+
+        // sort along the total index, so that duplicates are adjacent and
+        // existence checks walk the index in order
+        totalIndex->sort(tuples);
+
+        const bool probe = !empty();
+        std::vector<const RamDomain*> newTuples;
+        for (size_t i = 0; i < tuples.size();) {
+            const PresenceCondition* pc = PresenceCondition::fromId(tuples[i][pcIndex]);
+            size_t j = i + 1;
+            for (; j < tuples.size() && totalIndex->equal(tuples[i], tuples[j]); ++j) {
+                pc = pc->disjoin(PresenceCondition::fromId(tuples[j][pcIndex]));
+            }
+
+            const RamDomain* out = probe ? totalIndex->exists(tuples[i]) : nullptr;
+            if (out) {
+                const PresenceCondition* cur = PresenceCondition::fromId(out[pcIndex]);
+                if (cur != pc) {
+                    ((RamDomain*)out)[pcIndex] = cur->disjoin(pc)->getId();
+                    widen(out);
+                }
+            } else {
+                RamDomain* newTuple = append(tuples[i]);
+                newTuple[pcIndex] = pc->getId();
+                newTuples.push_back(newTuple);
+            }
+            i = j;
+        }
+
+        // update all indexes with the new tuples, each in its own order
+        totalIndex->insert(newTuples.begin(), newTuples.end());
+        for (const auto& cur : indices) {
+            if (cur.second.get() != totalIndex) {
+                cur.second->sort(newTuples);
+                cur.second->insert(newTuples.begin(), newTuples.end());
+            }
+        }
     }
 
     /** Insert tuple via arguments */
@@ -138,15 +198,18 @@ public:
     }
 
     /** Merge another relation into this relation */
-    void insert(const InterpreterRelationInner& other) {
+    virtual void insert(const InterpreterRelationInner& other) {
         assert(getArity() == other.getArity());
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(other.size());
         for (const auto& cur : other) {
-            insert(cur);
+            tuples.push_back(cur);
         }
+        insertAll(std::move(tuples));
     }
 
     /** Purge table */
-    void purge() {
+    virtual void purge() {
         blockList.clear();
         for (const auto& cur : indices) {
             cur.second->purge();
@@ -154,6 +217,47 @@ public:
         num_tuples = 0;
     }
 
+private:
+    /**
+     * Obtains the total index, creating it on first use; concurrent evaluations may race to
+     * create it, but getIndex hands each of them a complete index under the relation's lock
+     */
+    InterpreterIndex* getTotalIndex() const {
+        InterpreterIndex* res = totalIndex.load(std::memory_order_acquire);
+        if (res == nullptr) {
+            res = getIndex(getTotalIndexKey());
+            totalIndex.store(res, std::memory_order_release);
+        }
+        return res;
+    }
+
+    /** Update the presence condition summaries of all indices for a tuple whose condition was widened */
+    void widen(const RamDomain* tuple) {
+        for (const auto& cur : indices) {
+            cur.second->widen(tuple);
+        }
+    }
+
+    /** Append a copy of a tuple to the block list, without updating any index */
+    RamDomain* append(const RamDomain* tuple) {
+        int blockIndex = num_tuples / (BLOCK_SIZE / arity);
+        int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
+
+        if (tupleIndex == 0) {
+            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
+        }
+
+        RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
+        for (size_t i = 0; i < arity; ++i) {
+            newTuple[i] = tuple[i];
+        }
+
+        // increment relation size
+        num_tuples++;
+        return newTuple;
+    }
+
+public:
     /** get index for a given set of keys using a cached index as a helper. Keys are encoded as bits for each
      * column */
     InterpreterIndex* getIndex(const SearchColumns& key, InterpreterIndex* cachedIndex) const {
@@ -242,17 +346,13 @@ public:
         }
 
         // handle all other arities
-        if (!totalIndex) {
-            totalIndex = getIndex(getTotalIndexKey());
-        }
-
-        const RamDomain* d = totalIndex->exists(tuple);
+        const RamDomain* d = getTotalIndex()->exists(tuple);
 
         if (d) {
             out = d;
         }
 
-        return (d != nullptr) ? (const PresenceCondition*) d[arity-1] : ff;
+        return (d != nullptr) ? PresenceCondition::fromId(d[arity-1]) : ff;
     }
 
     // --- iterator ---
@@ -270,6 +370,12 @@ public:
                 : relation(relation), tuple(relation->isNullary() ? reinterpret_cast<RamDomain*>(this)
                                                                  : &relation->blockList[0][0]) {}
 
+        /** An iterator positioned at the tuple of the given index of a relation which is not nullary */
+        iterator(const InterpreterRelationInner* const relation, size_t index)
+                : relation(relation), index(index),
+                  tuple(&relation->blockList[index / (BLOCK_SIZE / relation->arity)]
+                                            [(index % (BLOCK_SIZE / relation->arity)) * relation->arity]) {}
+
         const RamDomain* operator*() {
             return tuple;
         }
@@ -319,6 +425,24 @@ public:
         return iterator();
     }
 
+    /** Partitions the tuples into up to the given number of ranges of about the same size */
+    std::vector<range<iterator>> partition(size_t num) const {
+        std::vector<range<iterator>> res;
+        if (empty()) {
+            return res;
+        }
+        if (isNullary()) {
+            res.push_back(make_range(begin(), end()));
+            return res;
+        }
+        size_t step = (num_tuples + num - 1) / num;
+        for (size_t first = 0; first < num_tuples; first += step) {
+            size_t last = first + step;
+            res.push_back(make_range(iterator(this, first), (last < num_tuples) ? iterator(this, last) : end()));
+        }
+        return res;
+    }
+
     /** Extend tuple */
     virtual std::vector<RamDomain*> extend(const RamDomain* tuple) {
         std::vector<RamDomain*> newTuples;
@@ -335,92 +459,372 @@ public:
 
 /**
  * Interpreter Equivalence Relation
+ *
+ * The inserted pairs are kept as presence-condition-labelled edges, and a
+ * disjoint set tracks the components they connect in any configuration.
+ * A pair of a component is present under the disjunction, over all paths
+ * connecting its elements, of the conjunction of the edge conditions along
+ * the path. A single edge updates the pairs of the components it joins
+ * incrementally, while batches of edges recompute the pairs of the affected
+ * components from the edges.
  */
-
 class InterpreterEqRelationInner : public InterpreterRelationInner {
+private:
+    /** Inserted pairs, in both directions, with their presence conditions */
+    std::unordered_map<RamDomain, std::map<RamDomain, const PresenceCondition*>> edges;
+
+    /** Components connected by the inserted pairs in some configuration */
+    SparseDisjointSet<RamDomain> sets;
+
 public:
-    InterpreterEqRelationInner(size_t relArity) : InterpreterRelationInner(relArity) {}
+    InterpreterEqRelationInner(size_t relArity) : InterpreterRelationInner(relArity) {
+        assert(relArity == 3);
+    }
 
-    /** Insert tuple */
+    /**
+     * Insert tuple. A path through the new edge (a, b) connects x and y under the conditions
+     * of x to a, of the edge and of b to y, or of x to b, of the edge and of a to y, so only
+     * the pairs of the components of a and b need to be widened.
+     */
     void insert(const RamDomain* tuple) override {
-        // TODO: (pnappa) an eqrel check here is all that appears to be needed for implicit additions
-        // TODO: future optimisation would require this as a member datatype
-        // brave soul required to pass this quest
-        // // specialisation for eqrel defs
-        // std::unique_ptr<binaryrelation> eqreltuples;
-        // in addition, it requires insert functions to insert into that, and functions
-        // which allow reading of stored values must be changed to accommodate.
-        // e.g. insert =>  eqRelTuples->insert(tuple[0], tuple[1]);
+        const PresenceCondition* pc = PresenceCondition::fromId(tuple[2]);
+        if (!pc->isSAT()) {
+            return;
+        }
+        RamDomain a = tuple[0];
+        RamDomain b = tuple[1];
 
-        // for now, we just have a naive & extremely slow version, otherwise known as a O(n^2) insertion
-        // ):
+        // an edge adding no configuration to the connection of its elements changes nothing
+        const PresenceCondition* known = getPair(a, b);
+        if (known->disjoin(pc) == known) {
+            return;
+        }
 
-        for (auto* newTuple : extend(tuple)) {
-            InterpreterRelationInner::insert(newTuple);
-            delete[] newTuple;
+        // the elements of the edge are present wherever it is
+        std::vector<RamDomain> pairs = {a, a, pc->getId(), b, b, pc->getId()};
+        if (!sets.nodeExists(a) || !sets.nodeExists(b) || !sets.sameSet(a, b)) {
+            joinComponents(a, b, pc, pairs);
+        } else {
+            connectWithin(a, b, pc, pairs);
         }
+        addEdges({tuple});
+        InterpreterRelationInner::insertAll(toTuples(pairs));
     }
 
-    /** Find the new knowledge generated by inserting a tuple */
-    std::vector<RamDomain*> extend(const RamDomain* tuple) override {
-        std::vector<RamDomain*> newTuples;
-        
-        size_t arity = getArity();
-        assert(arity == 3);
-        auto pc = tuple[arity-1];
-        
-        newTuples.push_back(new RamDomain[3]{tuple[0], tuple[0], pc});
-        newTuples.push_back(new RamDomain[3]{tuple[0], tuple[1], pc});
-        newTuples.push_back(new RamDomain[3]{tuple[1], tuple[0], pc});
-        newTuples.push_back(new RamDomain[3]{tuple[1], tuple[1], pc});
-
-        std::vector<const RamDomain*> relevantStored;
-        for (const RamDomain* vals : *this) {
-            if (vals[0] == tuple[0] || vals[0] == tuple[1] || vals[1] == tuple[0] || vals[1] == tuple[1]) {
-                relevantStored.push_back(vals);
+    /** Insert a batch of tuples */
+    void insertAll(std::vector<const RamDomain*> tuples) override {
+        std::vector<RamDomain> closure;
+        close(addEdges(tuples), closure);
+        InterpreterRelationInner::insertAll(toTuples(closure));
+    }
+
+    /** Merge another relation into this relation */
+    void insert(const InterpreterRelationInner& other) override {
+        auto eqOther = dynamic_cast<const InterpreterEqRelationInner*>(&other);
+        if (!eqOther) {
+            InterpreterRelationInner::insert(other);
+            return;
+        }
+        // the pairs of the other relation follow from its edges
+        std::vector<RamDomain> otherEdges;
+        eqOther->getEdges(otherEdges);
+        insertAll(toTuples(otherEdges));
+    }
+
+    /** Purge table */
+    void purge() override {
+        edges.clear();
+        sets.clear();
+        InterpreterRelationInner::purge();
+    }
+
+    /**
+     * Extend this relation with the pairs of its components in the union of
+     * its edges and those of the given relation. The edges of the given
+     * relation become edges of this one, so that later insertions see them.
+     */
+    void extend(const InterpreterRelationInner& rel) override {
+        auto other = dynamic_cast<const InterpreterEqRelationInner*>(&rel);
+        assert(other && "an equivalence relation can only be extended by an equivalence relation");
+
+        // components not touched by the other relation are closed already
+        std::vector<RamDomain> otherEdges;
+        other->getEdges(otherEdges);
+        std::vector<RamDomain> closure;
+        close(addEdges(toTuples(otherEdges)), closure);
+        InterpreterRelationInner::insertAll(toTuples(closure));
+    }
+
+private:
+    /** Turn a flat buffer of pairs with presence conditions into tuples */
+    static std::vector<const RamDomain*> toTuples(const std::vector<RamDomain>& buffer) {
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(buffer.size() / 3);
+        for (size_t i = 0; i < buffer.size(); i += 3) {
+            tuples.push_back(&buffer[i]);
+        }
+        return tuples;
+    }
+
+    /** The condition of the pair (x, y), False if it is not contained */
+    const PresenceCondition* getPair(RamDomain x, RamDomain y) const {
+        RamDomain tuple[3] = {x, y, 0};
+        const RamDomain* out = nullptr;
+        return exists(tuple, out);
+    }
+
+    /** The members of the component of the given element, which may not have been inserted yet */
+    std::vector<RamDomain> getMembers(RamDomain node) {
+        if (!sets.nodeExists(node)) {
+            return {node};
+        }
+        RamDomain rep = sets.findNode(node);
+        std::vector<RamDomain> members;
+        for (auto it = sets.begin(rep); it != sets.end(rep); ++it) {
+            members.push_back(*it);
+        }
+        return members;
+    }
+
+    /** Append all edges, in one direction, to a flat buffer of pairs */
+    void getEdges(std::vector<RamDomain>& out) const {
+        for (const auto& from : edges) {
+            for (const auto& to : from.second) {
+                if (from.first <= to.first) {
+                    out.push_back(from.first);
+                    out.push_back(to.first);
+                    out.push_back(to.second->getId());
+                }
             }
         }
+    }
 
-        for (const auto vals : relevantStored) {
-            newTuples.push_back(new RamDomain[3]{vals[0], tuple[0], pc});
-            newTuples.push_back(new RamDomain[3]{vals[0], tuple[1], pc});
-            newTuples.push_back(new RamDomain[3]{vals[1], tuple[0], pc});
-            newTuples.push_back(new RamDomain[3]{vals[1], tuple[1], pc});
-            newTuples.push_back(new RamDomain[3]{tuple[0], vals[0], pc});
-            newTuples.push_back(new RamDomain[3]{tuple[0], vals[1], pc});
-            newTuples.push_back(new RamDomain[3]{tuple[1], vals[0], pc});
-            newTuples.push_back(new RamDomain[3]{tuple[1], vals[1], pc});
+    /**
+     * Append the pairs gained by an edge (a, b) joining two components to a flat buffer. Paths
+     * within either component cannot pass the edge, so only the pairs across them are new.
+     */
+    void joinComponents(RamDomain a, RamDomain b, const PresenceCondition* pc, std::vector<RamDomain>& out) {
+        std::vector<RamDomain> membersA = getMembers(a);
+        std::vector<RamDomain> membersB = getMembers(b);
+
+        // the conditions of the paths from each member of the component of a through the edge
+        std::vector<const PresenceCondition*> fromA;
+        for (RamDomain member : membersA) {
+            fromA.push_back(member == a ? pc : getPair(member, a)->conjoin(pc));
         }
 
-        return newTuples;
+        for (RamDomain y : membersB) {
+            const PresenceCondition* toB = (y == b) ? PresenceCondition::makeTrue() : getPair(y, b);
+            for (size_t i = 0; i < membersA.size(); i++) {
+                const PresenceCondition* path = fromA[i]->conjoin(toB);
+                if (path->isSAT()) {
+                    out.insert(out.end(), {membersA[i], y, path->getId(), y, membersA[i], path->getId()});
+                }
+            }
+        }
     }
-    /** Extend this relation with new knowledge generated by inserting all tuples from a relation */
-    void extend(const InterpreterRelationInner& rel) override {
-        std::vector<RamDomain*> newTuples;
-        // store all values that will be implicitly relevant to the those that we will insert
-        for (const auto* tuple : rel) {
-            for (auto* newTuple : extend(tuple)) {
-                newTuples.push_back(newTuple);
+
+    /**
+     * Append the pairs widened by an edge (a, b) within one component to a flat buffer. If the
+     * edge widens neither the connection of x to a nor that of x to b, every path through it
+     * from x to y is covered by a path from x over a or b to y already, so only the pairs of
+     * members with a widened connection are considered.
+     */
+    void connectWithin(RamDomain a, RamDomain b, const PresenceCondition* pc, std::vector<RamDomain>& out) {
+        std::vector<RamDomain> members;
+        std::vector<const PresenceCondition*> toA;
+        std::vector<const PresenceCondition*> toB;
+        std::vector<const PresenceCondition*> fromA;
+        std::vector<const PresenceCondition*> fromB;
+        for (RamDomain member : getMembers(a)) {
+            // the conditions of the paths from the member to a and to b, empty paths being unconditional
+            const PresenceCondition* curA = (member == a) ? PresenceCondition::makeTrue() : getPair(member, a);
+            const PresenceCondition* curB = (member == b) ? PresenceCondition::makeTrue() : getPair(member, b);
+            const PresenceCondition* viaA = curA->conjoin(pc);
+            const PresenceCondition* viaB = curB->conjoin(pc);
+            if (curB->disjoin(viaA) == curB && curA->disjoin(viaB) == curA) {
+                continue;
+            }
+            members.push_back(member);
+            toA.push_back(curA);
+            toB.push_back(curB);
+            fromA.push_back(viaA);
+            fromB.push_back(viaB);
+        }
+
+        for (size_t i = 0; i < members.size(); i++) {
+            for (size_t j = 0; j < members.size(); j++) {
+                const PresenceCondition* path = fromA[i]->conjoin(toB[j])->disjoin(fromB[i]->conjoin(toA[j]));
+                if (path->isSAT()) {
+                    out.insert(out.end(), {members[i], members[j], path->getId()});
+                }
+            }
+        }
+    }
+
+    /** Add the given pairs as edges, returning their elements */
+    std::vector<RamDomain> addEdges(const std::vector<const RamDomain*>& tuples) {
+        std::vector<RamDomain> touched;
+        for (const RamDomain* tuple : tuples) {
+            const PresenceCondition* pc = PresenceCondition::fromId(tuple[2]);
+            if (!pc->isSAT()) {
+                continue;
+            }
+            for (int i = 0; i < 2; i++) {
+                const PresenceCondition*& cur = edges[tuple[i]][tuple[1 - i]];
+                cur = cur ? cur->disjoin(pc) : pc;
+            }
+            sets.unionNodes(tuple[0], tuple[1]);
+            touched.push_back(tuple[0]);
+        }
+        return touched;
+    }
+
+    /** Append the pairs of the components of the given elements to a flat buffer */
+    void close(const std::vector<RamDomain>& touched, std::vector<RamDomain>& out) {
+        std::set<RamDomain> reps;
+        for (RamDomain node : touched) {
+            reps.insert(sets.findNode(node));
+        }
+        for (RamDomain rep : reps) {
+            std::vector<RamDomain> members;
+            for (auto it = sets.begin(rep); it != sets.end(rep); ++it) {
+                members.push_back(*it);
+            }
+            for (RamDomain member : members) {
+                closeFrom(member, out);
+            }
+        }
+    }
+
+    /** Append the pairs (source, x) of the component of source to a flat buffer */
+    void closeFrom(RamDomain source, std::vector<RamDomain>& out) const {
+        const auto& sourceEdges = edges.at(source);
+
+        // the source is present wherever one of its edges is
+        const PresenceCondition* present = PresenceCondition::makeFalse();
+        for (const auto& edge : sourceEdges) {
+            present = present->disjoin(edge.second);
+        }
+
+        // propagate path conditions until they are stable
+        std::unordered_map<RamDomain, const PresenceCondition*> reached;
+        std::vector<RamDomain> worklist;
+        reached[source] = present;
+        worklist.push_back(source);
+        while (!worklist.empty()) {
+            RamDomain cur = worklist.back();
+            worklist.pop_back();
+            const PresenceCondition* curPC = reached[cur];
+            for (const auto& edge : edges.at(cur)) {
+                const PresenceCondition* pc = curPC->conjoin(edge.second);
+                if (!pc->isSAT()) {
+                    continue;
+                }
+                auto pos = reached.find(edge.first);
+                if (pos == reached.end()) {
+                    reached[edge.first] = pc;
+                } else {
+                    const PresenceCondition* joined = pos->second->disjoin(pc);
+                    if (joined == pos->second) {
+                        continue;
+                    }
+                    pos->second = joined;
+                }
+                worklist.push_back(edge.first);
             }
         }
-        for (const auto* newTuple : newTuples) {
-            InterpreterRelationInner::insert(newTuple);
-            delete[] newTuple;
+
+        for (const auto& cur : reached) {
+            out.push_back(source);
+            out.push_back(cur.first);
+            out.push_back(cur.second->getId());
         }
     }
 };
 
+/**
+ * Interpreter Relation
+ *
+ * The tuples of a BDD relation are held by a BddRelation. Its inner relation then
+ * merely caches the decoded tuples for scans and index lookups, and is refreshed
+ * on demand after the relation has been modified. Single tuples inserted into a BDD
+ * relation are buffered and merged into its BDD in batches, when the buffer is full,
+ * when the inserting operation ends, or before the relation is read.
+ */
 class InterpreterRelation {
 private:
     size_t  arity;
     bool    eqRel;
     InterpreterRelationInner* rel;
 
+    /** The tuples of a BDD relation, or null */
+    std::unique_ptr<BddRelation> bdd;
+
+    /** Whether the inner relation holds the tuples of the BDD relation */
+    mutable std::atomic<bool> decoded;
+
+    /** The number of buffered tuples of a BDD relation which triggers their merge */
+    static constexpr size_t BATCH_SIZE = 1024;
+
+    /** Tuples inserted into a BDD relation but not merged into its BDD yet, one after the other */
+    mutable std::vector<RamDomain> pending;
+
+    /** Lock for concurrent insertions */
+    mutable Lock insertLock;
+
+    /** Lock for decoding the BDD relation */
+    mutable Lock decodeLock;
+
+    /** Merge the buffered tuples into the BDD; to be called while holding the insert lock */
+    void flushPending() const {
+        if (pending.empty()) {
+            return;
+        }
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(pending.size() / (arity + 1));
+        for (size_t i = 0; i < pending.size(); i += arity + 1) {
+            tuples.push_back(&pending[i]);
+        }
+        bdd->insertAll(tuples);
+        pending.clear();
+        decoded = false;
+    }
+
+    /** Refresh the decoded tuples of a BDD relation */
+    void decode() const {
+        flush();
+        if (decoded) {
+            return;
+        }
+        auto lease = decodeLock.acquire();
+        (void)lease;
+        if (decoded) {
+            return;
+        }
+        std::vector<RamDomain> buffer;
+        bdd->decode(buffer);
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(buffer.size() / (arity + 1));
+        for (size_t i = 0; i < buffer.size(); i += arity + 1) {
+            tuples.push_back(&buffer[i]);
+        }
+        rel->purge();
+        rel->insertAll(std::move(tuples));
+        decoded = true;
+    }
+
 public:
-    InterpreterRelation(size_t _arity, bool _eqRel) :
+    /**
+     * Creates a relation; BDD relations are requested by useBdd, but equivalence and
+     * nullary relations keep their tuples explicitly.
+     */
+    InterpreterRelation(size_t _arity, bool _eqRel, bool useBdd = false) :
         arity(_arity),
         eqRel(_eqRel),
-        rel (eqRel ? new InterpreterEqRelationInner(arity + 1) : new InterpreterRelationInner(arity + 1))
+        rel (eqRel ? new InterpreterEqRelationInner(arity + 1) : new InterpreterRelationInner(arity + 1)),
+        bdd((useBdd && !eqRel && arity > 0) ? new BddRelation(arity) : nullptr),
+        decoded(true)
         {} 
 
     InterpreterRelation(const InterpreterRelation& other) = delete;
@@ -433,6 +837,22 @@ public:
         return eqRel;
     }
 
+    /** Obtains the tuples of a BDD relation, or null if this is not a BDD relation */
+    BddRelation* getBdd() const {
+        flush();
+        return bdd.get();
+    }
+
+    /** Merge the buffered tuples of a BDD relation into its BDD */
+    void flush() const {
+        if (!bdd) {
+            return;
+        }
+        auto lease = insertLock.acquire();
+        (void)lease;
+        flushPending();
+    }
+
     /** Get arity of relation */
     size_t getArity() const {
         return arity;
@@ -440,16 +860,27 @@ public:
 
     /** Check whether relation is empty */
     bool empty() const {
-        return rel->empty();
+        flush();
+        return bdd ? bdd->empty() : rel->empty();
     }
 
     /** Gets the number of contained tuples */
     size_t size() const {
-        return rel->size();
+        flush();
+        return bdd ? bdd->size() : rel->size();
     }
 
-    /** Insert tuple */
+    /** Insert tuple; the tuples of a BDD relation are buffered, see flush */
     void insert(const RamDomain* tuple) {
+        auto lease = insertLock.acquire();
+        (void)lease;
+        if (bdd) {
+            pending.insert(pending.end(), tuple, tuple + arity + 1);
+            if (pending.size() >= BATCH_SIZE * (arity + 1)) {
+                flushPending();
+            }
+            return;
+        }
         rel->insert(tuple);
     }
 
@@ -460,29 +891,80 @@ public:
     //    insert(tuple);
     //}
 
+    /** Insert a batch of tuples */
+    void insertAll(std::vector<const RamDomain*> tuples) {
+        auto lease = insertLock.acquire();
+        (void)lease;
+        if (bdd) {
+            bdd->insertAll(tuples);
+            decoded = false;
+            return;
+        }
+        rel->insertAll(std::move(tuples));
+    }
+
     /** Merge another relation into this relation */
     void insert(const InterpreterRelation& other) {
+        if (bdd && other.bdd) {
+            other.flush();
+            auto lease = insertLock.acquire();
+            (void)lease;
+            bdd->insert(*other.bdd);
+            decoded = false;
+            return;
+        }
+        other.decode();
+        if (bdd) {
+            std::vector<const RamDomain*> tuples;
+            for (const RamDomain* cur : other) {
+                tuples.push_back(cur);
+            }
+            insertAll(std::move(tuples));
+            return;
+        }
+        auto lease = insertLock.acquire();
+        (void)lease;
         rel->insert(*other.rel);
     }
 
+    /** Merge the tuples of a term of BDD relations into this BDD relation, see BddRelation */
+    void insert(const BddRelation::Term& term, const std::vector<BddRelation::Column>& columns,
+            const BddRelation* filter) {
+        assert(bdd && "not a BDD relation");
+        auto lease = insertLock.acquire();
+        (void)lease;
+        bdd->insert(term, columns, filter);
+        decoded = false;
+    }
+
     /** Purge table */
     void purge() {
+        if (bdd) {
+            auto lease = insertLock.acquire();
+            (void)lease;
+            pending.clear();
+            bdd->purge();
+            decoded = true;
+        }
         rel->purge();
     }
 
     /** get index for a given set of keys using a cached index as a helper. Keys are encoded as bits for each
      * column */
     InterpreterIndex* getIndex(const SearchColumns& key, InterpreterIndex* cachedIndex) const {
+        decode();
         return rel->getIndex(key, cachedIndex);
     }
 
     /** get index for a given set of keys. Keys are encoded as bits for each column */
     InterpreterIndex* getIndex(const SearchColumns& key) const {
+        decode();
         return rel->getIndex(key);
     }
 
     /** get index for a given order. Keys are encoded as bits for each column */
     InterpreterIndex* getIndex(const InterpreterIndexOrder& order) const {
+        decode();
         return rel->getIndex(order);
     }
 
@@ -493,6 +975,10 @@ public:
 
     /** check whether a tuple exists in the relation */
     const PresenceCondition* exists(const RamDomain* tuple, const RamDomain* out) const {
+        if (bdd) {
+            flush();
+            return bdd->getPC(tuple);
+        }
         return rel->exists(tuple, out);
     }
 
@@ -500,6 +986,7 @@ public:
 
     /** get iterator begin of relation */
     inline iterator begin() const {
+        decode();
         return rel->begin();
     }
 
@@ -508,6 +995,12 @@ public:
         return rel->end();
     }
 
+    /** Partitions the tuples into up to the given number of ranges of about the same size */
+    std::vector<range<iterator>> partition(size_t num) const {
+        decode();
+        return rel->partition(num);
+    }
+
     /** Extend tuple */
     std::vector<RamDomain*> extend(const RamDomain* tuple) {
         return rel->extend(tuple);
@@ -519,8 +1012,62 @@ public:
 
     const PresenceCondition* getPC(const RamDomain* tuple) const {
         return (arity == 0) ? PresenceCondition::makeTrue() :
-                              (const PresenceCondition*) tuple[arity];
+                              PresenceCondition::fromId(tuple[arity]);
     }
 }; // InterpreterRelation
 
+/**
+ * Collects tuples delivered one at a time, e.g. by a ReadStream, and
+ * inserts them into an interpreter relation in batches.
+ */
+class InterpreterRelationLoader {
+private:
+    /** Number of tuples buffered before they are inserted */
+    static const size_t BATCH_SIZE = 1 << 20;
+
+    InterpreterRelation& relation;
+
+    /** Width of a tuple, including its presence condition */
+    const size_t width;
+
+    std::vector<RamDomain> buffer;
+
+    /** Maps the presence conditions of the delivered tuples, if given */
+    std::function<const PresenceCondition*(const PresenceCondition*)> mapPC;
+
+public:
+    InterpreterRelationLoader(InterpreterRelation& relation,
+            std::function<const PresenceCondition*(const PresenceCondition*)> mapPC = nullptr)
+            : relation(relation), width(relation.getArity() + 1), mapPC(std::move(mapPC)) {}
+
+    InterpreterRelationLoader(const InterpreterRelationLoader& other) = delete;
+
+    ~InterpreterRelationLoader() {
+        flush();
+    }
+
+    /** Buffer a tuple */
+    void insert(const RamDomain* tuple) {
+        buffer.insert(buffer.end(), tuple, tuple + width);
+        if (mapPC) {
+            RamDomain& pc = buffer.back();
+            pc = mapPC(PresenceCondition::fromId(pc))->getId();
+        }
+        if (buffer.size() >= BATCH_SIZE * width) {
+            flush();
+        }
+    }
+
+    /** Insert all buffered tuples into the relation */
+    void flush() {
+        std::vector<const RamDomain*> tuples;
+        tuples.reserve(buffer.size() / width);
+        for (size_t i = 0; i < buffer.size(); i += width) {
+            tuples.push_back(&buffer[i]);
+        }
+        relation.insertAll(std::move(tuples));
+        buffer.clear();
+    }
+};
+
 }  // end of namespace souffle
@@ -0,0 +1,256 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file JoinOrderTransformer.cpp
+ *
+ * Orders the atoms of rules by the relation statistics of a profile log.
+ *
+ ***********************************************************************/
+
+#include "AstArgument.h"
+#include "AstClause.h"
+#include "AstLiteral.h"
+#include "AstProgram.h"
+#include "AstRelation.h"
+#include "AstTransforms.h"
+#include "AstTranslationUnit.h"
+#include "AstUtils.h"
+#include "Global.h"
+#include "PrecedenceGraph.h"
+#include "ProfileDatabase.h"
+#include "RelationStats.h"
+#include "Util.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+namespace {
+
+/** The statistics of a relation as recorded in a profile log */
+struct ProfiledRelation {
+    RelationStats stats;
+
+    /** The number of iterations of the fixpoint computing the relation, 0 if not recursive */
+    size_t iterations;
+};
+
+/** Reads the statistics of all relations recorded in the given profile log */
+std::map<std::string, ProfiledRelation> readStatistics(const std::string& filename) {
+    std::map<std::string, ProfiledRelation> res;
+    profile::ProfileDatabase db(filename);
+    auto* relations = dynamic_cast<profile::DirectoryEntry*>(db.lookupEntry({"program", "relation"}));
+    if (relations == nullptr) {
+        return res;
+    }
+    for (const auto& name : relations->getKeys()) {
+        const profile::DirectoryEntry* relation = relations->readDirectoryEntry(name);
+        const profile::DirectoryEntry* statistics =
+                (relation != nullptr) ? relation->readDirectoryEntry("statistics") : nullptr;
+        if (statistics == nullptr) {
+            continue;
+        }
+        auto* cardinality = dynamic_cast<profile::SizeEntry*>(statistics->readEntry("cardinality"));
+        if (cardinality == nullptr) {
+            continue;
+        }
+        std::vector<uint64_t> distinct;
+        if (const profile::DirectoryEntry* columns = statistics->readDirectoryEntry("distinct")) {
+            while (auto* cur = dynamic_cast<profile::SizeEntry*>(
+                           columns->readEntry(std::to_string(distinct.size())))) {
+                distinct.push_back(cur->getSize());
+            }
+        }
+        const profile::DirectoryEntry* iterations = relation->readDirectoryEntry("iteration");
+        res[name] = {RelationStats(cardinality->getSize(), distinct),
+                (iterations != nullptr) ? iterations->getKeys().size() : 0};
+    }
+    return res;
+}
+
+/** Determines whether the value of the given argument is known once the given variables are bound */
+bool isBound(const AstArgument* arg, const std::set<std::string>& bound) {
+    if (dynamic_cast<const AstConstant*>(arg)) {
+        return true;
+    }
+    if (const auto* var = dynamic_cast<const AstVariable*>(arg)) {
+        return bound.count(var->getName()) > 0;
+    }
+    if (dynamic_cast<const AstFunctor*>(arg) || dynamic_cast<const AstRecordInit*>(arg) ||
+            dynamic_cast<const AstTypeCast*>(arg)) {
+        for (const AstNode* cur : arg->getChildNodes()) {
+            const auto* sub = dynamic_cast<const AstArgument*>(cur);
+            if (sub == nullptr || !isBound(sub, bound)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/** Adds the variables bound by the given argument of an atom */
+void bindVariables(const AstArgument* arg, std::set<std::string>& bound) {
+    if (const auto* var = dynamic_cast<const AstVariable*>(arg)) {
+        bound.insert(var->getName());
+    } else if (dynamic_cast<const AstFunctor*>(arg) || dynamic_cast<const AstRecordInit*>(arg) ||
+               dynamic_cast<const AstTypeCast*>(arg)) {
+        for (const AstNode* cur : arg->getChildNodes()) {
+            if (const auto* sub = dynamic_cast<const AstArgument*>(cur)) {
+                bindVariables(sub, bound);
+            }
+        }
+    }
+}
+
+/**
+ * Estimates the number of tuples an atom produces for each binding of the
+ * given variables; the size of a delta relation is estimated as the
+ * average number of tuples added per iteration.
+ */
+double estimate(const AstAtom& atom, const ProfiledRelation& rel, bool delta, const std::set<std::string>& bound) {
+    double size = rel.stats.getCardinality();
+    if (delta && rel.iterations > 0) {
+        size /= rel.iterations;
+    }
+    double res = size;
+    const auto& args = atom.getArguments();
+    for (size_t i = 0; i < args.size(); i++) {
+        if (isBound(args[i], bound)) {
+            double distinct = std::min<double>(rel.stats.getEstimatedCardinality(i), size);
+            res /= std::max(distinct, 1.0);
+        }
+    }
+    return res;
+}
+
+/** Computes the order of the atoms of a clause, starting at 1; delta is the index of the delta atom or -1 */
+std::vector<unsigned int> computeOrder(const AstClause& clause, const std::vector<const ProfiledRelation*>& stats,
+        int delta) {
+    const auto& atoms = clause.getAtoms();
+
+    // variables bound by equalities with constants are known before any atom is evaluated
+    std::set<std::string> bound;
+    for (const AstConstraint* cur : clause.getConstraints()) {
+        const auto* constraint = dynamic_cast<const AstBinaryConstraint*>(cur);
+        if (constraint == nullptr || constraint->getOperator() != BinaryConstraintOp::EQ) {
+            continue;
+        }
+        const auto* lhs = dynamic_cast<const AstVariable*>(constraint->getLHS());
+        const auto* rhs = dynamic_cast<const AstVariable*>(constraint->getRHS());
+        if (lhs && dynamic_cast<const AstConstant*>(constraint->getRHS())) {
+            bound.insert(lhs->getName());
+        } else if (rhs && dynamic_cast<const AstConstant*>(constraint->getLHS())) {
+            bound.insert(rhs->getName());
+        }
+    }
+
+    std::vector<unsigned int> order;
+    std::vector<bool> placed(atoms.size(), false);
+    while (order.size() < atoms.size()) {
+        // pick the cheapest atom; ties preserve the syntactic order
+        int best = -1;
+        double bestCost = 0;
+        for (size_t i = 0; i < atoms.size(); i++) {
+            if (placed[i]) {
+                continue;
+            }
+            double cost = estimate(*atoms[i], *stats[i], (int)i == delta, bound);
+            if (best < 0 || cost < bestCost) {
+                best = i;
+                bestCost = cost;
+            }
+        }
+        placed[best] = true;
+        order.push_back(best + 1);
+        for (const AstArgument* arg : atoms[best]->getArguments()) {
+            bindVariables(arg, bound);
+        }
+    }
+    return order;
+}
+
+}  // namespace
+
+bool JoinOrderTransformer::transform(AstTranslationUnit& translationUnit) {
+    const std::map<std::string, ProfiledRelation> statistics =
+            readStatistics(Global::config().get("profile-use"));
+    if (statistics.empty()) {
+        return false;
+    }
+
+    const AstProgram* program = translationUnit.getProgram();
+    auto* sccGraph = translationUnit.getAnalysis<SCCGraph>();
+    auto* recursiveClauses = translationUnit.getAnalysis<RecursiveClauses>();
+
+    bool changed = false;
+    for (AstRelation* rel : program->getRelations()) {
+        for (AstClause* clause : rel->getClauses()) {
+            const auto& atoms = clause->getAtoms();
+            if (atoms.size() < 2 || clause->getExecutionPlan() || clause->hasFixedExecutionPlan()) {
+                continue;
+            }
+
+            // all atoms need statistics to be compared
+            std::vector<const ProfiledRelation*> stats;
+            for (const AstAtom* atom : atoms) {
+                auto pos = statistics.find(toString(atom->getName()));
+                if (pos == statistics.end()) {
+                    break;
+                }
+                stats.push_back(&pos->second);
+            }
+            if (stats.size() < atoms.size()) {
+                continue;
+            }
+
+            // versions of a recursive clause are numbered by its atoms in the same SCC as the head,
+            // following AstTranslator::translateRecursiveRelation
+            std::vector<int> deltas;
+            if (recursiveClauses->recursive(clause)) {
+                for (size_t i = 0; i < atoms.size(); i++) {
+                    const AstRelation* atomRelation = getAtomRelation(atoms[i], program);
+                    if (atomRelation && sccGraph->getSCC(atomRelation) == sccGraph->getSCC(rel)) {
+                        deltas.push_back(i);
+                    }
+                }
+            } else {
+                deltas.push_back(-1);
+            }
+
+            std::unique_ptr<AstExecutionPlan> plan;
+            for (size_t version = 0; version < deltas.size(); version++) {
+                std::vector<unsigned int> order = computeOrder(*clause, stats, deltas[version]);
+                if (std::is_sorted(order.begin(), order.end())) {
+                    continue;
+                }
+                auto executionOrder = std::make_unique<AstExecutionOrder>();
+                for (unsigned int cur : order) {
+                    executionOrder->appendAtomIndex(cur);
+                }
+                if (!plan) {
+                    plan = std::make_unique<AstExecutionPlan>();
+                }
+                plan->setOrderFor(version, std::move(executionOrder));
+            }
+            if (plan) {
+                clause->setExecutionPlan(std::move(plan));
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+}  // end of namespace souffle
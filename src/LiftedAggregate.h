@@ -0,0 +1,117 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LiftedAggregate.h
+ *
+ * Defines the presence-condition-aware aggregate accumulator shared by
+ * the interpreter and the synthesised C++ code.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "PresenceCondition.h"
+#include "RamTypes.h"
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+
+namespace souffle {
+
+/**
+ * A lifted aggregate partitions the configuration space into presence
+ * conditions, each of which is associated with the aggregate value
+ * computed for the configurations it covers. Configurations sharing a
+ * value share a partition, so the number of partitions is bounded by the
+ * number of distinct aggregate values.
+ */
+class LiftedAggregate {
+public:
+    /** Supported aggregation functions */
+    enum Function { MAX, MIN, COUNT, SUM };
+
+    std::map<RamDomain, const PresenceCondition*> vals;
+
+public:
+    LiftedAggregate(RamDomain init) {
+        vals[init] = PresenceCondition::makeTrue();
+    }
+
+    /** Accumulate value v of a tuple present under pc */
+    void accumulate(Function f, RamDomain v, const PresenceCondition* pc) {
+        if (!pc->isSAT()) {
+            return;
+        }
+
+        std::map<RamDomain, const PresenceCondition*> next;
+        // the part of pc not yet covered by a visited partition
+        const PresenceCondition* rest = pc;
+        for (const auto& it : vals) {
+            if (!rest->isSAT()) {
+                // partitions are disjoint => the remaining ones are not affected
+                add(next, it.first, it.second);
+                continue;
+            }
+
+            const PresenceCondition* cjn = it.second->conjoin(pc);
+            if (!cjn->isSAT()) {
+                add(next, it.first, it.second);
+                continue;
+            }
+            rest = rest->conjoin(cjn->negate());
+
+            add(next, apply(f, it.first, v), cjn);
+            if (cjn != it.second) {
+                // the partition is only partly covered by pc
+                add(next, it.first, it.second->conjoin(pc->negate()));
+            }
+        }
+        vals.swap(next);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const LiftedAggregate& a) {
+        out << "{";
+        for (const auto& v : a.vals) {
+            out << "(" << v.first << ", " << v.second->getText() << "), ";
+        }
+        out << "}";
+        return out;
+    }
+
+private:
+    /** Apply the aggregation function to an accumulated value and a new value */
+    static RamDomain apply(Function f, RamDomain acc, RamDomain v) {
+        switch (f) {
+            case MAX:
+                return std::max(acc, v);
+            case MIN:
+                return std::min(acc, v);
+            case COUNT:
+                return acc + 1;
+            case SUM:
+                return acc + v;
+        }
+        return acc;
+    }
+
+    /** Add a partition, merging it with the partition of an equal value */
+    static void add(std::map<RamDomain, const PresenceCondition*>& parts, RamDomain val,
+            const PresenceCondition* pc) {
+        auto pos = parts.find(val);
+        if (pos == parts.end()) {
+            parts[val] = pc;
+        } else {
+            pos->second = pos->second->disjoin(pc);
+        }
+    }
+};
+
+}  // end of namespace souffle
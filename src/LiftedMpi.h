@@ -0,0 +1,277 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LiftedMpi.h
+ *
+ * Exchange of lifted relations, i.e., of tuples with their presence
+ * conditions, between the processes of the MPI engine, and among the
+ * processes evaluating a partitioned stratum together.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "Mpi.h"
+#include "PresenceCondition.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+namespace mpi {
+
+/**
+ * Serialises the tuples of a relation together with their presence conditions. Presence condition
+ * pointers are local to a process, so the distinct conditions of the relation are encoded once
+ * each by their cover of cubes, and each tuple is extended by the number of its condition.
+ */
+template <typename S, typename T>
+inline void packLifted(
+        const T& data, const size_t length, std::vector<RamDomain>& conditions, std::vector<S>& buffer) {
+    // the true condition is always listed first, so that the list is never empty
+    conditions.clear();
+    PresenceCondition::makeTrue()->serialise(conditions);
+    std::unordered_map<const PresenceCondition*, S> numbers = {{PresenceCondition::makeTrue(), 0}};
+    buffer.clear();
+    buffer.reserve(data.size() * (length + 1));
+    for (const auto& element : data) {
+        for (size_t j = 0; j < length; ++j) {
+            buffer.push_back(element[j]);
+        }
+        const PresenceCondition* pc = data.getPC(element);
+        auto pos = numbers.find(pc);
+        if (pos == numbers.end()) {
+            pos = numbers.insert(std::make_pair(pc, (S)numbers.size())).first;
+            pc->serialise(conditions);
+        }
+        buffer.push_back(pos->second);
+    }
+}
+
+/**
+ * Sends the tuples of a relation together with their presence conditions, the list of conditions
+ * of packLifted first, followed by the tuples.
+ */
+template <typename S, typename T>
+inline void sendLifted(const T& data, const size_t length, const std::set<int>& destinations, const int tag) {
+    std::vector<RamDomain> conditions;
+    std::vector<S> buffer;
+    packLifted(data, length, conditions, buffer);
+    // messages of the same source and tag are not overtaking
+    send(conditions, destinations, tag);
+    send(buffer, destinations, tag);
+}
+
+/**
+ * Receives the tuples of a relation sent by sendLifted into the given buffer, returning the presence
+ * conditions of the received tuples mapped to the conditions of this process.
+ */
+template <typename R>
+inline std::vector<const PresenceCondition*> recvLiftedBuffer(std::vector<R>& buffer, Status& status) {
+    std::vector<RamDomain> conditions;
+    recv(conditions, status);
+    std::vector<const PresenceCondition*> pcs;
+    for (size_t pos = 0; pos < conditions.size();) {
+        pcs.push_back(PresenceCondition::deserialise(conditions, pos));
+    }
+
+    auto next = probe(status);
+    recv(buffer, next);
+    return pcs;
+}
+
+/**
+ * Receives the tuples of a relation sent by sendLifted, mapping their presence conditions to
+ * the conditions of this process.
+ */
+template <typename R, typename T>
+inline void recvLifted(T& data, const size_t length, Status& status) {
+    std::vector<R> buffer;
+    auto pcs = recvLiftedBuffer(buffer, status);
+    for (size_t i = 0; i + length < buffer.size(); i += length + 1) {
+        const R* tuple = &buffer[i];
+        data.insert(tuple, pcs.at(buffer[i + length]));
+    }
+}
+
+/**
+ * Receives the tuples of a relation sent by sendLifted, and requests the symbols of the given
+ * columns of the received tuples which are not cached yet from the root process at once, rather
+ * than one at a time when they are resolved.
+ */
+template <typename R, typename T>
+inline void recvLifted(T& data, const size_t length, Status& status, const SymbolTable& symbolTable,
+        const std::vector<size_t>& symbolColumns) {
+    std::vector<R> buffer;
+    auto pcs = recvLiftedBuffer(buffer, status);
+    std::vector<RamDomain> symbols;
+    for (size_t i = 0; i + length < buffer.size(); i += length + 1) {
+        const R* tuple = &buffer[i];
+        for (size_t col : symbolColumns) {
+            symbols.push_back(tuple[col]);
+        }
+        data.insert(tuple, pcs.at(buffer[i + length]));
+    }
+    symbolTable.prefetch(symbols);
+}
+
+/**
+ * The processes evaluating a stratum together. The first process of a group is the process of the
+ * stratum, which exchanges relations with the other strata. The processes beyond the strata are
+ * assigned to the partitioned strata in turn, and evaluate the recursive relations of their stratum
+ * together with its first process, each one the part of the delta relations it owns.
+ */
+class Group {
+public:
+    /** A group consisting of the calling process only */
+    Group() = default;
+
+    /**
+     * Obtains the stratum of a process. Process 0 is the master process, process i evaluates
+     * stratum i - 1 for i <= strata, and the remaining processes are assigned to the partitioned
+     * strata in turn. Processes without a stratum obtain -1.
+     */
+    static int getStratum(const int rank, const int strata, const std::vector<int>& partitioned) {
+        if (rank <= strata) {
+            return rank - 1;
+        }
+        if (partitioned.empty()) {
+            return -1;
+        }
+        return partitioned[(rank - strata - 1) % partitioned.size()];
+    }
+
+    /** Obtains the group of the given process of a stratum, given the number of processes */
+    static Group getGroup(const int rank, const int stratum, const int strata,
+            const std::vector<int>& partitioned, const int size) {
+        Group group;
+        group.ranks.push_back(stratum + 1);
+        for (int other = strata + 1; other < size; ++other) {
+            if (getStratum(other, strata, partitioned) == stratum) {
+                group.ranks.push_back(other);
+            }
+        }
+        auto pos = std::find(group.ranks.begin(), group.ranks.end(), rank);
+        assert(pos != group.ranks.end() && "process not in the group of its stratum");
+        group.position = pos - group.ranks.begin();
+        return group;
+    }
+
+    /** The number of processes of the group */
+    size_t size() const {
+        return std::max<size_t>(ranks.size(), 1);
+    }
+
+    /** The position of the calling process within the group */
+    size_t getPosition() const {
+        return position;
+    }
+
+    /** The process of the stratum */
+    int getLeader() const {
+        return ranks.empty() ? commRank() : ranks[0];
+    }
+
+    /** Whether the calling process is the process of the stratum */
+    bool isLeader() const {
+        return position == 0;
+    }
+
+    /** The process at the given position */
+    int getRank(const size_t i) const {
+        return ranks.empty() ? commRank() : ranks[i];
+    }
+
+    /** The processes of the group other than the process of the stratum */
+    std::set<int> getHelpers() const {
+        return ranks.empty() ? std::set<int>() : std::set<int>(ranks.begin() + 1, ranks.end());
+    }
+
+    /** Obtains the position of the process owning the tuples with the given value */
+    template <typename R>
+    size_t getOwner(const R value) const {
+        // spread consecutive values, such as symbol indices, evenly
+        return ((uint64_t)value * 0x9E3779B97F4A7C15ull >> 32) % size();
+    }
+
+private:
+    std::vector<int> ranks;
+    size_t position = 0;
+};
+
+/**
+ * Exchanges the tuples of a relation among the processes of a group, such that each process holds
+ * the union of the relation of all processes afterwards. Sends are synchronous, so the pairs of
+ * processes exchange their tuples in the same order on all processes, the process of the lower
+ * position sending first.
+ */
+template <typename R, typename T>
+inline void exchangeLifted(T& data, const size_t length, const Group& group, const int tag) {
+    if (group.size() < 2) {
+        return;
+    }
+    // tuples received from one process are not forwarded to the next one
+    std::vector<RamDomain> conditions;
+    std::vector<R> buffer;
+    packLifted(data, length, conditions, buffer);
+    for (size_t i = 0; i < group.size(); ++i) {
+        if (i == group.getPosition()) {
+            continue;
+        }
+        const int other = group.getRank(i);
+        if (group.getPosition() < i) {
+            send(conditions, other, tag);
+            send(buffer, other, tag);
+        }
+        auto status = probe(other, tag);
+        recvLifted<R>(data, length, status);
+        if (group.getPosition() > i) {
+            send(conditions, other, tag);
+            send(buffer, other, tag);
+        }
+    }
+}
+
+/**
+ * Restricts a relation to the tuples owned by the calling process within a group, by the value of
+ * the given column. Nullary relations are owned by the process of the stratum.
+ */
+template <typename R, typename T>
+inline void partitionLifted(T& data, const size_t length, const Group& group, const size_t column) {
+    if (group.size() < 2) {
+        return;
+    }
+    std::vector<R> buffer;
+    std::vector<const PresenceCondition*> pcs;
+    for (const auto& element : data) {
+        if (length == 0 ? !group.isLeader() : group.getOwner(element[column]) != group.getPosition()) {
+            continue;
+        }
+        for (size_t j = 0; j < length; ++j) {
+            buffer.push_back(element[j]);
+        }
+        pcs.push_back(data.getPC(element));
+    }
+    data.purge();
+    for (size_t i = 0; i < pcs.size(); ++i) {
+        const R* tuple = buffer.data() + i * length;
+        data.insert(tuple, pcs[i]);
+    }
+}
+
+}  // end of namespace mpi
+
+}  // end of namespace souffle
@@ -234,6 +234,14 @@ public:
         return line.str();
     }
 
+    /* prefix of the statistics events of a relation; the name of each statistic is appended to it */
+    static const std::string sRelation(const std::string& relationName) {
+        const char* messageType = "@s-relation";
+        std::stringstream line;
+        line << messageType << ";" << relationName << ";";
+        return line.str();
+    }
+
     static const std::string runtime() {
         const char* messageType = "@runtime";
         std::stringstream line;
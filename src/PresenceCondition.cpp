@@ -29,8 +29,16 @@ DdNode* PresenceCondition::TT;
 #endif
 
 PresenceCondition* PresenceCondition::fmPC = nullptr;
+PresenceCondition* PresenceCondition::ttPC = nullptr;
+PresenceCondition* PresenceCondition::ffPC = nullptr;
 
-std::map<MAP_KEY, PresenceCondition*> PresenceCondition::pcMap;
+PresenceCondition::PCShard PresenceCondition::pcTable[PresenceCondition::PC_SHARDS];
+PresenceCondition::PCIdTable PresenceCondition::pcIds;
+Lock PresenceCondition::bddLock;
+#ifdef SAT_CHECK
+std::vector<int> PresenceCondition::featureVars;
+std::vector<RamDomain> PresenceCondition::varFeatures;
+#endif
 
 #if 0
 
@@ -2,16 +2,26 @@
 
 #define SAT_CHECK
 
+#include <algorithm>
 #include <string>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <sstream>
+#include <stdexcept>
 #include <fstream>
+#include <functional>
+#include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #ifdef SAT_CHECK
 #include <cudd.h>
 #endif //SAT_CHECK
 
+#include "ParallelUtils.h"
+#include "RamTypes.h"
 #include "SymbolTable.h"
 #include "AstPresenceCondition.h"
 #include "PresenceConditionParser.h"
@@ -37,12 +47,413 @@ private:
     DdNode* pcBDD;
 #endif
     PropType type;
+    uint32_t id = 0;
     const PresenceCondition* sub0;
     const PresenceCondition* sub1;
     static PresenceCondition* fmPC;
-    static std::map<MAP_KEY, PresenceCondition*> pcMap;
+    static PresenceCondition* ttPC;
+    static PresenceCondition* ffPC;
 
     std::string text;
+
+    /**
+     * The canonical presence conditions, indexed by their key. The table is sharded
+     * so that threads canonicalising unrelated conditions do not contend.
+     */
+    using pc_key = MAP_KEY;
+    struct PCShard {
+        Lock lock;
+        std::map<pc_key, PresenceCondition*> map;
+    };
+    static const size_t PC_SHARDS = 64;
+    static PCShard pcTable[PC_SHARDS];
+
+    /**
+     * Maps the dense identifiers of presence conditions, which are stored in the trailing
+     * column of lifted tuples, to the conditions themselves. Identifiers are handed out in
+     * creation order, so they fit the 32-bit domain and do not depend on memory layout.
+     */
+    class PCIdTable {
+        static const size_t CHUNK_BITS = 16;
+        static const size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+
+        // chunks are allocated on demand and never moved, so lookups need no locking
+        std::atomic<const PresenceCondition**> chunks[CHUNK_SIZE];
+        std::atomic<uint32_t> next;
+        Lock lock;
+
+    public:
+        PCIdTable() : next(0) {
+            for (auto& chunk : chunks) {
+                chunk.store(nullptr);
+            }
+        }
+
+        uint32_t add(const PresenceCondition* pc) {
+            uint32_t id = next++;
+            auto& chunk = chunks[id >> CHUNK_BITS];
+            if (chunk.load() == nullptr) {
+                auto lease = lock.acquire();
+                (void)lease;
+                if (chunk.load() == nullptr) {
+                    chunk.store(new const PresenceCondition*[CHUNK_SIZE]);
+                }
+            }
+            chunk.load()[id & (CHUNK_SIZE - 1)] = pc;
+            return id;
+        }
+
+        const PresenceCondition* get(uint32_t id) const {
+            assert(id < next.load() && "unknown presence condition id");
+            return chunks[id >> CHUNK_BITS].load()[id & (CHUNK_SIZE - 1)];
+        }
+    };
+    static PCIdTable pcIds;
+
+    /** The lock guarding the BDD manager, which is not thread-safe */
+    static Lock bddLock;
+
+#ifdef SAT_CHECK
+    /**
+     * The BDD variable of each feature, indexed by its symbol, and the feature of each BDD
+     * variable, or -1 for variables not representing features, e.g. those of BDD relations.
+     * Features known at initialisation have the variables of their indices.
+     */
+    static std::vector<int> featureVars;
+    static std::vector<RamDomain> varFeatures;
+
+    /** Obtains the BDD variable of a feature, creating it if needed; to be called while holding bddLock */
+    static int getFeatureVar(RamDomain feature) {
+        while (featureVars.size() <= static_cast<size_t>(feature)) {
+            int var = Cudd_NodeReadIndex(Cudd_bddNewVar(bddMgr));
+            if (varFeatures.size() <= static_cast<size_t>(var)) {
+                varFeatures.resize(var + 1, -1);
+            }
+            varFeatures[var] = featureVars.size();
+            featureVars.push_back(var);
+        }
+        return featureVars[feature];
+    }
+#endif
+
+    friend class BddRelation;
+
+    /** The key of a cached operation: the operator and its canonical operands */
+    struct OpKey {
+        PropType op;
+        const PresenceCondition* lhs;
+        const PresenceCondition* rhs;
+
+        bool operator==(const OpKey& other) const {
+            return op == other.op && lhs == other.lhs && rhs == other.rhs;
+        }
+    };
+
+    struct OpKeyHash {
+        size_t operator()(const OpKey& key) const {
+            // the dense identifiers of the operands spread far better than their addresses
+            uint64_t hash = key.lhs->id;
+            hash = hash * 0x9E3779B97F4A7C15ull + (key.rhs ? key.rhs->id + 1 : 0);
+            hash = hash * 0x9E3779B97F4A7C15ull + key.op;
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    /** An entry of the thread-local operation cache */
+    struct OpEntry {
+        OpKey key;
+        const PresenceCondition* res;
+    };
+
+    /** The number of entries of a thread-local operation cache, a power of two */
+    static const size_t OP_CACHE_SIZE = 1 << 14;
+
+    /**
+     * Obtains the thread-local cache of operation results; hits need no locking at all. The
+     * cache is direct-mapped, so a new result only evicts the one entry sharing its slot.
+     */
+    static std::vector<OpEntry>& getOpCache() {
+        static thread_local std::vector<OpEntry> cache(
+                OP_CACHE_SIZE, OpEntry{{ATOM, nullptr, nullptr}, nullptr});
+        return cache;
+    }
+
+    /**
+     * A shard of the operation cache shared by all threads, so that a result computed by one
+     * thread spares the others the BDD lock. Each shard evicts its least recently used entry.
+     */
+    struct OpShard {
+        using entry_list = std::list<std::pair<OpKey, const PresenceCondition*>>;
+
+        Lock lock;
+        entry_list entries;  // most recently used first
+        std::unordered_map<OpKey, entry_list::iterator, OpKeyHash> index;
+    };
+
+    /** The maximal number of entries of a shard of the shared operation cache */
+    static const size_t OP_SHARD_SIZE = 1 << 14;
+
+    static OpShard& getOpShard(size_t hash) {
+        static OpShard shards[PC_SHARDS];
+        return shards[(hash >> 16) % PC_SHARDS];
+    }
+
+    /** Looks up the result of an operation in the operation caches, or null if it is not cached */
+    static const PresenceCondition* findCached(const OpKey& key, size_t hash) {
+        OpEntry& entry = getOpCache()[hash & (OP_CACHE_SIZE - 1)];
+        if (entry.key == key) {
+            return entry.res;
+        }
+        auto& shard = getOpShard(hash);
+        auto lease = shard.lock.acquire();
+        (void)lease;
+        auto pos = shard.index.find(key);
+        if (pos == shard.index.end()) {
+            return nullptr;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, pos->second);
+        entry = {key, pos->second->second};
+        return entry.res;
+    }
+
+    /** Records the result of an operation in the operation caches */
+    static void addCached(const OpKey& key, size_t hash, const PresenceCondition* res) {
+        getOpCache()[hash & (OP_CACHE_SIZE - 1)] = {key, res};
+        auto& shard = getOpShard(hash);
+        auto lease = shard.lock.acquire();
+        (void)lease;
+        if (shard.index.find(key) != shard.index.end()) {
+            return;
+        }
+        if (shard.entries.size() >= OP_SHARD_SIZE) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+        shard.entries.emplace_front(key, res);
+        shard.index[key] = shard.entries.begin();
+    }
+
+    /**
+     * A shard of the cache of parsed presence conditions, shared by all readers; the cache is
+     * sharded by text so that readers parsing in parallel rarely contend.
+     */
+    struct PCTextShard {
+        Lock lock;
+        std::unordered_map<std::string, PresenceCondition*> map;
+    };
+
+    static PCTextShard& getTextShard(const std::string& text) {
+        static PCTextShard shards[PC_SHARDS];
+        return shards[std::hash<std::string>()(text) % PC_SHARDS];
+    }
+
+    /** Number of BDD operations performed per operation type, guarded by bddLock */
+    static size_t* getOpCounts() {
+        static size_t counts[DISJ + 1] = {};
+        return counts;
+    }
+
+    static PCShard& getShard(const pc_key& key) {
+        return pcTable[std::hash<pc_key>()(key) % PC_SHARDS];
+    }
+
+    /** Registers pc as canonical unless an equivalent one exists, in which case pc is discarded */
+    static PresenceCondition* canonicalise(PresenceCondition* pc) {
+        auto& shard = getShard(pc->getKey());
+        PresenceCondition* res;
+        {
+            auto lease = shard.lock.acquire();
+            (void)lease;
+            res = shard.map.insert(std::make_pair(pc->getKey(), pc)).first->second;
+            if (res == pc) {
+                pc->id = pcIds.add(pc);
+            }
+        }
+        if (res != pc) {
+            delete pc;
+        }
+        return res;
+    }
+
+    pc_key getKey() const {
+#ifdef SAT_CHECK
+        return pcBDD;
+#else
+        return text;
+#endif
+    }
+
+    /** Computes the canonical result of applying op to this and other (unused for negations) */
+    const PresenceCondition* apply(PropType op, const PresenceCondition* other) const {
+        OpKey key = {op, this, other};
+        size_t hash = OpKeyHash()(key);
+        const PresenceCondition* res = findCached(key, hash);
+        if (res != nullptr) {
+            return res;
+        }
+
+#ifdef SAT_CHECK
+        DdNode* tmp = nullptr;
+        if (op == NEG) {
+            // negation only flips the complement bit, so a known result needs no BDD lock
+            auto& shard = getShard(Cudd_Not(pcBDD));
+            auto lease = shard.lock.acquire();
+            (void)lease;
+            auto pos = shard.map.find(Cudd_Not(pcBDD));
+            if (pos != shard.map.end()) {
+                res = pos->second;
+            }
+        }
+        if (res == nullptr) {
+            auto lease = bddLock.acquire();
+            (void)lease;
+            switch (op) {
+                case NEG:
+                    tmp = Cudd_Not(pcBDD);
+                    break;
+                case CONJ:
+                    tmp = Cudd_bddAnd(bddMgr, pcBDD, other->pcBDD);
+                    break;
+                case DISJ:
+                    tmp = Cudd_bddOr(bddMgr, pcBDD, other->pcBDD);
+                    break;
+                case ATOM:
+                    assert(false && "atoms are not operations");
+            }
+            Cudd_Ref(tmp);
+            getOpCounts()[op]++;
+        }
+#else
+        std::string tmp;
+        switch (op) {
+            case NEG:
+                tmp = "!" + text;
+                break;
+            case CONJ:
+                tmp = "(" + text + " /\\ " + other->text + ")";
+                break;
+            case DISJ:
+                tmp = "(" + text + " \\/ " + other->text + ")";
+                break;
+            case ATOM:
+                assert(false && "atoms are not operations");
+        }
+#endif
+
+        if (res == nullptr) {
+            res = canonicalise(new PresenceCondition(
+#ifdef SAT_CHECK
+                    tmp, op, this, other, ""));
+#else
+                    op, this, other, tmp));
+#endif
+        }
+        assert(res);
+
+        addCached(key, hash, res);
+        return res;
+    }
+#ifdef SAT_CHECK
+    /**
+     * Enumerates the satisfying assignments of f to the variables from var on, in depth-first
+     * order; to be called while holding bddLock.
+     */
+    static bool enumerate(DdNode* f, size_t var, std::vector<bool>& cur, size_t limit,
+            std::vector<std::vector<bool>>& configurations) {
+        if (f == FF) {
+            return true;
+        }
+        if (var == cur.size()) {
+            if (configurations.size() >= limit) {
+                return false;
+            }
+            configurations.push_back(cur);
+            return true;
+        }
+        for (bool value : {false, true}) {
+            DdNode* literal = Cudd_bddIthVar(bddMgr, getFeatureVar(var));
+            DdNode* sub = Cudd_bddAnd(bddMgr, f, value ? literal : Cudd_Not(literal));
+            Cudd_Ref(sub);
+            cur[var] = value;
+            bool complete = enumerate(sub, var + 1, cur, limit, configurations);
+            Cudd_RecursiveDeref(bddMgr, sub);
+            if (!complete) {
+                return false;
+            }
+        }
+        cur[var] = false;
+        return true;
+    }
+
+    /**
+     * Obtains an irredundant cover of this condition by prime implicants, each one given by
+     * its literals as pairs of feature and polarity, in a canonical order.
+     */
+    std::vector<std::vector<std::pair<RamDomain, bool>>> getCover() const {
+        std::vector<std::vector<std::pair<RamDomain, bool>>> cover;
+        {
+            auto lease = bddLock.acquire();
+            (void)lease;
+            int size = Cudd_ReadSize(bddMgr);
+            DdGen* gen;
+            int* cube;
+            Cudd_ForeachPrime(bddMgr, pcBDD, pcBDD, gen, cube) {
+                std::vector<std::pair<RamDomain, bool>> literals;
+                for (int var = 0; var < size; var++) {
+                    if (cube[var] != 2) {
+                        assert(varFeatures[var] >= 0 && "not a condition over features");
+                        literals.emplace_back(varFeatures[var], cube[var] == 1);
+                    }
+                }
+                std::sort(literals.begin(), literals.end());
+                cover.push_back(std::move(literals));
+            }
+        }
+        std::sort(cover.begin(), cover.end());
+        return cover;
+    }
+
+    /**
+     * Obtains the canonical condition of a BDD over feature variables, e.g. the condition of a
+     * tuple of a BDD relation. Known conditions keep their text, others are built by expanding
+     * their top variable. The BDD has to be referenced by the caller.
+     */
+    static const PresenceCondition* fromBDD(DdNode* bdd) {
+        if (bdd == TT) {
+            return ttPC;
+        }
+        if (bdd == FF) {
+            return ffPC;
+        }
+        {
+            auto& shard = getShard(bdd);
+            auto lease = shard.lock.acquire();
+            (void)lease;
+            auto pos = shard.map.find(bdd);
+            if (pos != shard.map.end()) {
+                return pos->second;
+            }
+        }
+
+        // the cofactors are referenced through bdd
+        RamDomain feature;
+        DdNode* thenBDD;
+        DdNode* elseBDD;
+        {
+            auto lease = bddLock.acquire();
+            (void)lease;
+            DdNode* node = Cudd_Regular(bdd);
+            size_t var = Cudd_NodeReadIndex(node);
+            assert(var < varFeatures.size() && varFeatures[var] >= 0 && "not a condition over features");
+            feature = varFeatures[var];
+            thenBDD = Cudd_IsComplement(bdd) ? Cudd_Not(Cudd_T(node)) : Cudd_T(node);
+            elseBDD = Cudd_IsComplement(bdd) ? Cudd_Not(Cudd_E(node)) : Cudd_E(node);
+        }
+        const PresenceCondition* literal = parse(featSymTab->resolve(feature));
+        return literal->conjoin(fromBDD(thenBDD))->disjoin(literal->negate()->conjoin(fromBDD(elseBDD)));
+    }
+#endif
+
 protected:
     PresenceCondition() {}
 
@@ -63,62 +474,276 @@ protected:
     {}
 
 public:
-    static void init(SymbolTable& st) {
+    /**
+     * Initialises the presence condition subsystem; to be called before any parallel evaluation.
+     *
+     * @param featureModel file holding a formula that every valid configuration satisfies
+     * @param variableOrder file listing features in the order of their BDD variables
+     * @param reorder CUDD dynamic reordering method (see getReorderingType)
+     */
+    static void init(SymbolTable& st, const std::string& featureModel = "",
+            const std::string& variableOrder = "", const std::string& reorder = "") {
         featSymTab = &st;
+
+        // register the features of the variable order first, so that they have BDD variables
+        std::vector<int> order;
+        if (!variableOrder.empty()) {
+            std::ifstream in(variableOrder);
+            if (!in.is_open()) {
+                throw std::invalid_argument("Cannot open variable order file " + variableOrder);
+            }
+            std::string feat;
+            while (in >> feat) {
+                order.push_back(st.lookup(feat));
+            }
+        }
+
 #ifdef SAT_CHECK
         bddMgr = Cudd_Init(
             featSymTab->size(), 
             0, 
-            CUDD_CACHE_SLOTS, 
+            CUDD_UNIQUE_SLOTS, 
             CUDD_CACHE_SLOTS, 
             0);
         assert(bddMgr);
+
+        featureVars.clear();
+        varFeatures.clear();
+        for (size_t var = 0; var < featSymTab->size(); var++) {
+            featureVars.push_back(var);
+            varFeatures.push_back(var);
+        }
+
+        if (!order.empty()) {
+            // listed features come first, the remaining ones follow in symbol table order
+            std::vector<int> perm;
+            std::vector<bool> placed(featSymTab->size(), false);
+            for (int var : order) {
+                if (!placed[var]) {
+                    placed[var] = true;
+                    perm.push_back(var);
+                }
+            }
+            for (size_t var = 0; var < placed.size(); var++) {
+                if (!placed[var]) {
+                    perm.push_back(var);
+                }
+            }
+            if (!Cudd_ShuffleHeap(bddMgr, perm.data())) {
+                throw std::runtime_error("Cannot apply variable order " + variableOrder);
+            }
+        }
+
+        if (!reorder.empty()) {
+            Cudd_ReorderingType method = getReorderingType(reorder);
+            if (method != CUDD_REORDER_NONE) {
+                Cudd_AutodynEnable(bddMgr, method);
+            }
+        }
+
+        FF = Cudd_ReadLogicZero(bddMgr);
+        TT = Cudd_ReadOne(bddMgr);
+#else
+        if (!reorder.empty()) {
+            getReorderingType(reorder);
+        }
+#endif
+        ffPC = canonicalise(new PresenceCondition(
+#ifdef SAT_CHECK
+            FF, 
 #endif
+            ATOM, nullptr, nullptr, "False"));
 
-        std::string fmPath = "/home/ramy/model.prop";
-        std::ifstream in(fmPath.c_str());
-        if (in.good()) {
+        ttPC = canonicalise(new PresenceCondition(
+#ifdef SAT_CHECK
+            TT,
+#endif
+            ATOM, nullptr, nullptr, "True"));
+
+        assert(ffPC != nullptr);
+        assert(ttPC != nullptr);
+
+        fmPC = nullptr;
+        if (!featureModel.empty()) {
+            std::ifstream in(featureModel);
+            if (!in.is_open()) {
+                throw std::invalid_argument("Cannot open feature model file " + featureModel);
+            }
+            // the formula may span several lines
             std::string fm;
-            getline(in, fm);
-            std::cout << "Using Feature Model: " << fm << std::endl;
+            std::string line;
+            while (getline(in, line)) {
+                fm += line + " ";
+            }
 #ifdef SAT_CHECK
-            PresenceConditionParser parser(fm);
-            auto ast = parser.parse(st);
-            fmPC = parse(*ast);
+            fmPC = parse(fm);
+            if (!fmPC) {
+                throw std::invalid_argument("Cannot parse feature model " + featureModel);
+            }
 #else
             fmPC = new PresenceCondition(ATOM, nullptr, nullptr, fm);
 #endif
         }
+    }
+
+    /** Maps the name of a CUDD dynamic reordering method to its CUDD identifier */
+    static Cudd_ReorderingType getReorderingType(const std::string& name) {
+        static const std::map<std::string, Cudd_ReorderingType> methods = {
+                {"none", CUDD_REORDER_NONE}, {"random", CUDD_REORDER_RANDOM},
+                {"sift", CUDD_REORDER_SIFT}, {"sift-converge", CUDD_REORDER_SIFT_CONVERGE},
+                {"symm-sift", CUDD_REORDER_SYMM_SIFT}, {"group-sift", CUDD_REORDER_GROUP_SIFT},
+                {"lazy-sift", CUDD_REORDER_LAZY_SIFT}, {"window2", CUDD_REORDER_WINDOW2},
+                {"window3", CUDD_REORDER_WINDOW3}, {"window4", CUDD_REORDER_WINDOW4},
+                {"annealing", CUDD_REORDER_ANNEALING}, {"genetic", CUDD_REORDER_GENETIC},
+                {"linear", CUDD_REORDER_LINEAR}, {"exact", CUDD_REORDER_EXACT}};
+        auto pos = methods.find(name);
+        if (pos == methods.end()) {
+            throw std::invalid_argument("Unknown BDD reordering method " + name);
+        }
+        return pos->second;
+    }
+
+    /** A configuration, selecting the features whose symbol indices are set */
+    using Configuration = std::vector<bool>;
+
+    /** Obtains the feature model, or null if every configuration is valid */
+    static PresenceCondition* getFeatureModel() {
+        return fmPC;
+    }
 
+    /** Replaces the feature model; not to be called during an evaluation */
+    static void setFeatureModel(PresenceCondition* fm) {
+        fmPC = fm;
+    }
+
+    /** Counts the configurations of the features known so far which satisfy the feature model */
+    static double countConfigurations() {
 #ifdef SAT_CHECK
-        FF = Cudd_ReadLogicZero(bddMgr);
-        TT = Cudd_ReadOne(bddMgr);
+        auto lease = bddLock.acquire();
+        (void)lease;
+        return Cudd_CountMinterm(bddMgr, fmPC ? fmPC->pcBDD : TT, featSymTab->size());
+#else
+        throw std::runtime_error("Counting configurations requires SAT checking");
 #endif
-        pcMap[FF] = new PresenceCondition(
+    }
+
+    /**
+     * Enumerates the configurations of the features known so far which satisfy the feature model.
+     *
+     * @param limit the maximal number of configurations to enumerate
+     * @param configurations receives the configurations
+     * @return whether all configurations have been enumerated
+     */
+    static bool enumerateConfigurations(size_t limit, std::vector<Configuration>& configurations) {
 #ifdef SAT_CHECK
-            FF, 
+        auto lease = bddLock.acquire();
+        (void)lease;
+        Configuration cur(featSymTab->size(), false);
+        return enumerate(fmPC ? fmPC->pcBDD : TT, 0, cur, limit, configurations);
+#else
+        throw std::runtime_error("Enumerating configurations requires SAT checking");
 #endif
-            ATOM, nullptr, nullptr, "False");
+    }
+
+    /** Obtains the condition holding in exactly the given configuration */
+    static PresenceCondition* fromConfiguration(const Configuration& configuration) {
+        if (configuration.empty()) {
+            return ttPC;
+        }
+        std::string text;
+        for (size_t i = 0; i < configuration.size(); i++) {
+            std::string literal = (configuration[i] ? "" : "!") + featSymTab->resolve(i);
+            text = (i == 0) ? literal : "(" + text + " /\\ " + literal + ")";
+        }
+        return parse(text);
+    }
+
+    /**
+     * Obtains the configuration selecting exactly the given features; unlike parsing, this does
+     * not extend the feature table.
+     *
+     * @throws std::invalid_argument if a feature is not known
+     */
+    static Configuration toConfiguration(const std::vector<std::string>& features) {
+        std::unordered_map<std::string, RamDomain> known;
+        size_t size = featSymTab->size();
+        for (size_t i = 0; i < size; i++) {
+            known[featSymTab->resolve(i)] = i;
+        }
+        Configuration configuration(size, false);
+        for (const std::string& feature : features) {
+            auto pos = known.find(feature);
+            if (pos == known.end()) {
+                throw std::invalid_argument("Unknown feature " + feature);
+            }
+            configuration[pos->second] = true;
+        }
+        return configuration;
+    }
 
-        pcMap[TT] = new PresenceCondition(
+    /**
+     * Evaluates this condition in the given configuration; features beyond the configuration
+     * are not selected.
+     *
+     * @return the true or the false condition
+     */
+    const PresenceCondition* evaluate(const Configuration& configuration) const {
 #ifdef SAT_CHECK
-            TT,
+        DdNode* res;
+        {
+            auto lease = bddLock.acquire();
+            (void)lease;
+            std::vector<int> inputs(std::max(Cudd_ReadSize(bddMgr), 1), 0);
+            for (size_t i = 0; i < configuration.size() && i < featureVars.size(); i++) {
+                inputs[featureVars[i]] = configuration[i];
+            }
+            res = Cudd_Eval(bddMgr, pcBDD, inputs.data());
+        }
+        return (res == TT) ? ttPC : ffPC;
+#else
+        (void)configuration;
+        throw std::runtime_error("Evaluating presence conditions requires SAT checking");
 #endif
-            ATOM, nullptr, nullptr, "True");
+    }
 
-        assert(pcMap[FF] != nullptr);
-        assert(pcMap[TT] != nullptr);
+    /** Prints statistics of the BDD manager */
+    static void printStats(std::ostream& out) {
+#ifdef SAT_CHECK
+        auto lease = bddLock.acquire();
+        (void)lease;
+        out << "BDD vars:    " << Cudd_ReadSize(bddMgr) << std::endl;
+        out << "BDD nodes:   " << Cudd_ReadNodeCount(bddMgr) << std::endl;
+        out << "BDD peak:    " << Cudd_ReadPeakNodeCount(bddMgr) << std::endl;
+        out << "BDD cache:   " << Cudd_ReadCacheHits(bddMgr) << " hits / " << Cudd_ReadCacheLookUps(bddMgr)
+            << " lookups" << std::endl;
+        out << "Reorderings: " << Cudd_ReadReorderings(bddMgr) << std::endl;
+        const size_t* counts = getOpCounts();
+        out << "BDD ops:     " << counts[CONJ] << " conjoin / " << counts[DISJ] << " disjoin / "
+            << counts[NEG] << " negate" << std::endl;
+#else
+        (void)out;
+#endif
     }
 
     static PresenceCondition* makeTrue() {
-        auto ret = fmPC ? fmPC : pcMap[TT];
+        auto ret = fmPC ? fmPC : ttPC;
         assert(ret);
 
         return ret;
     }
 
     static PresenceCondition* makeFalse() {
-        return pcMap[FF];
+        return ffPC;
+    }
+
+    /** Obtains the dense identifier of this condition, as stored in the columns of lifted tuples */
+    RamDomain getId() const {
+        return static_cast<RamDomain>(id);
+    }
+
+    /** Obtains the presence condition of the given identifier */
+    static const PresenceCondition* fromId(RamDomain id) {
+        return pcIds.get(static_cast<uint32_t>(id));
     }
 
     static size_t getFeatCount() {
@@ -126,7 +751,13 @@ public:
     }
 
     static size_t getPCCount() {
-        return pcMap.size();
+        size_t res = 0;
+        for (auto& shard : pcTable) {
+            auto lease = shard.lock.acquire();
+            (void)lease;
+            res += shard.map.size();
+        }
+        return res;
     }
 
     static PresenceCondition* parse(const AstPresenceCondition& pc) {
@@ -134,19 +765,13 @@ public:
         pc.print(ostr);
         std::string text = ostr.str();
 #ifdef SAT_CHECK
-        auto pcBDD = const_cast<AstPresenceCondition&>(pc).toBDD(bddMgr);
-#endif
-        auto _pc = pcMap.find(
-#ifdef SAT_CHECK
-            pcBDD
-#else
-            text
-#endif
-            );
-        if (_pc != pcMap.end()) {
-            return _pc->second;
+        DdNode* pcBDD;
+        {
+            auto lease = bddLock.acquire();
+            (void)lease;
+            pcBDD = const_cast<AstPresenceCondition&>(pc).toBDD(bddMgr, getFeatureVar);
         }
-        
+#endif
         PresenceCondition* newpc = new PresenceCondition(
 #ifdef SAT_CHECK
             pcBDD,
@@ -155,14 +780,47 @@ public:
 
         assert(newpc);
 
-        pcMap[
-#ifdef SAT_CHECK
-            pcBDD
-#else
-            text
-#endif
-             ] = newpc;
-        return newpc;
+        return canonicalise(newpc);
+    }
+
+    /**
+     * Parse the textual form of a presence condition over the feature symbol table.
+     * Results are cached by text, so that fact files repeating a few conditions over
+     * many rows only parse each distinct condition once.
+     */
+    static PresenceCondition* parse(const std::string& text) {
+        assert(featSymTab);
+        return parse(text, *featSymTab);
+    }
+
+    /**
+     * Parse the textual form of a presence condition, resolving features in the given symbol
+     * table, which has to be the one the subsystem was initialised with for the features to
+     * denote their BDD variables.
+     */
+    static PresenceCondition* parse(const std::string& text, SymbolTable& symbols) {
+        assert(&symbols == featSymTab && "presence conditions are over the feature symbol table");
+        auto& shard = getTextShard(text);
+        {
+            auto lease = shard.lock.acquire();
+            (void)lease;
+            auto pos = shard.map.find(text);
+            if (pos != shard.map.end()) {
+                return pos->second;
+            }
+        }
+
+        PresenceConditionParser parser(text);
+        std::unique_ptr<AstPresenceCondition> ast(parser.parse(symbols));
+        if (!ast) {
+            return nullptr;
+        }
+        PresenceCondition* res = parse(*ast);
+
+        auto lease = shard.lock.acquire();
+        (void)lease;
+        shard.map[text] = res;
+        return res;
     }
 
 #ifndef NDEBUG
@@ -175,6 +833,8 @@ public:
 
     ~PresenceCondition() {
 #ifdef SAT_CHECK
+        auto lease = bddLock.acquire();
+        (void)lease;
         Cudd_RecursiveDeref(bddMgr, pcBDD);
         #ifndef NDEBUG
         pcBDD = nullptr;
@@ -182,12 +842,20 @@ public:
 #endif
     }
 
+    /** Check whether the conjunction with the other condition is satisfiable, without building it */
     bool conjSat(const PresenceCondition* other) const {
         assert(other);
 #ifdef SAT_CHECK
-        DdNode* tmp = Cudd_bddAnd(bddMgr, pcBDD, other->pcBDD);
-    
-        return tmp != FF;
+        if (isTrue() || other->isTrue()) {
+            return isSAT() && other->isSAT();
+        }
+        OpKey key = {CONJ, this, other};
+        if (const PresenceCondition* conj = findCached(key, OpKeyHash()(key))) {
+            return conj->isSAT();
+        }
+        auto lease = bddLock.acquire();
+        (void)lease;
+        return Cudd_bddLeq(bddMgr, pcBDD, Cudd_Not(other->pcBDD)) == 0;
 #else
         return true;
 #endif
@@ -222,24 +890,7 @@ public:
     }
 
     const PresenceCondition* negate() const {
-        DdNode* tmp = Cudd_Not(pcBDD);
-        auto cached = pcMap.find(tmp);
-        if (cached != pcMap.end()) {
-            return cached->second;
-        }
-
-        Cudd_Ref(tmp);
-
-        PresenceCondition *pc = new PresenceCondition(
-            tmp,
-            NEG, this, nullptr, ""
-            );
-
-        assert(pc);
-
-        pcMap[tmp] = pc;
-
-        return pc;
+        return apply(NEG, nullptr);
     }
 
     const PresenceCondition* conjoin(const PresenceCondition* other) const {
@@ -256,32 +907,7 @@ public:
             return this;
         }
 
-#ifdef SAT_CHECK
-        DdNode* tmp = Cudd_bddAnd(bddMgr, pcBDD, other->pcBDD);
-#else
-        std::string tmp = "(" + text + " /\\ " + other->text + ")";
-#endif
-        auto cached = pcMap.find(tmp);
-        if (cached != pcMap.end()) {
-            return cached->second;
-        }
-
-#ifdef SAT_CHECK
-        Cudd_Ref(tmp);
-#endif
-
-        PresenceCondition *pc = new PresenceCondition(
-#ifdef SAT_CHECK
-            tmp,
-#endif
-            CONJ, this, other, ""
-            );
-
-        assert(pc);
-
-        pcMap[tmp] = pc;
-
-        return pc;
+        return apply(CONJ, other);
     }
 
     const PresenceCondition* disjoin(const PresenceCondition* other) const {
@@ -299,31 +925,7 @@ public:
             return this;
         }
 
-#ifdef SAT_CHECK
-        DdNode* tmp = Cudd_bddOr(bddMgr, pcBDD, other->pcBDD);
-#else
-        std::string tmp = "(" + text + " \\/ " + other->text + ")";
-#endif
-        auto cached = pcMap.find(tmp);
-        if (cached != pcMap.end()) {
-            return cached->second;
-        }
-
-#ifdef SAT_CHECK
-        Cudd_Ref(tmp);
-#endif
-
-        PresenceCondition *pc = new PresenceCondition(
-#ifdef SAT_CHECK
-            tmp,
-#endif
-            DISJ, this, other, ""
-        );
-
-        assert(pc);
-
-        pcMap[tmp] = pc;
-        return pc;
+        return apply(DISJ, other);
     }
 
     bool isSAT() const {
@@ -356,6 +958,69 @@ public:
         return "";
     }
 
+    /**
+     * Obtains the text of an irredundant cover of this condition by prime implicants, which
+     * is much shorter than the text of a condition composed of many configurations.
+     */
+    std::string getMinimalText() const {
+#ifdef SAT_CHECK
+        if (pcBDD == TT || pcBDD == FF) {
+            return text;
+        }
+        std::string res;
+        auto cover = getCover();
+        for (size_t i = 0; i < cover.size(); i++) {
+            std::string term;
+            for (size_t j = 0; j < cover[i].size(); j++) {
+                std::string literal = (cover[i][j].second ? "" : "!") + featSymTab->resolve(cover[i][j].first);
+                term = (j == 0) ? literal : "(" + term + " /\\ " + literal + ")";
+            }
+            res = (i == 0) ? term : "(" + res + " \\/ " + term + ")";
+        }
+        return res;
+#else
+        return getText();
+#endif
+    }
+
+    /**
+     * Appends an encoding of this condition to the given buffer which is independent of the
+     * process, as feature indices are shared: the number of cubes of an irredundant cover,
+     * followed by the number of literals and the literals (feature << 1 | selected) of each cube.
+     */
+    void serialise(std::vector<RamDomain>& buffer) const {
+#ifdef SAT_CHECK
+        auto cover = getCover();
+        buffer.push_back(cover.size());
+        for (const auto& cube : cover) {
+            buffer.push_back(cube.size());
+            for (const auto& literal : cube) {
+                buffer.push_back(literal.first << 1 | (literal.second ? 1 : 0));
+            }
+        }
+#else
+        (void)buffer;
+        throw std::runtime_error("Serialising presence conditions requires SAT checking");
+#endif
+    }
+
+    /** Decodes a condition encoded by serialise at the given position, advancing the position */
+    static const PresenceCondition* deserialise(const std::vector<RamDomain>& buffer, size_t& pos) {
+        const PresenceCondition* res = ffPC;
+        RamDomain cubes = buffer.at(pos++);
+        for (RamDomain i = 0; i < cubes; i++) {
+            const PresenceCondition* cube = ttPC;
+            RamDomain literals = buffer.at(pos++);
+            for (RamDomain j = 0; j < literals; j++) {
+                RamDomain literal = buffer.at(pos++);
+                const PresenceCondition* feature = parse(featSymTab->resolve(literal >> 1));
+                cube = cube->conjoin((literal & 1) ? feature : feature->negate());
+            }
+            res = res->disjoin(cube);
+        }
+        return res;
+    }
+
     friend std::ostream& operator<<(std::ostream& out, const PresenceCondition& pc) {
         out << pc.getText();
         return out;
@@ -0,0 +1,149 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProductEvaluator.cpp
+ *
+ * Implements the evaluation of a RAM program per configuration.
+ *
+ ***********************************************************************/
+
+#include "ProductEvaluator.h"
+#include "Global.h"
+#include "IODirectives.h"
+#include "IOSystem.h"
+#include "Interpreter.h"
+#include "RamStatement.h"
+#include "RamTranslationUnit.h"
+#include "SymbolTable.h"
+#include "WriteStream.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle {
+
+void ProductEvaluator::execute() {
+    // configurations read from a file may violate the feature model
+    if (featureModel != nullptr) {
+        auto invalid = std::remove_if(configurations.begin(), configurations.end(),
+                [&](const Configuration& configuration) {
+                    return !featureModel->evaluate(configuration)->isSAT();
+                });
+        if (invalid != configurations.end()) {
+            std::cerr << "Warning: skipping " << (configurations.end() - invalid)
+                      << " configurations violating the feature model" << std::endl;
+            configurations.erase(invalid, configurations.end());
+        }
+    }
+
+    // the condition of each product, to annotate its output tuples
+    std::vector<const PresenceCondition*> productPCs;
+    for (const auto& configuration : configurations) {
+        productPCs.push_back(PresenceCondition::fromConfiguration(configuration));
+    }
+
+#ifdef _OPENMP
+    if (Global::config().has("jobs")) {
+        int numThreads = std::stoi(Global::config().get("jobs"));
+        if (numThreads > 0) {
+            omp_set_num_threads(numThreads);
+        }
+    }
+#endif
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t i = 0; i < configurations.size(); i++) {
+        Interpreter interpreter(translationUnit);
+        interpreter.setConfiguration(configurations[i]);
+        interpreter.setStoreHandler([&, i](const RamStore& store, const InterpreterRelation& relation) {
+            collect(store, relation, productPCs[i]);
+        });
+        interpreter.executeMain();
+    }
+
+    write();
+}
+
+void ProductEvaluator::collect(
+        const RamStore& store, const InterpreterRelation& relation, const PresenceCondition* pc) {
+    auto lease = resultLock.acquire();
+    (void)lease;
+
+    const std::string& name = store.getRelation().getName();
+    auto& result = results[name];
+    if (!result) {
+        stores.push_back(&store);
+        result = std::make_unique<InterpreterRelation>(relation.getArity(), false);
+    }
+
+    // duplicates of other products disjoin the conditions of their products
+    size_t arity = relation.getArity();
+    std::vector<RamDomain> tuple(arity + 1);
+    for (const RamDomain* cur : relation) {
+        std::copy(cur, cur + arity, tuple.begin());
+        tuple[arity] = relation.getPC(cur)->conjoin(pc)->getId();
+        result->insert(tuple.data());
+    }
+}
+
+void ProductEvaluator::write() {
+    for (const RamStore* store : stores) {
+        for (IODirectives ioDirectives : store->getIODirectives()) {
+            try {
+                auto writer = IOSystem::getInstance().getWriter(store->getRelation().getSymbolMask(),
+                        translationUnit.getSymbolTable(), translationUnit.getFeatSymbolTable(), ioDirectives,
+                        Global::config().has("provenance"));
+                // the merged conditions disjoin one full configuration per product
+                writer->setMinimalConditions(true);
+                writer->writeAll(*results[store->getRelation().getName()]);
+            } catch (std::exception& e) {
+                std::cerr << e.what();
+                exit(1);
+            }
+        }
+    }
+}
+
+bool ProductEvaluator::isPreferable(size_t features, double products, size_t threads) {
+    return products <= 2.0 * std::max<size_t>(threads, 1) || products < features;
+}
+
+std::vector<ProductEvaluator::Configuration> ProductEvaluator::readConfigurations(const std::string& fileName) {
+    std::ifstream in(fileName);
+    if (!in.is_open()) {
+        throw std::invalid_argument("Cannot open configuration file " + fileName);
+    }
+
+    // features are resolved against the known ones, a misspelled feature is an error
+    std::vector<Configuration> configurations;
+    std::string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[0] == '#') {
+            continue;
+        }
+        std::istringstream words(line);
+        std::vector<std::string> selection;
+        std::string feature;
+        while (words >> feature) {
+            selection.push_back(feature);
+        }
+        configurations.push_back(PresenceCondition::toConfiguration(selection));
+    }
+    return configurations;
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,108 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProductEvaluator.h
+ *
+ * Declares the evaluation of a RAM program per configuration, as an
+ * alternative to lifted evaluation for small configuration spaces.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "InterpreterRelation.h"
+#include "ParallelUtils.h"
+#include "PresenceCondition.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+class RamStore;
+class RamTranslationUnit;
+
+/**
+ * Evaluates a RAM translation unit once per configuration instead of lifted.
+ *
+ * Each product is interpreted in its own thread, sharing the translation unit, with
+ * the presence conditions of all facts evaluated to true or false in its configuration.
+ * The stored relations of all products are merged, annotating each tuple with the
+ * disjunction of the configurations deriving it, and written once all products have
+ * been evaluated.
+ */
+class ProductEvaluator {
+public:
+    using Configuration = PresenceCondition::Configuration;
+
+    /** The maximal number of configurations that are enumerated */
+    static const size_t MAX_PRODUCTS = 1 << 16;
+
+    /**
+     * @param featureModel the feature model all configurations have to satisfy, or null if
+     *        every configuration is valid
+     */
+    ProductEvaluator(RamTranslationUnit& translationUnit, std::vector<Configuration> configurations,
+            const PresenceCondition* featureModel)
+            : translationUnit(translationUnit), configurations(std::move(configurations)),
+              featureModel(featureModel) {}
+
+    /** Evaluate all products and write the merged output relations */
+    void execute();
+
+    /**
+     * Decides whether the evaluation of each configuration is expected to be faster than
+     * lifted evaluation. This is the case if there are few enough configurations to
+     * evaluate them in at most two rounds of parallel products, or if there are fewer
+     * configurations than features, such that the BDDs of lifted evaluation would mostly
+     * encode the feature model.
+     *
+     * @param features the number of features
+     * @param products the number of configurations satisfying the feature model
+     * @param threads the number of threads available for evaluating products
+     */
+    static bool isPreferable(size_t features, double products, size_t threads);
+
+    /**
+     * Reads a list of configurations, one per line listing the names of its selected
+     * features; lines starting with # are ignored.
+     *
+     * @throws std::invalid_argument if the file cannot be read or lists an unknown feature
+     */
+    static std::vector<Configuration> readConfigurations(const std::string& fileName);
+
+private:
+    RamTranslationUnit& translationUnit;
+
+    /** The configurations to be evaluated */
+    std::vector<Configuration> configurations;
+
+    /** The feature model, or null if every configuration is valid */
+    const PresenceCondition* featureModel;
+
+    /** The stores of the program, in the order of their first execution */
+    std::vector<const RamStore*> stores;
+
+    /** The merged stored relations, by name */
+    std::map<std::string, std::unique_ptr<InterpreterRelation>> results;
+
+    /** Lock for merging stored relations */
+    Lock resultLock;
+
+    /** Merge a stored relation of the product of the given presence condition */
+    void collect(const RamStore& store, const InterpreterRelation& relation, const PresenceCondition* pc);
+
+    /** Write the merged relations, with the conditions of their tuples minimised */
+    void write();
+};
+
+}  // end of namespace souffle
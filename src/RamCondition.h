@@ -73,6 +73,16 @@ public:
         return *rhs;
     }
 
+    /** Take left-hand side of conjunction */
+    std::unique_ptr<RamCondition> takeLHS() {
+        return std::move(lhs);
+    }
+
+    /** Take right-hand side of conjunction */
+    std::unique_ptr<RamCondition> takeRHS() {
+        return std::move(rhs);
+    }
+
     /** Print */
     void print(std::ostream& os) const override {
         lhs->print(os);
@@ -199,8 +209,8 @@ protected:
     bool equal(const RamNode& node) const override {
         assert(nullptr != dynamic_cast<const RamBinaryRelation*>(&node));
         const auto& other = static_cast<const RamBinaryRelation&>(node);
-        return getOperator() == other.getOperator() && getLHS() == other.getLHS() &&
-               getRHS() == other.getRHS();
+        return getOperator() == other.getOperator() && *getLHS() == *other.getLHS() &&
+               *getRHS() == *other.getRHS();
     }
 };
 
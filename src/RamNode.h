@@ -53,6 +53,7 @@ enum RamNodeType {
     RN_Lookup,
     RN_Scan,
     RN_Aggregate,
+    RN_Branch,
 
     // statements
     RN_Create,
@@ -64,6 +65,7 @@ enum RamNodeType {
     RN_Drop,
     RN_PrintSize,
     RN_LogSize,
+    RN_LogStats,
     RN_Return,
 
     RN_Merge,
@@ -86,6 +88,8 @@ enum RamNodeType {
     RN_Recv,
     RN_Notify,
     RN_Wait,
+    RN_Exchange,
+    RN_Partition,
 #endif
 
 };
@@ -283,6 +283,30 @@ void RamProject::addCondition(std::unique_ptr<RamCondition> c, const RamOperatio
     }
 }
 
+/*
+ * Class Branch
+ */
+
+/* add condition */
+void RamBranch::addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) {
+    assert(!branches.empty() && c->getLevel() >= level);
+
+    // every nested operation is guarded by its own copy of the condition
+    for (size_t i = 0; i + 1 < branches.size(); i++) {
+        branches[i]->addCondition(std::unique_ptr<RamCondition>(c->clone()), root);
+    }
+    branches.back()->addCondition(std::move(c), root);
+}
+
+/* print branch */
+void RamBranch::print(std::ostream& os, int tabpos) const {
+    os << times('\t', tabpos) << "BRANCH\n";
+    for (const auto& cur : branches) {
+        cur->print(os, tabpos + 1);
+        os << "\n";
+    }
+}
+
 /* print return */
 void RamReturn::print(std::ostream& os, int tabpos) const {
     const std::string tabs(tabpos, '\t');
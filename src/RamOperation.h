@@ -23,6 +23,7 @@
 #include "RamValue.h"
 #include "PresenceCondition.h"
 #include "Util.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <iosfwd>
@@ -82,6 +83,11 @@ public:
         return condition.get();
     }
 
+    /** Take condition */
+    std::unique_ptr<RamCondition> takeCondition() {
+        return std::move(condition);
+    }
+
     /** Obtain list of child nodes */
     std::vector<const RamNode*> getChildNodes() const override {
         if (!condition) {
@@ -139,6 +145,17 @@ public:
         return *nestedOperation;
     }
 
+    /** take nested operation */
+    std::unique_ptr<RamOperation> takeNestedOperation() {
+        return std::move(nestedOperation);
+    }
+
+    /** set nested operation */
+    void setNestedOperation(std::unique_ptr<RamOperation> nested) {
+        assert(nested && nested->getLevel() == level + 1);
+        nestedOperation = std::move(nested);
+    }
+
     /** get profile text */
     const std::string& getProfileText() const {
         return profileText;
@@ -165,8 +182,6 @@ public:
         nestedOperation = map(std::move(nestedOperation));
     }
 
-    const PresenceCondition* pc = nullptr;
-
 protected:
     /** Check equality */
     bool equal(const RamNode& node) const override {
@@ -545,6 +560,82 @@ protected:
     }
 };
 
+/**
+ * Branching of a loop nest
+ *
+ * Applies each of the nested operations in turn to the tuples bound by the
+ * enclosing searches, such that several rules sharing their outer scans can
+ * be evaluated in a single loop nest.
+ */
+class RamBranch : public RamOperation {
+protected:
+    /** Nested operations */
+    std::vector<std::unique_ptr<RamOperation>> branches;
+
+public:
+    RamBranch(size_t level) : RamOperation(RN_Branch, level) {}
+
+    /** Add nested operation */
+    void addBranch(std::unique_ptr<RamOperation> op) {
+        assert(op->getLevel() == level);
+        branches.push_back(std::move(op));
+    }
+
+    /** Get nested operations */
+    std::vector<RamOperation*> getBranches() const {
+        return toPtrVector(branches);
+    }
+
+    /** Add condition to each of the nested operations */
+    void addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) override;
+
+    /** Get depth */
+    size_t getDepth() const override {
+        size_t depth = 1;
+        for (const auto& cur : branches) {
+            depth = std::max(depth, cur->getDepth());
+        }
+        return depth;
+    }
+
+    /** Print */
+    void print(std::ostream& os, int tabpos) const override;
+
+    /** Obtain list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        auto res = RamOperation::getChildNodes();
+        for (const auto& cur : branches) {
+            res.push_back(cur.get());
+        }
+        return res;
+    }
+
+    /** Create clone */
+    RamBranch* clone() const override {
+        auto* res = new RamBranch(level);
+        for (auto& cur : branches) {
+            res->branches.push_back(std::unique_ptr<RamOperation>(cur->clone()));
+        }
+        return res;
+    }
+
+    /** Apply mapper */
+    void apply(const RamNodeMapper& map) override {
+        RamOperation::apply(map);
+        for (auto& cur : branches) {
+            cur = map(std::move(cur));
+        }
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamBranch*>(&node));
+        const auto& other = static_cast<const RamBranch&>(node);
+        return RamOperation::equal(other) && equal_targets(branches, other.branches);
+    }
+};
+
 /** A statement for returning from a ram subroutine */
 class RamReturn : public RamOperation {
 protected:
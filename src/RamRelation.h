@@ -65,6 +65,7 @@ protected:
     bool hashset = false;  // hash set data-structure
     bool brie = false;     // brie data-structure
     bool eqrel = false;    // equivalence relation
+    bool bdd = false;      // binary decision diagram
 
     bool istemp = false;  // Temporary relation for semi-naive evaluation
 
@@ -81,12 +82,13 @@ public:
             std::vector<std::string> attributeTypeQualifiers = {}, SymbolMask mask = SymbolMask(0),
             const bool input = false, const bool computed = false, const bool output = false,
             const bool btree = false, const bool rbtset = false, const bool hashset = false,
-            const bool brie = false, const bool eqrel = false, const bool istemp = false)
+            const bool brie = false, const bool eqrel = false, const bool bdd = false,
+            const bool istemp = false)
             : RamNode(RN_Relation), name(std::move(name)), arity(arity),
               attributeNames(std::move(attributeNames)),
               attributeTypeQualifiers(std::move(attributeTypeQualifiers)), mask(std::move(mask)),
               input(input), output(output), computed(computed), btree(btree), rbtset(rbtset),
-              hashset(hashset), brie(brie), eqrel(eqrel), istemp(istemp) {
+              hashset(hashset), brie(brie), eqrel(eqrel), bdd(bdd), istemp(istemp) {
         assert(this->attributeNames.size() == arity || this->attributeNames.empty());
         assert(this->attributeTypeQualifiers.size() == arity || this->attributeTypeQualifiers.empty());
     }
@@ -145,6 +147,10 @@ public:
         return eqrel;
     }
 
+    const bool isBdd() const {
+        return bdd;
+    }
+
     // data-structures that can server various searches
     const bool isCoverable() const {
         return !isHashset();
@@ -177,6 +183,7 @@ public:
         if (isHashset()) out << " hashset";
         if (isBrie()) out << " brie";
         if (isEqRel()) out << " eqrel";
+        if (isBdd()) out << " bdd";
     }
 
     /** Obtain list of child nodes */
@@ -187,7 +194,7 @@ public:
     /** Create clone */
     RamRelation* clone() const override {
         RamRelation* res = new RamRelation(name, arity, attributeNames, attributeTypeQualifiers, mask, input,
-                computed, output, btree, rbtset, hashset, brie, eqrel, istemp);
+                computed, output, btree, rbtset, hashset, brie, eqrel, bdd, istemp);
         return res;
     }
 
@@ -204,7 +211,8 @@ protected:
                isInput() == other.isInput() && isOutput() == other.isOutput() &&
                isComputed() == other.isComputed() && isBTree() == other.isBTree() &&
                isRbtset() == other.isRbtset() && isHashset() == other.isHashset() &&
-               isBrie() == other.isBrie() && isEqRel() == other.isEqRel() && isTemp() == other.isTemp();
+               isBrie() == other.isBrie() && isEqRel() == other.isEqRel() && isBdd() == other.isBdd() &&
+               isTemp() == other.isTemp();
     }
 };
 
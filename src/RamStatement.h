@@ -430,6 +430,12 @@ public:
         return *operation;
     }
 
+    /** Get RAM operation */
+    RamOperation& getOperation() {
+        assert(operation);
+        return *operation;
+    }
+
     /** Pretty print */
     void print(std::ostream& os, int tabpos) const override {
         os << std::string(tabpos, '\t');
@@ -500,6 +506,13 @@ public:
         return toPtrVector(statements);
     }
 
+    /** Remove all statements from the ordered list */
+    std::vector<std::unique_ptr<RamStatement>> takeStatements() {
+        std::vector<std::unique_ptr<RamStatement>> res;
+        res.swap(statements);
+        return res;
+    }
+
     /** TODO (#541): what's that for ?? */
     template <typename T>
     void moveSubprograms(std::vector<std::unique_ptr<T>>& destination) {
@@ -820,12 +833,23 @@ public:
         return message;
     }
 
+    /** Set debugging message */
+    void setMessage(std::string msg) {
+        message = std::move(msg);
+    }
+
     /** Get debugging statement */
     const RamStatement& getStatement() const {
         assert(statement);
         return *statement;
     }
 
+    /** Get debugging statement */
+    RamStatement& getStatement() {
+        assert(statement);
+        return *statement;
+    }
+
     /** Pretty print */
     void print(std::ostream& os, int tabpos) const override {
         os << std::string(tabpos, '\t');
@@ -962,6 +986,49 @@ protected:
     }
 };
 
+/**
+ * Log relation statistics
+ *
+ * Records the statistics of a relation (see RelationStats) in the profile log.
+ */
+class RamLogStats : public RamRelationStatement {
+protected:
+    /** logging message */
+    std::string message;
+
+public:
+    RamLogStats(std::unique_ptr<RamRelation> relation, std::string message)
+            : RamRelationStatement(RN_LogStats, std::move(relation)), message(std::move(message)) {}
+
+    /** Get logging message */
+    const std::string& getMessage() const {
+        return message;
+    }
+
+    /** Pretty print */
+    void print(std::ostream& os, int tabpos) const override {
+        os << std::string(tabpos, '\t');
+        os << "LOGSTATS " << getRelation().getName();
+        os << " TEXT "
+           << "\"" << stringify(message) << "\"";
+    }
+
+    /** Create clone */
+    RamLogStats* clone() const override {
+        RamLogStats* res = new RamLogStats(std::unique_ptr<RamRelation>(relation->clone()), message);
+        return res;
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamLogStats*>(&node));
+        const auto& other = static_cast<const RamLogStats&>(node);
+        RamRelationStatement::equal(other);
+        return getMessage() == other.getMessage();
+    }
+};
+
 /**
  * Print relation size and a print message
  *
@@ -1151,6 +1218,63 @@ protected:
     }
 };
 
+/**
+ * Exchanges the tuples of a relation among the processes evaluating a partitioned stratum, such
+ * that all of them hold the tuples derived by any of them
+ */
+class RamExchange : public RamRelationStatement {
+public:
+    RamExchange(std::unique_ptr<RamRelation> r) : RamRelationStatement(RN_Exchange, std::move(r)) {}
+
+    /** Pretty print */
+    void print(std::ostream& os, int tabpos) const override {
+        os << std::string(tabpos, '\t');
+        os << "EXCHANGE DATA FOR " << getRelation().getName() << " WITHIN STRATUM";
+    };
+
+    /** Create clone */
+    RamExchange* clone() const override {
+        return new RamExchange(std::unique_ptr<RamRelation>(relation->clone()));
+    }
+};
+
+/**
+ * Restricts a relation to the tuples owned by the process among the processes evaluating a
+ * partitioned stratum, by the hash of the given column
+ */
+class RamPartition : public RamRelationStatement {
+private:
+    const size_t column;
+
+public:
+    RamPartition(std::unique_ptr<RamRelation> r, const size_t c)
+            : RamRelationStatement(RN_Partition, std::move(r)), column(c) {}
+
+    /** Get the column whose hash determines the owner of a tuple */
+    size_t getColumn() const {
+        return column;
+    }
+
+    /** Pretty print */
+    void print(std::ostream& os, int tabpos) const override {
+        os << std::string(tabpos, '\t');
+        os << "PARTITION " << getRelation().getName() << " ON COLUMN " << column;
+    };
+
+    /** Create clone */
+    RamPartition* clone() const override {
+        return new RamPartition(std::unique_ptr<RamRelation>(relation->clone()), column);
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamPartition*>(&node));
+        const auto& other = static_cast<const RamPartition&>(node);
+        return RamRelationStatement::equal(other) && column == other.column;
+    }
+};
+
 #endif
 
 }  // end of namespace souffle
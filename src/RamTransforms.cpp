@@ -0,0 +1,389 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RamTransforms.cpp
+ *
+ * Implementation of RAM transformation passes.
+ *
+ ***********************************************************************/
+
+#include "RamTransforms.h"
+#include "DebugReport.h"
+#include "RamCondition.h"
+#include "RamNode.h"
+#include "RamOperation.h"
+#include "RamProgram.h"
+#include "RamRelation.h"
+#include "RamStatement.h"
+#include "RamVisitor.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace souffle {
+
+namespace {
+
+/** A function rewriting a RAM node, used to traverse the program with node mappers */
+using RamRewriter = std::function<std::unique_ptr<RamNode>(std::unique_ptr<RamNode>)>;
+
+/** A node mapper applying a rewriting function */
+class RamRewriteMapper : public RamNodeMapper {
+    const RamRewriter& rewriter;
+
+public:
+    RamRewriteMapper(const RamRewriter& rewriter) : rewriter(rewriter) {}
+
+    std::unique_ptr<RamNode> operator()(std::unique_ptr<RamNode> node) const override {
+        return rewriter(std::move(node));
+    }
+};
+
+/**
+ * Applies the given function to the operation of every insert statement of the
+ * program, including those of subroutines.
+ *
+ * @return whether the function modified any of the operations
+ */
+bool transformOperations(RamProgram& program, const std::function<bool(RamOperation&)>& fun) {
+    bool changed = false;
+    RamRewriter rewriter = [&](std::unique_ptr<RamNode> node) -> std::unique_ptr<RamNode> {
+        if (auto* insert = dynamic_cast<RamInsert*>(node.get())) {
+            changed = fun(insert->getOperation()) || changed;
+        } else if (dynamic_cast<RamStatement*>(node.get())) {
+            node->apply(RamRewriteMapper(rewriter));
+        }
+        return node;
+    };
+    program.apply(RamRewriteMapper(rewriter));
+    return changed;
+}
+
+/** Applies the given function to the operations nested directly within the given operation */
+bool transformNested(RamOperation& op, const std::function<bool(RamOperation&)>& fun) {
+    bool changed = false;
+    if (auto* search = dynamic_cast<RamSearch*>(&op)) {
+        changed = fun(*search->getNestedOperation());
+    } else if (auto* branch = dynamic_cast<RamBranch*>(&op)) {
+        for (RamOperation* cur : branch->getBranches()) {
+            changed = fun(*cur) || changed;
+        }
+    }
+    return changed;
+}
+
+/** Splits the given condition into the list of its conjuncts */
+std::vector<std::unique_ptr<RamCondition>> toConjunctionList(std::unique_ptr<RamCondition> condition) {
+    std::vector<std::unique_ptr<RamCondition>> res;
+    if (!condition) {
+        return res;
+    }
+    if (auto* conjunction = dynamic_cast<RamAnd*>(condition.get())) {
+        for (auto& cur : toConjunctionList(conjunction->takeLHS())) {
+            res.push_back(std::move(cur));
+        }
+        for (auto& cur : toConjunctionList(conjunction->takeRHS())) {
+            res.push_back(std::move(cur));
+        }
+    } else {
+        res.push_back(std::move(condition));
+    }
+    return res;
+}
+
+/**
+ * Conjoins the given condition with the condition of the given operation,
+ * without pushing it into nested operations or index patterns.
+ */
+void conjoinCondition(RamOperation& op, std::unique_ptr<RamCondition> condition) {
+    if (dynamic_cast<RamProject*>(&op)) {
+        // projections accept conditions on the tuples of any enclosing level
+        op.addCondition(std::move(condition));
+    } else {
+        op.RamOperation::addCondition(std::move(condition), op);
+    }
+}
+
+/**
+ * Hoists the conjuncts of the conditions within the given operation.
+ *
+ * @param op the operation to be processed
+ * @param enclosing the searches enclosing the operation, indexed by their level
+ */
+bool hoistConditions(RamOperation& op, std::vector<RamOperation*>& enclosing) {
+    bool changed = false;
+    for (auto& cur : toConjunctionList(op.takeCondition())) {
+        size_t level = cur->getLevel();
+        if (level < enclosing.size()) {
+            conjoinCondition(*enclosing[level], std::move(cur));
+            changed = true;
+        } else {
+            conjoinCondition(op, std::move(cur));
+        }
+    }
+
+    if (dynamic_cast<RamSearch*>(&op)) {
+        assert(op.getLevel() == enclosing.size() && "levels of loop nest are not consecutive");
+        enclosing.push_back(&op);
+    }
+    changed = transformNested(op, [&](RamOperation& nested) { return hoistConditions(nested, enclosing); }) ||
+              changed;
+    if (dynamic_cast<RamSearch*>(&op)) {
+        enclosing.pop_back();
+    }
+    return changed;
+}
+
+/** Converts the equality constraints of the scans within the given operation to range patterns */
+bool createIndices(RamOperation& op, const RamOperation& root) {
+    bool changed = false;
+    if (auto* scan = dynamic_cast<RamScan*>(&op)) {
+        SearchColumns keys = scan->getRangeQueryColumns();
+        for (auto& cur : toConjunctionList(scan->takeCondition())) {
+            if (cur->getLevel() == scan->getLevel()) {
+                // narrows down the scan if possible
+                scan->addCondition(std::move(cur), root);
+            } else {
+                conjoinCondition(*scan, std::move(cur));
+            }
+        }
+        changed = scan->getRangeQueryColumns() != keys;
+    }
+    return transformNested(op, [&](RamOperation& nested) { return createIndices(nested, root); }) || changed;
+}
+
+/** Obtains the names of the relations any statement of the program writes to */
+std::set<std::string> getWrittenRelations(const RamProgram& program) {
+    std::set<std::string> res;
+    visitDepthFirst(program, [&](const RamProject& project) { res.insert(project.getRelation().getName()); });
+    visitDepthFirst(program, [&](const RamFact& fact) { res.insert(fact.getRelation().getName()); });
+    visitDepthFirst(program, [&](const RamLoad& load) { res.insert(load.getRelation().getName()); });
+    visitDepthFirst(
+            program, [&](const RamMerge& merge) { res.insert(merge.getTargetRelation().getName()); });
+    visitDepthFirst(program, [&](const RamSwap& swap) {
+        res.insert(swap.getFirstRelation().getName());
+        res.insert(swap.getSecondRelation().getName());
+    });
+#ifdef USE_MPI
+    visitDepthFirst(program, [&](const RamRecv& recv) { res.insert(recv.getRelation().getName()); });
+#endif
+    return res;
+}
+
+/** Removes the trivial existence checks from the conditions within the given operation */
+bool removeRedundantExistenceChecks(RamOperation& op, const std::set<std::string>& written) {
+    bool changed = false;
+    std::vector<std::unique_ptr<RamCondition>> conjuncts;
+    for (auto& cur : toConjunctionList(op.takeCondition())) {
+        // a negation of a relation without tuples always holds
+        if (const auto* negation = dynamic_cast<const RamNotExists*>(cur.get())) {
+            if (written.find(negation->getRelation().getName()) == written.end()) {
+                changed = true;
+                continue;
+            }
+        }
+        // a repeated conjunct does not restrict the condition any further
+        if (std::any_of(conjuncts.begin(), conjuncts.end(),
+                    [&](const std::unique_ptr<RamCondition>& other) { return *other == *cur; })) {
+            changed = true;
+            continue;
+        }
+        conjuncts.push_back(std::move(cur));
+    }
+    for (auto& cur : conjuncts) {
+        conjoinCondition(op, std::move(cur));
+    }
+    return transformNested(op, [&](RamOperation& nested) {
+        return removeRedundantExistenceChecks(nested, written);
+    }) || changed;
+}
+
+/** Obtains the insert statement of a rule, possibly wrapped into debug information */
+RamInsert* getInsert(RamStatement& stmt) {
+    if (auto* debugInfo = dynamic_cast<RamDebugInfo*>(&stmt)) {
+        return dynamic_cast<RamInsert*>(&debugInfo->getStatement());
+    }
+    return dynamic_cast<RamInsert*>(&stmt);
+}
+
+/** Collects the names of the relations read and written by the given operation */
+void getAccessedRelations(const RamOperation& op, std::set<std::string>& reads, std::set<std::string>& writes) {
+    visitDepthFirst(op, [&](const RamScan& scan) { reads.insert(scan.getRelation().getName()); });
+    visitDepthFirst(
+            op, [&](const RamAggregate& aggregate) { reads.insert(aggregate.getRelation().getName()); });
+    visitDepthFirst(op, [&](const RamNotExists& negation) { reads.insert(negation.getRelation().getName()); });
+    visitDepthFirst(op, [&](const RamProject& project) {
+        writes.insert(project.getRelation().getName());
+        if (project.hasFilter()) {
+            reads.insert(project.getFilter().getName());
+        }
+    });
+}
+
+/** Checks whether two scans bind the same tuples in the same order */
+bool isSameScan(const RamScan& a, const RamScan& b) {
+    if (a.getRelation() != b.getRelation() || a.isPureExistenceCheck() != b.isPureExistenceCheck() ||
+            a.getRangeQueryColumns() != b.getRangeQueryColumns() ||
+            a.getProfileText() != b.getProfileText()) {
+        return false;
+    }
+    if (a.getCondition() == nullptr || b.getCondition() == nullptr) {
+        if (a.getCondition() != b.getCondition()) {
+            return false;
+        }
+    } else if (*a.getCondition() != *b.getCondition()) {
+        return false;
+    }
+    auto patternA = a.getRangePattern();
+    auto patternB = b.getRangePattern();
+    for (size_t i = 0; i < patternA.size(); i++) {
+        if (patternA[i] == nullptr || patternB[i] == nullptr) {
+            if (patternA[i] != patternB[i]) {
+                return false;
+            }
+        } else if (*patternA[i] != *patternB[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Merges the rule of the second statement into the loop nest of the first
+ * statement, if both are inserts sharing their outermost scan. The debug
+ * information of both rules is kept, wrapping the first statement if needed.
+ *
+ * @return whether the second statement has been merged
+ */
+bool mergeInserts(std::unique_ptr<RamStatement>& first, RamStatement& second) {
+    RamInsert* firstInsert = getInsert(*first);
+    RamInsert* secondInsert = getInsert(second);
+    if (firstInsert == nullptr || secondInsert == nullptr) {
+        return false;
+    }
+    auto* firstScan = dynamic_cast<RamScan*>(&firstInsert->getOperation());
+    auto* secondScan = dynamic_cast<RamScan*>(&secondInsert->getOperation());
+    if (firstScan == nullptr || secondScan == nullptr || !isSameScan(*firstScan, *secondScan)) {
+        return false;
+    }
+
+    // interleaving the two loop nests must not change the tuples either of them sees
+    std::set<std::string> firstReads, firstWrites, secondReads, secondWrites;
+    getAccessedRelations(*firstScan, firstReads, firstWrites);
+    getAccessedRelations(*secondScan, secondReads, secondWrites);
+    auto intersects = [](const std::set<std::string>& a, const std::set<std::string>& b) {
+        return std::any_of(a.begin(), a.end(), [&](const std::string& name) { return b.count(name) != 0; });
+    };
+    if (intersects(firstWrites, secondReads) || intersects(secondWrites, firstReads)) {
+        return false;
+    }
+
+    // branch into the nested operations of both inserts
+    auto* branch = dynamic_cast<RamBranch*>(firstScan->getNestedOperation());
+    if (branch == nullptr) {
+        std::unique_ptr<RamOperation> nested = firstScan->takeNestedOperation();
+        auto newBranch = std::make_unique<RamBranch>(nested->getLevel());
+        newBranch->addBranch(std::move(nested));
+        branch = newBranch.get();
+        firstScan->setNestedOperation(std::move(newBranch));
+    }
+    branch->addBranch(secondScan->takeNestedOperation());
+
+    if (auto* secondInfo = dynamic_cast<RamDebugInfo*>(&second)) {
+        if (auto* firstInfo = dynamic_cast<RamDebugInfo*>(first.get())) {
+            firstInfo->setMessage(firstInfo->getMessage() + "\n" + secondInfo->getMessage());
+        } else {
+            first = std::make_unique<RamDebugInfo>(std::move(first), secondInfo->getMessage());
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool HoistConditionsTransformer::hoistConditions(RamProgram& program) {
+    return transformOperations(program, [](RamOperation& op) {
+        std::vector<RamOperation*> enclosing;
+        return ::souffle::hoistConditions(op, enclosing);
+    });
+}
+
+bool CreateIndicesTransformer::createIndices(RamProgram& program) {
+    return transformOperations(program, [](RamOperation& op) { return ::souffle::createIndices(op, op); });
+}
+
+bool RemoveRedundantExistenceChecksTransformer::removeRedundantExistenceChecks(RamProgram& program) {
+    std::set<std::string> written = getWrittenRelations(program);
+    return transformOperations(program, [&](RamOperation& op) {
+        return ::souffle::removeRedundantExistenceChecks(op, written);
+    });
+}
+
+bool MergeInsertsTransformer::mergeInserts(RamProgram& program) {
+    bool changed = false;
+    RamRewriter rewriter = [&](std::unique_ptr<RamNode> node) -> std::unique_ptr<RamNode> {
+        if (!dynamic_cast<RamStatement*>(node.get())) {
+            return node;
+        }
+        node->apply(RamRewriteMapper(rewriter));
+        if (auto* sequence = dynamic_cast<RamSequence*>(node.get())) {
+            std::vector<std::unique_ptr<RamStatement>> merged;
+            for (auto& cur : sequence->takeStatements()) {
+                if (!merged.empty() && ::souffle::mergeInserts(merged.back(), *cur)) {
+                    changed = true;
+                } else {
+                    merged.push_back(std::move(cur));
+                }
+            }
+            for (auto& cur : merged) {
+                sequence->add(std::move(cur));
+            }
+        }
+        return node;
+    };
+    program.apply(RamRewriteMapper(rewriter));
+    return changed;
+}
+
+bool RamPipelineTransformer::transform(RamTranslationUnit& translationUnit) {
+    bool changed = false;
+    for (auto& transformer : pipeline) {
+        auto start = std::chrono::high_resolution_clock::now();
+        bool modified = transformer->apply(translationUnit);
+        auto end = std::chrono::high_resolution_clock::now();
+        double runtime = std::chrono::duration<double>(end - start).count();
+
+        if (verbose) {
+            std::cout << transformer->getName() << " time: " << runtime << "sec" << std::endl;
+        }
+
+        if (debugReport) {
+            std::string name = transformer->getName();
+            std::string runtimeStr = "(" + std::to_string(runtime) + "s)";
+            if (modified) {
+                std::stringstream ramProgStr;
+                ramProgStr << *translationUnit.getProgram();
+                translationUnit.getDebugReport().addSection(DebugReporter::getCodeSection(
+                        name, "After " + name + " " + runtimeStr, ramProgStr.str()));
+            } else {
+                translationUnit.getDebugReport().addSection(DebugReportSection(
+                        name, "After " + name + " " + runtimeStr + " (unchanged)", {}, ""));
+            }
+        }
+
+        changed = modified || changed;
+    }
+    return changed;
+}
+
+}  // end of namespace souffle
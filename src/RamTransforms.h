@@ -0,0 +1,166 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RamTransforms.h
+ *
+ * Defines RAM transformation passes.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTransformer.h"
+#include "RamTranslationUnit.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+class RamProgram;
+
+/**
+ * Transformation pass moving each conjunct of a condition to the outermost
+ * search of the loop nest binding all of the tuples it refers to, such that
+ * it is no longer re-evaluated for every tuple of the inner scans.
+ */
+class HoistConditionsTransformer : public RamTransformer {
+private:
+    bool transform(RamTranslationUnit& translationUnit) override {
+        return hoistConditions(*translationUnit.getProgram());
+    }
+
+public:
+    std::string getName() const override {
+        return "HoistConditionsTransformer";
+    }
+
+    /**
+     * Hoists the conditions of all loop nests of the given program.
+     *
+     * @param program the program to be processed
+     * @return whether the program was modified
+     */
+    static bool hoistConditions(RamProgram& program);
+};
+
+/**
+ * Transformation pass turning the equality constraints of a scan on its own
+ * attributes into the range pattern of an index lookup.
+ */
+class CreateIndicesTransformer : public RamTransformer {
+private:
+    bool transform(RamTranslationUnit& translationUnit) override {
+        return createIndices(*translationUnit.getProgram());
+    }
+
+public:
+    std::string getName() const override {
+        return "CreateIndicesTransformer";
+    }
+
+    /**
+     * Converts filter conditions of the scans of the given program to range patterns.
+     *
+     * @param program the program to be processed
+     * @return whether the program was modified
+     */
+    static bool createIndices(RamProgram& program);
+};
+
+/**
+ * Transformation pass removing existence checks which hold trivially, i.e.,
+ * negations of relations no statement ever writes to and repeated conjuncts
+ * of a condition.
+ */
+class RemoveRedundantExistenceChecksTransformer : public RamTransformer {
+private:
+    bool transform(RamTranslationUnit& translationUnit) override {
+        return removeRedundantExistenceChecks(*translationUnit.getProgram());
+    }
+
+public:
+    std::string getName() const override {
+        return "RemoveRedundantExistenceChecksTransformer";
+    }
+
+    /**
+     * Removes the trivial existence checks of the given program.
+     *
+     * @param program the program to be processed
+     * @return whether the program was modified
+     */
+    static bool removeRedundantExistenceChecks(RamProgram& program);
+};
+
+/**
+ * Transformation pass merging consecutive inserts whose outermost scans are
+ * identical into a single loop nest branching into the nested operations of
+ * each insert. Inserts are only merged if neither of them writes to a
+ * relation read by the other.
+ */
+class MergeInsertsTransformer : public RamTransformer {
+private:
+    bool transform(RamTranslationUnit& translationUnit) override {
+        return mergeInserts(*translationUnit.getProgram());
+    }
+
+public:
+    std::string getName() const override {
+        return "MergeInsertsTransformer";
+    }
+
+    /**
+     * Merges consecutive inserts sharing their outermost scan in the given program.
+     *
+     * @param program the program to be processed
+     * @return whether the program was modified
+     */
+    static bool mergeInserts(RamProgram& program);
+};
+
+/**
+ * Transformer that holds an arbitrary number of RAM transformations, applied
+ * in order. The runtime of each pass is reported in verbose mode and in the
+ * debug report.
+ */
+class RamPipelineTransformer : public RamTransformer {
+private:
+    std::vector<std::unique_ptr<RamTransformer>> pipeline;
+    bool debugReport = false;
+    bool verbose = false;
+    bool transform(RamTranslationUnit& translationUnit) override;
+
+public:
+    template <typename... Args>
+    RamPipelineTransformer(Args... args) {
+        std::unique_ptr<RamTransformer> tmp[] = {std::move(args)...};
+        for (auto& cur : tmp) {
+            pipeline.push_back(std::move(cur));
+        }
+    }
+
+    /* Enable the debug-report for all sub-transformations */
+    void setDebugReport() {
+        debugReport = true;
+    }
+
+    /* Enable high verbosity */
+    void setVerbosity(bool verbose) {
+        this->verbose = verbose;
+    }
+
+    std::string getName() const override {
+        return "RamPipelineTransformer";
+    }
+};
+
+}  // end of namespace souffle
@@ -72,10 +72,6 @@ public:
         return std::move(program);
     }
 
-    const RamProgram* getProgram() {
-        return program.get();
-    }
-
     const RamProgram& getP() const {
         return *program.get();
     }
@@ -100,6 +100,7 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Lookup);
             FORWARD(Scan);
             FORWARD(Aggregate);
+            FORWARD(Branch);
 
             // statements
             FORWARD(Create);
@@ -111,6 +112,7 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Drop);
             FORWARD(PrintSize);
             FORWARD(LogSize);
+            FORWARD(LogStats);
 
             FORWARD(Merge);
             FORWARD(Swap);
@@ -131,6 +133,8 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Recv);
             FORWARD(Notify);
             FORWARD(Wait);
+            FORWARD(Exchange);
+            FORWARD(Partition);
 #endif
 
 #undef FORWARD
@@ -163,6 +167,7 @@ protected:
     LINK(Drop, RelationStatement);
     LINK(PrintSize, RelationStatement);
     LINK(LogSize, RelationStatement);
+    LINK(LogStats, RelationStatement);
 
     LINK(RelationStatement, Statement);
 
@@ -186,6 +191,7 @@ protected:
     LINK(Aggregate, Search)
     LINK(Search, Operation)
     LINK(Return, Operation);
+    LINK(Branch, Operation);
 
     LINK(Operation, Node)
 
@@ -221,6 +227,8 @@ protected:
     LINK(Recv, RelationStatement);
     LINK(Notify, Statement);
     LINK(Wait, Statement);
+    LINK(Exchange, RelationStatement);
+    LINK(Partition, RelationStatement);
 #endif
 
 #undef LINK
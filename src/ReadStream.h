@@ -19,6 +19,7 @@
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 #include <memory>
+#include <vector>
 
 namespace souffle {
 
@@ -31,12 +32,14 @@ public:
             : symbolMask(symbolMask), symbolTable(symbolTable), featSymTable(fSymT), isProvenance(prov) {}
     template <typename T>
     void readAll(T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
-        while (const auto next = readNextTuple()) {
-            const RamDomain* ramDomain = next.get();
-            relation.insert(ramDomain);
-            recordCount++;
+        std::vector<std::unique_ptr<RamDomain[]>> batch;
+        while (readNextBatch(batch)) {
+            for (const auto& next : batch) {
+                const RamDomain* ramDomain = next.get();
+                relation.insert(ramDomain);
+                recordCount++;
+            }
+            batch.clear();
         }
     }
 
@@ -44,6 +47,19 @@ public:
 
 protected:
     virtual std::unique_ptr<RamDomain[]> readNextTuple() = 0;
+
+    /**
+     * Read the next batch of tuples; readers able to produce many tuples at once
+     * may override this. Returns false if no tuple was readable.
+     */
+    virtual bool readNextBatch(std::vector<std::unique_ptr<RamDomain[]>>& batch) {
+        auto next = readNextTuple();
+        if (!next) {
+            return false;
+        }
+        batch.push_back(std::move(next));
+        return true;
+    }
     const SymbolMask& symbolMask;
     SymbolTable& symbolTable;
     SymbolTable& featSymTable;
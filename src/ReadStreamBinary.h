@@ -0,0 +1,241 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamBinary.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "BinaryFormat.h"
+#include "IODirectives.h"
+#include "PresenceCondition.h"
+#include "RamTypes.h"
+#include "ReadStream.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * Reads a relation in the columnar binary format of BinaryFormat.h. The file
+ * is mapped into memory and the tuples are gathered from the mapped columns;
+ * only the symbols and presence conditions of the file are converted, once
+ * each.
+ */
+class ReadFileBinary : public ReadStream {
+public:
+    ReadFileBinary(const SymbolMask& symbolMask, SymbolTable& symbolTable, SymbolTable& featSymT,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : ReadStream(symbolMask, symbolTable, featSymT, provenance), fileName(getFileName(ioDirectives)) {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            if (ioDirectives.has("intermediate")) {
+                return;
+            }
+            throw std::invalid_argument("Cannot open fact file " + fileName + "\n");
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(binary::Header)) {
+            close(fd);
+            throw std::invalid_argument("Invalid binary fact file " + fileName + "\n");
+        }
+        size = status.st_size;
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::invalid_argument("Cannot map fact file " + fileName + "\n");
+        }
+        data = static_cast<const char*>(mapped);
+        header = reinterpret_cast<const binary::Header*>(data);
+        try {
+            checkHeader();
+            symbols = readSymbols();
+            pcs = readPresenceConditions();
+        } catch (...) {
+            munmap(const_cast<char*>(data), size);
+            throw;
+        }
+    }
+
+    ~ReadFileBinary() override {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+
+protected:
+    std::unique_ptr<RamDomain[]> readNextTuple() override {
+        if (!data || next >= header->tuples) {
+            return nullptr;
+        }
+        size_t arity = symbolMask.getArity();
+        std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(arity + 1);
+        for (size_t col = 0; col <= arity; col++) {
+            tuple[col] = convert(col, column(col)[next]);
+        }
+        if (tuple[arity] != PresenceCondition::makeTrue()->getId()) {
+            pcCount++;
+        }
+        next++;
+        return tuple;
+    }
+
+    bool readNextBatch(std::vector<std::unique_ptr<RamDomain[]>>& batch) override {
+        if (!data || next >= header->tuples) {
+            return false;
+        }
+        uint64_t end = std::min<uint64_t>(header->tuples, next + BATCH_SIZE);
+        batch.reserve(end - next);
+        while (next < end) {
+            batch.push_back(readNextTuple());
+        }
+        return true;
+    }
+
+private:
+    std::string getFileName(const IODirectives& ioDirectives) const {
+        if (ioDirectives.has("filename")) {
+            return ioDirectives.get("filename");
+        }
+        return ioDirectives.getRelationName() + ".facts";
+    }
+
+    void invalid(const std::string& reason) const {
+        throw std::invalid_argument("Invalid binary fact file " + fileName + ": " + reason + "\n");
+    }
+
+    void checkHeader() const {
+        if (std::memcmp(header->magic, binary::MAGIC, sizeof(binary::MAGIC)) != 0) {
+            invalid("not a binary relation");
+        }
+        if (header->version != binary::VERSION || header->domainSize != sizeof(RamDomain)) {
+            invalid("unsupported version or domain size");
+        }
+        if (header->arity != symbolMask.getArity()) {
+            invalid("expected " + std::to_string(symbolMask.getArity()) + " columns but found " +
+                    std::to_string(header->arity));
+        }
+        if (header->tuples > size / sizeof(RamDomain) ||
+                header->symbolOffset < binary::columnOffset(*header, header->arity + 1) ||
+                header->pcOffset < header->symbolOffset || header->pcOffset > size) {
+            invalid("truncated");
+        }
+    }
+
+    /** The values of a column, the presence condition column being the last one */
+    const RamDomain* column(size_t col) const {
+        return reinterpret_cast<const RamDomain*>(data + binary::columnOffset(*header, col));
+    }
+
+    /** Read the strings of the segment at the given offset */
+    std::vector<std::string> readSegment(uint64_t offset, uint64_t end) const {
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(data + offset);
+        uint64_t available = (end - offset) / sizeof(uint64_t);
+        if (available < 2 || words[0] > available - 2) {
+            invalid("truncated");
+        }
+        uint64_t count = words[0];
+        const uint64_t* offsets = words + 1;
+        const char* chars = reinterpret_cast<const char*>(offsets + count + 1);
+        if (offsets[count] > end - (chars - data)) {
+            invalid("truncated");
+        }
+        std::vector<std::string> strings;
+        strings.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            if (offsets[i] > offsets[i + 1]) {
+                invalid("corrupt segment");
+            }
+            strings.emplace_back(chars + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+        return strings;
+    }
+
+    /** Intern the symbols of the file */
+    std::vector<RamDomain> readSymbols() const {
+        return symbolTable.lookup(readSegment(header->symbolOffset, header->pcOffset));
+    }
+
+    /** Parse the presence conditions of the file */
+    std::vector<RamDomain> readPresenceConditions() const {
+        std::vector<RamDomain> ids;
+        for (const auto& text : readSegment(header->pcOffset, size)) {
+            const PresenceCondition* pc = PresenceCondition::parse(text, featSymTable);
+            if (!pc) {
+                invalid("invalid presence condition " + text);
+            }
+            ids.push_back(pc->getId());
+        }
+        return ids;
+    }
+
+    /** Convert a value of the file into a value of the program */
+    RamDomain convert(size_t col, RamDomain value) const {
+        if (col == symbolMask.getArity()) {
+            return lookup(pcs, value);
+        }
+        if (isProvenance && col + 2 >= symbolMask.getArity()) {
+            return 0;
+        }
+        return symbolMask.isSymbol(col) ? lookup(symbols, value) : value;
+    }
+
+    RamDomain lookup(const std::vector<RamDomain>& table, RamDomain number) const {
+        if (number < 0 || (size_t)number >= table.size()) {
+            invalid("reference out of range");
+        }
+        return table[number];
+    }
+
+    /** The number of tuples per batch */
+    static const uint64_t BATCH_SIZE = 1 << 12;
+
+    const std::string fileName;
+    const char* data = nullptr;
+    size_t size = 0;
+    const binary::Header* header = nullptr;
+
+    /** The symbols of the file, in this program */
+    std::vector<RamDomain> symbols;
+
+    /** The presence conditions of the file, as ids */
+    std::vector<RamDomain> pcs;
+
+    /** The next tuple to be read */
+    uint64_t next = 0;
+};
+
+class ReadFileBinaryFactory : public ReadStreamFactory {
+public:
+    std::unique_ptr<ReadStream> getReader(const SymbolMask& symbolMask, SymbolTable& symbolTable,
+            SymbolTable& featSymT, const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<ReadFileBinary>(symbolMask, symbolTable, featSymT, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~ReadFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -20,7 +20,7 @@
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 #include "Util.h"
-#include "PresenceConditionParser.h"
+#include "PresenceCondition.h"
 
 #ifdef USE_LIBZ
 #include "gzfstream.h"
@@ -28,11 +28,17 @@
 #include <fstream>
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace souffle {
 
@@ -42,7 +48,8 @@ public:
             SymbolTable& featSymTable, const IODirectives& ioDirectives, const bool provenance = false)
             : ReadStream(symbolMask, symbolTable, featSymTable, provenance),
               delimiter(getDelimiter(ioDirectives)),
-              file(file), lineNumber(0), inputMap(getInputColumnMap(ioDirectives, symbolMask.getArity())) {
+              file(file), lineNumber(0), inputMap(getInputColumnMap(ioDirectives, symbolMask.getArity())),
+              parallel(ioDirectives.has("parallel") && ioDirectives.get("parallel") == "true") {
         while (this->inputMap.size() < symbolMask.getArity()) {
             int size = this->inputMap.size();
             this->inputMap[size] = size;
@@ -64,74 +71,177 @@ protected:
         }
         std::string line;
         std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.getArity() + 1);
-        bool error = false;
 
         if (!getline(file, line)) {
             return nullptr;
         }
         // Handle Windows line endings on non-Windows systems
-        if (line.back() == '\r') {
+        if (!line.empty() && line.back() == '\r') {
             line = line.substr(0, line.length() - 1);
         }
         ++lineNumber;
 
-        AstPresenceCondition* pc = nullptr;
+        std::vector<std::string> warnings;
+        pcCount += parseLine(line.data(), line.length(), lineNumber, tuple.get(),
+                [&](size_t position, const char* symbol, size_t length) {
+                    tuple[position] = symbolTable.unsafeLookup(std::string(symbol, length));
+                },
+                warnings);
+        for (const auto& warning : warnings) {
+            std::cerr << warning << std::endl;
+        }
+        return tuple;
+    }
 
-        size_t start = 0, end = 0, columnsFilled = 0;
-        for (uint32_t column = 0; end < line.length(); column++) {
-            end = line.find(delimiter, start);
+    /**
+     * Read the next chunk of lines and parse them in parallel.
+     *
+     * Only used if the parallel directive is given. Symbols are interned after
+     * parsing, in the order of the lines, so that symbol numbers do not depend
+     * on the number of threads.
+     */
+    bool readNextBatch(std::vector<std::unique_ptr<RamDomain[]>>& batch) override {
+        if (!parallel) {
+            return ReadStream::readNextBatch(batch);
+        }
+
+        // read line-aligned chunk, keeping an incomplete last line for the next one
+        std::string chunk;
+        chunk.swap(remainder);
+        size_t lineEnd = std::string::npos;
+        while (file.good() && lineEnd == std::string::npos) {
+            size_t filled = chunk.size();
+            chunk.resize(filled + CHUNK_SIZE);
+            file.read(&chunk[filled], CHUNK_SIZE);
+            chunk.resize(filled + file.gcount());
+            lineEnd = chunk.rfind('\n');
+        }
+        if (file.good()) {
+            remainder.assign(chunk, lineEnd + 1, std::string::npos);
+            chunk.resize(lineEnd + 1);
+        }
+        if (chunk.empty()) {
+            return false;
+        }
+
+        // split into lines
+        std::vector<std::pair<size_t, size_t>> lines;
+        for (size_t start = 0; start < chunk.size();) {
+            size_t end = chunk.find('\n', start);
             if (end == std::string::npos) {
-                end = line.length();
+                end = chunk.size();
             }
-            std::string element;
-            if (start <= end && end <= line.length()) {
-                element = line.substr(start, end - start);
-                if (element.empty()) {
-                    element = "n/a";
-                }
-            } else {
-                if (!error) {
-                    std::stringstream errorMessage;
-                    errorMessage << "Value missing in column " << column + 1 << " in line " << lineNumber
-                                 << "; ";
-                    throw std::invalid_argument(errorMessage.str());
-                }
-                element = "n/a";
+            size_t length = end - start;
+            // Handle Windows line endings on non-Windows systems
+            if (length > 0 && chunk[start + length - 1] == '\r') {
+                --length;
+            }
+            lines.push_back(std::make_pair(start, length));
+            start = end + 1;
+        }
+
+        // parse lines in parallel, deferring symbols
+        struct PendingSymbol {
+            size_t position;
+            std::string symbol;
+        };
+        size_t count = lines.size();
+        std::vector<std::unique_ptr<RamDomain[]>> tuples(count);
+        std::vector<std::vector<PendingSymbol>> symbols(count);
+        std::vector<std::string> errors(count);
+        std::vector<std::vector<std::string>> warnings(count);
+        std::vector<size_t> pcs(count, 0);
+#pragma omp parallel for schedule(dynamic, 256)
+        for (size_t i = 0; i < count; i++) {
+            try {
+                tuples[i] = std::make_unique<RamDomain[]>(symbolMask.getArity() + 1);
+                auto& pending = symbols[i];
+                pcs[i] = parseLine(chunk.data() + lines[i].first, lines[i].second, lineNumber + i + 1,
+                        tuples[i].get(),
+                        [&](size_t position, const char* symbol, size_t length) {
+                            pending.push_back(PendingSymbol{position, std::string(symbol, length)});
+                        },
+                        warnings[i]);
+            } catch (std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+
+        // report warnings in line order, as the threads collected them without printing
+        for (const auto& lineWarnings : warnings) {
+            for (const auto& warning : lineWarnings) {
+                std::cerr << warning << std::endl;
+            }
+        }
+
+        // intern symbols in line order up to the first erroneous line
+        size_t valid = 0;
+        std::vector<std::string> pending;
+        for (; valid < count && errors[valid].empty(); valid++) {
+            for (auto& cur : symbols[valid]) {
+                pending.push_back(std::move(cur.symbol));
+            }
+        }
+        std::vector<RamDomain> indices = symbolTable.lookup(pending);
+        auto index = indices.begin();
+        for (size_t i = 0; i < valid; i++) {
+            for (const auto& cur : symbols[i]) {
+                tuples[i][cur.position] = *index++;
+            }
+            pcCount += pcs[i];
+            batch.push_back(std::move(tuples[i]));
+        }
+        if (valid < count) {
+            throw std::invalid_argument(errors[valid]);
+        }
+        lineNumber += count;
+        return true;
+    }
+
+    /**
+     * Parse a single line into the given tuple. Symbols are handed to the given
+     * handler together with their position in the tuple, and warnings are appended
+     * to the given list instead of being printed, so that parallel parsers do not
+     * interleave their output.
+     *
+     * @return the number of presence conditions found in this line
+     */
+    template <typename SymbolHandler>
+    size_t parseLine(const char* line, size_t lineLength, size_t lineNumber, RamDomain* tuple,
+            const SymbolHandler& handleSymbol, std::vector<std::string>& warnings) const {
+        static const char na[] = "n/a";
+        const PresenceCondition* pc = nullptr;
+        size_t pcs = 0;
+
+        size_t start = 0, end = 0, columnsFilled = 0;
+        for (uint32_t column = 0; end < lineLength; column++) {
+            end = findDelimiter(line, lineLength, start);
+            const char* element = line + start;
+            size_t length = end - start;
+            if (length == 0) {
+                element = na;
+                length = sizeof(na) - 1;
             }
-            //std::cout << element << std::endl;
             start = end + delimiter.size();
-            if (element[0] == '@' && element.length() > 1) {
-                std::string pcStr = element.substr(1);
-                PresenceConditionParser parser(pcStr);
-                pc = parser.parse(featSymTable);
+            if (element[0] == '@' && length > 1) {
+                std::string pcStr(element + 1, length - 1);
+                pc = PresenceCondition::parse(pcStr, featSymTable);
                 if (pc) {
-                    pcCount++;
+                    pcs++;
                     continue;
                 } else {
-                    std::cerr << "Invalid PC: " << pcStr << std::endl;
+                    warnings.push_back("Invalid PC in line " + std::to_string(lineNumber) + ": " + pcStr);
                 }
             }
-            if (inputMap.count(column) == 0) {
+            auto position = inputMap.find(column);
+            if (position == inputMap.end()) {
                 continue;
             }
             ++columnsFilled;
             if (symbolMask.isSymbol(column)) {
-                tuple[inputMap[column]] = symbolTable.unsafeLookup(element);
+                handleSymbol(position->second, element, length);
             } else {
-                try {
-#if RAM_DOMAIN_SIZE == 64
-                    tuple[inputMap[column]] = std::stoll(element);
-#else
-                    tuple[inputMap[column]] = std::stoi(element);
-#endif
-                } catch (...) {
-                    if (!error) {
-                        std::stringstream errorMessage;
-                        errorMessage << "Error converting number <" + element + "> in column " << column + 1
-                                     << " in line " << lineNumber << "; ";
-                        throw std::invalid_argument(errorMessage.str());
-                    }
-                }
+                tuple[position->second] = parseNumber(element, length, column, lineNumber);
             }
         }
 
@@ -147,26 +257,37 @@ protected:
             errorMessage << "Values missing in line " << lineNumber << "; ";
             throw std::invalid_argument(errorMessage.str());
         }
-        if (end != line.length()) {
-            if (!error) {
-                std::stringstream errorMessage;
-                errorMessage << "Too many cells in line " << lineNumber << "; ";
-                throw std::invalid_argument(errorMessage.str());
-            }
-        }
-        if (error) {
-            throw std::invalid_argument("cannot parse fact file");
-        }
 
-        PresenceCondition* _pc;
-        if (pc) {
-            _pc = PresenceCondition::parse(*pc);
-        } else {
-            _pc = PresenceCondition::makeTrue();
+        if (!pc) {
+            pc = PresenceCondition::makeTrue();
         }
-        tuple[symbolMask.getArity()] = (RamDomain) _pc;
+        tuple[symbolMask.getArity()] = pc->getId();
 
-        return tuple;
+        return pcs;
+    }
+
+    /** Find the end of the cell starting at the given offset */
+    size_t findDelimiter(const char* line, size_t lineLength, size_t start) const {
+        const char* end = std::search(line + start, line + lineLength, delimiter.begin(), delimiter.end());
+        return end - line;
+    }
+
+    /** Convert a number cell without copying it */
+    RamDomain parseNumber(const char* element, size_t length, uint32_t column, size_t lineNumber) const {
+        // cells are terminated by a delimiter or a line break, both of which end the number;
+        // the number has to span the whole cell
+        char* end = nullptr;
+        errno = 0;
+        long long value = std::strtoll(element, &end, 10);
+        if (end != element + length || errno == ERANGE ||
+                value < std::numeric_limits<RamDomain>::min() ||
+                value > std::numeric_limits<RamDomain>::max()) {
+            std::stringstream errorMessage;
+            errorMessage << "Error converting number <" + std::string(element, length) + "> in column "
+                         << column + 1 << " in line " << lineNumber << "; ";
+            throw std::invalid_argument(errorMessage.str());
+        }
+        return static_cast<RamDomain>(value);
     }
 
     std::string getDelimiter(const IODirectives& ioDirectives) const {
@@ -206,6 +327,15 @@ protected:
     std::istream& file;
     size_t lineNumber;
     std::map<int, int> inputMap;
+
+    /** Whether lines are read in chunks and parsed in parallel */
+    const bool parallel;
+
+    /** The number of bytes read per chunk in parallel mode */
+    static const size_t CHUNK_SIZE = 1 << 24;
+
+    /** The incomplete last line of the previous chunk */
+    std::string remainder;
 };
 
 class ReadFileCSV : public ReadStreamCSV {
@@ -243,6 +373,17 @@ public:
         }
     }
 
+    bool readNextBatch(std::vector<std::unique_ptr<RamDomain[]>>& batch) override {
+        try {
+            return ReadStreamCSV::readNextBatch(batch);
+        } catch (std::exception& e) {
+            std::stringstream errorMessage;
+            errorMessage << e.what();
+            errorMessage << "cannot parse fact file " << baseName << "!\n";
+            throw std::invalid_argument(errorMessage.str());
+        }
+    }
+
     ~ReadFileCSV() override = default;
 
 protected:
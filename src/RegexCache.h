@@ -0,0 +1,165 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RegexCache.h
+ *
+ * A cache of compiled regular expressions used by match constraints.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ParallelUtils.h"
+#include "RamTypes.h"
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+
+namespace souffle {
+
+/**
+ * @class RegexCache
+ *
+ * Caches the compiled form of the patterns of match constraints, keyed by the
+ * symbol-table index of the pattern, such that each pattern is compiled once
+ * instead of once per tested tuple. The cache may be shared by parallel
+ * evaluation threads.
+ *
+ * Patterns which consist of a literal string, optionally surrounded by .*,
+ * are matched by plain string comparison instead of the regex engine.
+ */
+class RegexCache {
+private:
+    /** A compiled pattern */
+    class Pattern {
+    public:
+        /** Fast matching strategies of literal patterns */
+        enum Kind { EQUAL, PREFIX, SUFFIX, INFIX, REGEX, INVALID };
+
+        explicit Pattern(const std::string& pattern) {
+            try {
+                regex = std::regex(pattern);
+            } catch (const std::regex_error& e) {
+                kind = INVALID;
+                error = e.code();
+                return;
+            }
+            classify(pattern);
+        }
+
+        /** Match the given text, throws a std::regex_error for invalid patterns */
+        bool match(const std::string& text) const {
+            // the wildcard . does not cover line terminators
+            if (kind != REGEX && kind != INVALID && text.find_first_of("\n\r") == std::string::npos) {
+                switch (kind) {
+                    case EQUAL:
+                        return text == literal;
+                    case PREFIX:
+                        return text.compare(0, literal.size(), literal) == 0;
+                    case SUFFIX:
+                        return text.size() >= literal.size() &&
+                               text.compare(text.size() - literal.size(), literal.size(), literal) == 0;
+                    case INFIX:
+                        return text.find(literal) != std::string::npos;
+                    default:
+                        break;
+                }
+            }
+            if (kind == INVALID) {
+                throw std::regex_error(error);
+            }
+            return std::regex_match(text, regex);
+        }
+
+    private:
+        Kind kind = REGEX;
+        std::regex regex;
+        std::regex_constants::error_type error = std::regex_constants::error_type();
+        std::string literal;
+
+        /** Determine whether the pattern is a literal string with leading/trailing .* */
+        void classify(const std::string& pattern) {
+            static const std::string wildcard = ".*";
+            size_t begin = 0;
+            size_t end = pattern.size();
+            bool leading = false;
+            bool trailing = false;
+            if (end - begin >= wildcard.size() && pattern.compare(begin, wildcard.size(), wildcard) == 0) {
+                begin += wildcard.size();
+                leading = true;
+            }
+            if (end - begin >= wildcard.size() &&
+                    pattern.compare(end - wildcard.size(), wildcard.size(), wildcard) == 0) {
+                end -= wildcard.size();
+                trailing = true;
+            }
+            literal = pattern.substr(begin, end - begin);
+            if (literal.find_first_of("^$\\.*+?()[]{}|") != std::string::npos) {
+                literal.clear();
+                return;
+            }
+            kind = leading ? (trailing ? INFIX : SUFFIX) : (trailing ? PREFIX : EQUAL);
+        }
+    };
+
+    /** Compiled patterns indexed by the symbol of the pattern */
+    std::unordered_map<RamDomain, std::unique_ptr<Pattern>> patterns;
+
+    /** Protects the pattern map; compiled patterns are immutable */
+    mutable ReadWriteLock lock;
+
+    /** Obtain the compiled pattern of the given symbol, compiling it if necessary */
+    const Pattern& getPattern(RamDomain index, const std::string& pattern) {
+        lock.start_read();
+        auto pos = patterns.find(index);
+        if (pos != patterns.end()) {
+            const Pattern& res = *pos->second;
+            lock.end_read();
+            return res;
+        }
+        lock.end_read();
+
+        // compile outside of the critical section
+        std::unique_ptr<Pattern> compiled = std::make_unique<Pattern>(pattern);
+        lock.start_write();
+        const Pattern& res = *patterns.emplace(index, std::move(compiled)).first->second;
+        lock.end_write();
+        return res;
+    }
+
+public:
+    RegexCache() = default;
+    RegexCache(const RegexCache&) = delete;
+    RegexCache& operator=(const RegexCache&) = delete;
+
+    /**
+     * Checks whether the given text matches the given pattern.
+     *
+     * @param index the symbol-table index of the pattern
+     * @param pattern the pattern, i.e., the symbol of the given index
+     * @param text the text to be matched
+     * @return whether the text matches the pattern
+     * @throws std::regex_error if the pattern is not a valid regular expression
+     */
+    bool match(RamDomain index, const std::string& pattern, const std::string& text) {
+        return getPattern(index, pattern).match(text);
+    }
+
+    /** Drop all compiled patterns */
+    void clear() {
+        lock.start_write();
+        patterns.clear();
+        lock.end_write();
+    }
+};
+
+}  // end of namespace souffle
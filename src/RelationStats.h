@@ -0,0 +1,164 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RelationStats.h
+ *
+ * Statistics on the contents of relations, used to estimate the
+ * selectivity of atoms when ordering the atoms of a rule.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "PresenceCondition.h"
+#include "ProfileEvent.h"
+#include "RamTypes.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * The statistics of a relation: its cardinality, the estimated number of
+ * distinct values of each column and, for lifted relations, the
+ * distribution of presence conditions among its tuples.
+ *
+ * The statistics are extracted from a sample consisting of a prefix of
+ * the relation; column cardinalities are extrapolated linearly from the
+ * number of distinct values in the sample.
+ */
+class RelationStats {
+private:
+    /** The arity of the relation */
+    size_t arity;
+
+    /** The number of tuples in the relation */
+    uint64_t size;
+
+    /** The number of tuples sampled */
+    uint64_t sampleSize;
+
+    /** The estimated number of distinct values of each column */
+    std::vector<uint64_t> cardinalities;
+
+    /** The number of distinct presence conditions in the sample */
+    uint64_t numPCs;
+
+    /** The number of sampled tuples present in all configurations */
+    uint64_t numTruePCs;
+
+public:
+    RelationStats() : arity(0), size(0), sampleSize(0), numPCs(0), numTruePCs(0) {}
+
+    RelationStats(uint64_t size, std::vector<uint64_t> cardinalities)
+            : arity(cardinalities.size()), size(size), sampleSize(size), cardinalities(std::move(cardinalities)),
+              numPCs(0), numTruePCs(0) {}
+
+    /**
+     * Extracts statistics from an interpreter or compiled relation by
+     * inspecting at most sampleSize of its tuples.
+     */
+    template <typename Relation>
+    static RelationStats extractFrom(const Relation& rel, uint32_t sampleSize = 10000) {
+        RelationStats res;
+        res.arity = rel.getArity();
+        res.size = rel.size();
+
+        std::vector<std::unordered_set<RamDomain>> values(res.arity);
+        std::unordered_set<const PresenceCondition*> pcs;
+        // under a feature model, tuples present in all valid configurations carry the model
+        const PresenceCondition* tt = PresenceCondition::makeTrue();
+        for (const auto& cur : rel) {
+            if (res.sampleSize == sampleSize) {
+                break;
+            }
+            for (size_t i = 0; i < res.arity; i++) {
+                values[i].insert(cur[i]);
+            }
+            const PresenceCondition* pc = rel.getPC(cur);
+            pcs.insert(pc);
+            if (pc == tt || pc->isTrue()) {
+                res.numTruePCs++;
+            }
+            res.sampleSize++;
+        }
+        res.numPCs = pcs.size();
+
+        for (const auto& cur : values) {
+            res.cardinalities.push_back(
+                    (res.sampleSize == 0) ? 0 : cur.size() * res.size / res.sampleSize);
+        }
+        return res;
+    }
+
+    /** Get the arity of the relation */
+    size_t getArity() const {
+        return arity;
+    }
+
+    /** Get the number of tuples in the relation */
+    uint64_t getCardinality() const {
+        return size;
+    }
+
+    /** Get the number of tuples the statistics are based on */
+    uint64_t getSampleSize() const {
+        return sampleSize;
+    }
+
+    /** Get the estimated number of distinct values in the given column */
+    uint64_t getEstimatedCardinality(size_t col) const {
+        return (col < cardinalities.size()) ? cardinalities[col] : size;
+    }
+
+    /** Get the number of distinct presence conditions in the sample */
+    uint64_t getNumPCs() const {
+        return numPCs;
+    }
+
+    /** Get the number of sampled tuples which are present in all configurations */
+    uint64_t getNumTruePCs() const {
+        return numTruePCs;
+    }
+
+    /**
+     * Records the statistics as profile events; txt is the event prefix
+     * naming the relation, see LogStatement::sRelation.
+     */
+    void log(const std::string& txt) const {
+        auto& profile = ProfileEventSingleton::instance();
+        profile.makeQuantityEvent(txt + "cardinality", size, 0);
+        profile.makeQuantityEvent(txt + "sample-size", sampleSize, 0);
+        for (size_t i = 0; i < arity; i++) {
+            profile.makeQuantityEvent(txt + "distinct;" + std::to_string(i), cardinalities[i], 0);
+        }
+        profile.makeQuantityEvent(txt + "pcs", numPCs, 0);
+        profile.makeQuantityEvent(txt + "true-pcs", numTruePCs, 0);
+    }
+
+    void print(std::ostream& out) const {
+        out << "size: " << size << ", sample: " << sampleSize << ", distinct: [";
+        for (size_t i = 0; i < arity; i++) {
+            out << ((i > 0) ? "," : "") << cardinalities[i];
+        }
+        out << "], pcs: " << numPCs << ", true-pcs: " << numTruePCs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const RelationStats& stats) {
+        stats.print(out);
+        return out;
+    }
+};
+
+}  // end of namespace souffle
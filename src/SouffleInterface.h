@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "PresenceCondition.h"
 #include "RamTypes.h"
 #include "SymbolTable.h"
 
@@ -102,6 +103,13 @@ public:
     // check whether a tuple exists in the relation
     virtual bool contains(const tuple& t) const = 0;
 
+    // presence condition of a tuple in the relation, false if it does not exist
+    virtual const PresenceCondition* getPC(const tuple& t) const = 0;
+
+    // visit the tuples of the relation present in the given configuration
+    template <typename Visitor>
+    void forEachIn(const PresenceCondition::Configuration& configuration, Visitor visitor) const;
+
     // begin and end iterator
     virtual iterator begin() const = 0;
     virtual iterator end() const = 0;
@@ -135,10 +143,12 @@ class tuple {
     const Relation& relation;
     std::vector<RamDomain> array;
     size_t pos;
+    const PresenceCondition* pc = nullptr;
 
 public:
     tuple(const Relation* r) : relation(*r), array(r->getArity()), pos(0), data(array.data()) {}
-    tuple(const tuple& t) : relation(t.relation), array(t.array), pos(t.pos), data(array.data()) {}
+    tuple(const tuple& t)
+            : relation(t.relation), array(t.array), pos(t.pos), pc(t.pc), data(array.data()) {}
 
     /**
      * allows printing using WriteStream
@@ -166,6 +176,20 @@ public:
         return array[idx];
     }
 
+    /**
+     * presence condition of the tuple, true unless set otherwise
+     */
+    const PresenceCondition* getPC() const {
+        return pc ? pc : PresenceCondition::makeTrue();
+    }
+
+    /**
+     * set the presence condition under which the tuple is inserted
+     */
+    void setPC(const PresenceCondition* condition) {
+        pc = condition;
+    }
+
     /**
      * reset stream pointer to first element of tuple
      */
@@ -230,6 +254,16 @@ public:
     }
 };
 
+template <typename Visitor>
+void Relation::forEachIn(const PresenceCondition::Configuration& configuration, Visitor visitor) const {
+    for (iterator it = begin(); it != end(); ++it) {
+        const tuple& t = *it;
+        if (t.getPC()->evaluate(configuration)->isTrue()) {
+            visitor(t);
+        }
+    }
+}
+
 /**
  * Abstract base class for generated Datalog programs
  */
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "BlockList.h"
 #include "ParallelUtils.h"
 #include "RamTypes.h"
 #include "Util.h"
@@ -25,12 +26,17 @@
 #include <thread>
 #endif
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <deque>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace souffle {
 
@@ -40,6 +46,10 @@ namespace souffle {
  * Global pool of re-usable strings
  *
  * SymbolTable stores Datalog symbols and converts them to numbers and vice versa.
+ *
+ * Each symbol is stored once, in a block-wise allocated store indexed by the
+ * number of the symbol, such that resolving a number never locks. The map from
+ * symbols to numbers is split into shards which are locked independently.
  */
 class SymbolTable {
 #ifdef USE_MPI
@@ -55,12 +65,17 @@ private:
         RESOLVE = 6,
         SIZE = 7,
         UNSAFE_LOOKUP = 8,
-        UNSAFE_RESOLVE = 9
+        UNSAFE_RESOLVE = 9,
+        LOOKUP_VECTOR = 10,
+        RESOLVE_VECTOR = 11
     };
 
     mutable std::unordered_map<std::string, size_t> strToNumCache;
     mutable std::unordered_map<size_t, std::string> numToStrCache;
 
+    /** A lock to synchronize parallel accesses to the caches */
+    mutable Lock access;
+
     RamDomain cacheLookup(const std::string& symbol, const int tag) const {
         auto lease = access.acquire();
         (void)lease;  // avoid warning;
@@ -88,6 +103,59 @@ private:
         return strToNumCache.insert(std::pair<std::string, size_t>(symbol, index)).first->first;
     }
 
+    /** Look up a batch of symbols with a single request for those which are not cached yet */
+    std::vector<RamDomain> cacheLookup(const std::vector<std::string>& symbols) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        std::vector<std::string> misses;
+        for (const auto& symbol : symbols) {
+            if (strToNumCache.find(symbol) == strToNumCache.end()) {
+                misses.push_back(symbol);
+            }
+        }
+        if (!misses.empty()) {
+            mpi::send(misses, 0, LOOKUP_VECTOR);
+            std::vector<RamDomain> indices;
+            auto status = mpi::probe(0, LOOKUP_VECTOR);
+            mpi::recv(indices, status);
+            for (size_t i = 0; i < misses.size(); ++i) {
+                strToNumCache.insert(std::pair<std::string, size_t>(misses[i], indices[i]));
+                numToStrCache.insert(std::pair<size_t, std::string>(indices[i], misses[i]));
+            }
+        }
+        std::vector<RamDomain> result;
+        result.reserve(symbols.size());
+        for (const auto& symbol : symbols) {
+            result.push_back(strToNumCache.at(symbol));
+        }
+        return result;
+    }
+
+    /** Resolve a batch of indices with a single request for those which are not cached yet */
+    void cacheResolve(const std::vector<RamDomain>& indices) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        std::vector<RamDomain> misses;
+        for (const auto index : indices) {
+            if (numToStrCache.find(index) == numToStrCache.end()) {
+                misses.push_back(index);
+            }
+        }
+        if (misses.empty()) {
+            return;
+        }
+        std::sort(misses.begin(), misses.end());
+        misses.erase(std::unique(misses.begin(), misses.end()), misses.end());
+        mpi::send(misses, 0, RESOLVE_VECTOR);
+        std::vector<std::string> symbols;
+        auto status = mpi::probe(0, RESOLVE_VECTOR);
+        mpi::recv(symbols, status);
+        for (size_t i = 0; i < misses.size(); ++i) {
+            numToStrCache.insert(std::pair<size_t, std::string>(misses[i], symbols[i]));
+            strToNumCache.insert(std::pair<std::string, size_t>(symbols[i], misses[i]));
+        }
+    }
+
 public:
     void handleMpiMessages(const size_t count) {
         assert(mpi::commRank() == 0);
@@ -146,6 +214,23 @@ public:
                     insert(symbol);
                     break;
                 }
+                case LOOKUP_VECTOR: {
+                    std::vector<std::string> symbols;
+                    mpi::recv(symbols, status);
+                    mpi::send(lookup(symbols), status);
+                    break;
+                }
+                case RESOLVE_VECTOR: {
+                    std::vector<RamDomain> indices;
+                    mpi::recv(indices, status);
+                    std::vector<std::string> symbols;
+                    symbols.reserve(indices.size());
+                    for (const auto index : indices) {
+                        symbols.push_back(resolve(index));
+                    }
+                    mpi::send(symbols, status);
+                    break;
+                }
                 case INSERT_VECTOR_STRING: {
                     std::vector<std::string> symbols;
                     mpi::recv(symbols, status);
@@ -162,7 +247,7 @@ public:
 
     static int numberOfTags() {
         // ok, so this looks stupid, but it just gives the size of the enum at the top
-        return 10;
+        return 12;
     }
 
     static int exitTag() {
@@ -172,75 +257,142 @@ public:
 #endif
 
 private:
-    /** A lock to synchronize parallel accesses */
-    mutable Lock access;
+    /** Number of independently locked parts of the string-to-index map */
+    static constexpr size_t NUM_SHARDS = 64;
 
-    /** Map indices to strings. */
-    std::deque<std::string> numToStr;
+    /** Hashes symbols stored in the symbol store */
+    struct SymbolHash {
+        size_t operator()(const std::string* symbol) const {
+            return std::hash<std::string>()(*symbol);
+        }
+    };
+
+    /** Compares symbols stored in the symbol store */
+    struct SymbolEqual {
+        bool operator()(const std::string* a, const std::string* b) const {
+            return *a == *b;
+        }
+    };
+
+    /** A part of the string-to-index map, whose keys point into the symbol store */
+    struct Shard {
+        mutable SpinLock lock;
+        std::unordered_map<const std::string*, size_t, SymbolHash, SymbolEqual> strToNum;
+    };
+
+    /** Map indices to strings; blocks are allocated on demand and never moved. */
+    BlockStore<std::string> symbols;
+
+    /** Number of indices handed out so far */
+    std::atomic<size_t> numSymbols;
 
     /** Map strings to indices. */
-    std::unordered_map<std::string, size_t> strToNum;
+    std::array<Shard, NUM_SHARDS> shards;
+
+    /** Obtain the shard responsible for the given symbol */
+    Shard& getShard(const std::string& symbol) {
+        return shards[std::hash<std::string>()(symbol) % NUM_SHARDS];
+    }
+
+    const Shard& getShard(const std::string& symbol) const {
+        return shards[std::hash<std::string>()(symbol) % NUM_SHARDS];
+    }
+
+    /** Obtain the storage location of the given index, allocating its block if necessary */
+    std::string& getSlot(size_t index) {
+        return *symbols.getSlot(index);
+    }
+
+    /** Obtain the symbol of an index which has already been handed out; does not lock */
+    const std::string& getSymbol(size_t index) const {
+        return *symbols.get(index);
+    }
 
     /** Convenience method to place a new symbol in the table, if it does not exist, and return the index of
      * it. */
     inline size_t newSymbolOfIndex(const std::string& symbol) {
-        size_t index;
-        auto it = strToNum.find(symbol);
-        if (it == strToNum.end()) {
-            index = numToStr.size();
-            strToNum[symbol] = index;
-            numToStr.push_back(symbol);
-        } else {
-            index = it->second;
+        Shard& shard = getShard(symbol);
+        std::lock_guard<SpinLock> guard(shard.lock);
+        auto it = shard.strToNum.find(&symbol);
+        if (it != shard.strToNum.end()) {
+            return it->second;
         }
+        size_t index = numSymbols.fetch_add(1, std::memory_order_relaxed);
+        std::string& stored = getSlot(index);
+        stored = symbol;
+        shard.strToNum.emplace(&stored, index);
         return index;
     }
 
     /** Convenience method to place a new symbol in the table, if it does not exist. */
     inline void newSymbol(const std::string& symbol) {
-        if (strToNum.find(symbol) == strToNum.end()) {
-            strToNum[symbol] = numToStr.size();
-            numToStr.push_back(symbol);
+        newSymbolOfIndex(symbol);
+    }
+
+    /** Append the symbols of another table, preserving their indices in an empty table */
+    void copySymbols(const SymbolTable& other) {
+        size_t count = other.numSymbols.load();
+        for (size_t i = 0; i < count; i++) {
+            newSymbol(other.getSymbol(i));
+        }
+    }
+
+    /** Remove all symbols */
+    void clear() {
+        symbols.clear();
+        for (auto& shard : shards) {
+            shard.strToNum.clear();
+        }
+        numSymbols = 0;
+    }
+
+    /** Exchange the contents of two tables */
+    void swap(SymbolTable& other) {
+        symbols.swap(other.symbols);
+        numSymbols = other.numSymbols.exchange(numSymbols);
+        for (size_t i = 0; i < NUM_SHARDS; i++) {
+            shards[i].strToNum.swap(other.shards[i].strToNum);
         }
     }
 
 public:
     /** Empty constructor. */
-    SymbolTable() = default;
+    SymbolTable() : numSymbols(0) {}
 
     /** Copy constructor, performs a deep copy. */
-    SymbolTable(const SymbolTable& other) : numToStr(other.numToStr), strToNum(other.strToNum) {}
+    SymbolTable(const SymbolTable& other) : SymbolTable() {
+        copySymbols(other);
+    }
 
     /** Copy constructor for r-value reference. */
-    SymbolTable(SymbolTable&& other) noexcept {
-        numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+    SymbolTable(SymbolTable&& other) noexcept : SymbolTable() {
+        swap(other);
     }
 
-    SymbolTable(std::initializer_list<std::string> symbols) {
-        strToNum.reserve(symbols.size());
+    SymbolTable(std::initializer_list<std::string> symbols) : SymbolTable() {
         for (const auto& symbol : symbols) {
             newSymbol(symbol);
         }
     }
 
     /** Destructor, frees memory allocated for all strings. */
-    virtual ~SymbolTable() = default;
+    virtual ~SymbolTable() {
+        clear();
+    }
 
     /** Assignment operator, performs a deep copy and frees memory allocated for all strings. */
     SymbolTable& operator=(const SymbolTable& other) {
         if (this == &other) {
             return *this;
         }
-        numToStr = other.numToStr;
-        strToNum = other.strToNum;
+        clear();
+        copySymbols(other);
         return *this;
     }
 
     /** Assignment operator for r-value references. */
     SymbolTable& operator=(SymbolTable&& other) noexcept {
-        numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+        swap(other);
         return *this;
     }
 
@@ -252,11 +404,23 @@ public:
             return cacheLookup(symbol, LOOKUP);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             return static_cast<RamDomain>(newSymbolOfIndex(symbol));
+    }
+
+    /** Bulk lookup of symbols, inserting the ones which do not exist in the table yet. Indices are
+     * assigned in the order of the given symbols. */
+    std::vector<RamDomain> lookup(const std::vector<std::string>& symbols) {
+#ifdef USE_MPI
+        if (mpi::commRank() != 0) {
+            return cacheLookup(symbols);
+        }
+#endif
+        std::vector<RamDomain> indices;
+        indices.reserve(symbols.size());
+        for (const auto& symbol : symbols) {
+            indices.push_back(lookup(symbol));
         }
+        return indices;
     }
 
     /** Finds the index of a symbol in the table, giving an error if it's not found */
@@ -267,10 +431,10 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            auto result = strToNum.find(symbol);
-            if (result == strToNum.end()) {
+            const Shard& shard = getShard(symbol);
+            std::lock_guard<SpinLock> guard(shard.lock);
+            auto result = shard.strToNum.find(&symbol);
+            if (result == shard.strToNum.end()) {
                 std::cerr << "Error string not found in call to SymbolTable::lookupExisting.\n";
                 exit(1);
             }
@@ -279,7 +443,7 @@ public:
     }
 
     /** Find the index of a symbol in the table, inserting a new symbol if it does not exist there
-     * already. */
+     * already. Lookups are thread-safe, hence this is equivalent to lookup. */
     RamDomain unsafeLookup(const std::string& symbol) {
 #ifdef USE_MPI
         if (mpi::commRank() != 0) {
@@ -290,7 +454,7 @@ public:
     }
 
     /** Find a symbol in the table by its index, note that this gives an error if the index is out of
-     * bounds.
+     * bounds. Does not lock.
      */
     const std::string& resolve(const RamDomain index) const {
 #ifdef USE_MPI
@@ -299,15 +463,13 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             auto pos = static_cast<size_t>(index);
             if (pos >= size()) {
                 // TODO: use different error reporting here!!
                 std::cerr << "Error index out of bounds in call to SymbolTable::resolve.\n";
                 exit(1);
             }
-            return numToStr[pos];
+            return getSymbol(pos);
         }
     }
 
@@ -317,7 +479,19 @@ public:
             return cacheResolve(index, UNSAFE_RESOLVE);
         } else
 #endif
-            return numToStr[static_cast<size_t>(index)];
+            return getSymbol(static_cast<size_t>(index));
+    }
+
+    /** Make the symbols of the given indices available for resolving; under MPI, the symbols which
+     * are not cached by this process are requested from the root process at once. */
+    void prefetch(const std::vector<RamDomain>& indices) const {
+#ifdef USE_MPI
+        if (mpi::commRank() != 0) {
+            cacheResolve(indices);
+        }
+#else
+        (void)indices;
+#endif
     }
 
     /* Return the size of the symbol table, being the number of symbols it currently holds. */
@@ -330,7 +504,7 @@ public:
             return size;
         } else
 #endif
-            return numToStr.size();
+            return numSymbols.load(std::memory_order_acquire);
     }
 
     /** Bulk insert symbols into the table, note that this operation is more efficient than repeated
@@ -343,9 +517,12 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            strToNum.reserve(size() + symbols.size());
+            // pre-size the shards, assuming an even distribution of symbols
+            size_t expected = (size() + symbols.size()) / NUM_SHARDS + 1;
+            for (auto& shard : shards) {
+                std::lock_guard<SpinLock> guard(shard.lock);
+                shard.strToNum.reserve(expected);
+            }
             for (auto& symbol : symbols) {
                 newSymbol(symbol);
             }
@@ -361,11 +538,7 @@ public:
             mpi::send(symbol, 0, INSERT_STRING);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             newSymbol(symbol);
-        }
     }
 
     /** Print the symbol table to the given stream. */
@@ -376,20 +549,19 @@ public:
         } else
 #endif
         {
+            size_t count = size();
             out << "SymbolTable: {\n\t";
-            out << join(strToNum, "\n\t",
-                           [](std::ostream& out, const std::pair<std::string, std::size_t>& entry) {
-                               out << entry.first << "\t => " << entry.second;
-                           })
-                << "\n";
+            for (size_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    out << "\n\t";
+                }
+                out << getSymbol(i) << "\t => " << i;
+            }
+            out << "\n";
             out << "}\n";
         }
     }
 
-    Lock::Lease acquireLock() const {
-        return access.acquire();
-    }
-
     /** Stream operator, used as a convenience for print. */
     friend std::ostream& operator<<(std::ostream& out, const SymbolTable& table) {
         table.print(out);
@@ -217,6 +217,98 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         std::function<void(std::ostream&, const RamNode*)> rec;
 
+        // the expression denoting the presence condition of the current loop nest; empty outside of it
+        std::string curPC;
+
+        // counter for the names of generated presence condition variables
+        unsigned pcCounter = 0;
+
+        /* Obtains the current presence condition, true if not inside an operation */
+        std::string getPC() const {
+            return curPC.empty() ? "PresenceCondition::makeTrue()" : curPC;
+        }
+
+        /* Declares a fresh presence condition variable initialized with the given value */
+        std::string declarePC(const std::string& value, std::ostream& out) {
+            std::string name = "pc" + toString(pcCounter++);
+            out << "const PresenceCondition* " << name << " = " << value << ";\n";
+            return name;
+        }
+
+        /* Collects the conjuncts of the given condition, separating negations from other checks */
+        void collectConjuncts(const RamCondition& condition, std::vector<const RamCondition*>& checks,
+                std::vector<const RamNotExists*>& negations) {
+            if (const auto* conj = dynamic_cast<const RamAnd*>(&condition)) {
+                collectConjuncts(conj->getLHS(), checks, negations);
+                collectConjuncts(conj->getRHS(), checks, negations);
+            } else if (const auto* ne = dynamic_cast<const RamNotExists*>(&condition)) {
+                negations.push_back(ne);
+            } else {
+                checks.push_back(&condition);
+            }
+        }
+
+        /* Opens the blocks guarded by a condition of an operation; negations do not filter but
+           narrow down the current presence condition, which is updated in separate statements
+           before it is tested. Returns the code closing the opened blocks. */
+        std::string visitConditionBegin(const RamCondition& condition, std::ostream& out) {
+            std::vector<const RamCondition*> checks;
+            std::vector<const RamNotExists*> negations;
+            collectConjuncts(condition, checks, negations);
+
+            out << "if( ";
+            if (checks.empty()) {
+                out << "true";
+            } else {
+                out << "(" << join(checks, ") && (", [&](std::ostream& out, const RamCondition* cur) {
+                    visit(*cur, out);
+                }) << ")";
+            }
+            out << ") {\n";
+            if (negations.empty()) {
+                return "}\n";
+            }
+            for (const RamNotExists* ne : negations) {
+                out << curPC << " = " << curPC << "->conjoin(";
+                visitNotExistsPC(*ne, out);
+                out << "->negate());\n";
+            }
+            out << "if (" << curPC << "->isSAT()) {\n";
+            return "}\n}\n";
+        }
+
+        /* Emits the presence condition of the tuples matched by the existence check of a negation */
+        void visitNotExistsPC(const RamNotExists& ne, std::ostream& out) {
+            const auto& rel = ne.getRelation();
+            auto relName = synthesiser.getRelationName(rel);
+            auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(rel) + ")";
+            auto arity = rel.getArity();
+            out << relName << "->";
+            if (ne.isTotal()) {
+                out << "getPC(Tuple<RamDomain," << arity << ">({{" << join(ne.getValues(), ",", rec)
+                    << "}}))";
+                return;
+            }
+            out << "getRangePC(" << relName << "->equalRange" << synthesiser.toIndex(ne.getKey());
+            out << "(Tuple<RamDomain," << arity << ">({{";
+            out << join(ne.getValues(), ",", [&](std::ostream& out, RamValue* value) {
+                if (!value) {
+                    out << "0";
+                } else {
+                    visit(*value, out);
+                }
+            });
+            out << "}})," << ctxName << "))";
+        }
+
+        /* Emits the nested part of a search under the given presence condition variable */
+        void visitSearchUnder(const RamSearch& search, const std::string& pc, std::ostream& out) {
+            std::string outerPC = curPC;
+            curPC = pc;
+            visitSearch(search, out);
+            curPC = outerPC;
+        }
+
     public:
         CodeEmitter(Synthesiser& syn) : synthesiser(syn) {
             rec = [&](std::ostream& out, const RamNode* node) { this->visit(*node, out); };
@@ -231,8 +323,18 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitFact(const RamFact& fact, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << synthesiser.getRelationName(fact.getRelation()) << "->"
-                << "insert(" << join(fact.getValues(), ",", rec) << ");\n";
+            const auto& rel = fact.getRelation();
+            out << synthesiser.getRelationName(rel) << "->"
+                << "insertLifted(Tuple<RamDomain," << rel.getArity() << ">({{"
+                << join(fact.getValues(), ",", rec) << "}}),";
+            const PresenceCondition* pc = fact.getPC();
+            if (pc == nullptr || pc->isTrue()) {
+                out << "PresenceCondition::makeTrue()";
+            } else {
+                // facts are re-parsed over the feature symbol table of the generated program
+                out << "PresenceCondition::parse(R\"_(" << pc->getText() << ")_\")";
+            }
+            out << ");\n";
             PRINT_END_COMMENT(out);
         }
 
@@ -249,16 +351,36 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
                 out << "}\n";
                 out << "IODirectives ioDirectives(directiveMap);\n";
+                out << "auto loader = makeRelationLoader(*" << synthesiser.getRelationName(load.getRelation())
+                    << ");\n";
                 out << "IOSystem::getInstance().getReader(";
                 out << "SymbolMask({" << load.getRelation().getSymbolMask() << "})";
                 out << ", symTable, featSymTable, ioDirectives";
                 out << ", " << Global::config().has("provenance");
-                out << ")->readAll(*" << synthesiser.getRelationName(load.getRelation());
-                out << ");\n";
+                out << ")->readAll(loader);\n";
                 out << "} catch (std::exception& e) {std::cerr << \"Error loading data: \" << e.what() << "
                        "'\\n';}\n";
             }
             out << "}\n";
+#ifdef USE_MPI
+            // only the process of a partitioned stratum loads, and shares the input with its group
+            // before the delta relations are partitioned
+            if (Global::config().get("engine") == "mpi") {
+                const std::string relName = synthesiser.getRelationName(load.getRelation());
+                out << "\n#ifdef USE_MPI\n";
+                out << "if (mpiGroup.size() > 1) {";
+                out << "if (mpiGroup.isLeader()) {";
+                out << "souffle::mpi::sendLifted<RamDomain>(*" << relName << ", "
+                    << load.getRelation().getArity() << ", mpiGroup.getHelpers(), tag_" << relName << ");";
+                out << "} else {";
+                out << "auto status = souffle::mpi::probe(mpiGroup.getLeader(), tag_" << relName << ");";
+                out << "souffle::mpi::recvLifted<RamDomain>(*" << relName << ", "
+                    << load.getRelation().getArity() << ", status);";
+                out << "}";
+                out << "}";
+                out << "\n#endif\n";
+            }
+#endif
             PRINT_END_COMMENT(out);
         }
 
@@ -286,9 +408,16 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitInsert(const RamInsert& insert, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            // enclose operation with a check for an empty relation
+            // enclose operation with a check for an empty relation; only the scans above a branch
+            // guard all of the nested operations
             std::set<RamRelation> input_relations;
-            visitDepthFirst(insert, [&](const RamScan& scan) { input_relations.insert(scan.getRelation()); });
+            const RamOperation* op = &insert.getOperation();
+            while (const auto* search = dynamic_cast<const RamSearch*>(op)) {
+                if (const auto* scan = dynamic_cast<const RamScan*>(search)) {
+                    input_relations.insert(scan->getRelation());
+                }
+                op = search->getNestedOperation();
+            }
             if (!input_relations.empty()) {
                 out << "if (" << join(input_relations, "&&", [&](std::ostream& out, const RamRelation& rel) {
                     out << "!" << synthesiser.getRelationName(rel) << "->"
@@ -361,7 +490,9 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << "->createContext());\n";
             }
 
+            curPC = "PresenceCondition::makeTrue()";
             visit(insert.getOperation(), out);
+            curPC.clear();
 
             if (parallel) {
                 out << "PARALLEL_END;\n";  // end parallel
@@ -382,7 +513,7 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                     << "*" << synthesiser.getRelationName(merge.getTargetRelation()) << ");\n";
             }
             out << synthesiser.getRelationName(merge.getTargetRelation()) << "->"
-                << "insertAll("
+                << "insertAllLifted("
                 << "*" << synthesiser.getRelationName(merge.getSourceRelation()) << ");\n";
             PRINT_END_COMMENT(out);
         }
@@ -425,6 +556,13 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitLogStats(const RamLogStats& log, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << "RelationStats::extractFrom(*" << synthesiser.getRelationName(log.getRelation());
+            out << ").log(R\"(" << log.getMessage() << ")\");";
+            PRINT_END_COMMENT(out);
+        }
+
         // -- control flow statements --
 
         void visitSequence(const RamSequence& seq, std::ostream& out) override {
@@ -542,14 +680,18 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_BEGIN_COMMENT(out);
             auto condition = search.getCondition();
             if (condition) {
-                out << "if( ";
-                visit(condition, out);
-                out << ") {\n";
+                // negations in the condition narrow down the presence condition
+                std::string outerPC = curPC;
+                out << "{\n";
+                curPC = declarePC(getPC(), out);
+                auto end = visitConditionBegin(*condition, out);
                 visit(search.getNestedOperation(), out);
                 if (Global::config().has("profile") && !search.getProfileText().empty()) {
                     out << "freqs[" << synthesiser.lookupFreqIdx(search.getProfileText()) << "]++;\n";
                 }
+                out << end;
                 out << "}\n";
+                curPC = outerPC;
             } else {
                 visit(search.getNestedOperation(), out);
                 if (Global::config().has("profile") && !search.getProfileText().empty()) {
@@ -567,12 +709,33 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(rel) + ")";
             auto level = scan.getLevel();
 
+            // the body of a loop over the tuples of the relation, skipping tuples absent in all
+            // configurations of the current presence condition
+            std::string scanPC = "getScanPC";
+            auto visitLoopBody = [&]() {
+                auto pc = declarePC(getPC() + "->conjoin(" + relName + "->" + scanPC + "(env" +
+                                            toString(level) + "))",
+                        out);
+                out << "if (!" << pc << "->isSAT()) continue;\n";
+                visitSearchUnder(scan, pc, out);
+            };
+
+            // the body of an existence check over the given range of the relation
+            auto visitExistenceBody = [&](const std::string& range) {
+                out << "{\n";
+                auto pc = declarePC(getPC() + "->conjoin(" + relName + "->getRangePC(" + range + "))", out);
+                out << "if (" << pc << "->isSAT()) {\n";
+                visitSearchUnder(scan, pc, out);
+                out << "}\n";
+                out << "}\n";
+            };
+
             // if this search is a full scan
             if (scan.getRangeQueryColumns() == 0) {
                 if (scan.isPureExistenceCheck()) {
                     out << "if(!" << relName << "->"
                         << "empty()) {\n";
-                    visitSearch(scan, out);
+                    visitExistenceBody("*" + relName);
                     out << "}\n";
                 } else if (scan.getLevel() == 0) {
                     // make this loop parallel
@@ -580,13 +743,13 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                     out << "pfor(auto it = part.begin(); it<part.end(); ++it) \n";
                     out << "try{";
                     out << "for(const auto& env0 : *it) {\n";
-                    visitSearch(scan, out);
+                    visitLoopBody();
                     out << "}\n";
                     out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
                 } else {
                     out << "for(const auto& env" << level << " : "
                         << "*" << relName << ") {\n";
-                    visitSearch(scan, out);
+                    visitLoopBody();
                     out << "}\n";
                 }
                 return;
@@ -614,6 +777,7 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             // get index to be queried
             auto keys = scan.getRangeQueryColumns();
             auto index = synthesiser.toIndex(keys);
+            scanPC = "getEqualRangePC" + index;
 
             // if this is the parallel level
             if (scan.getLevel() == 0 && !scan.isPureExistenceCheck()) {
@@ -621,7 +785,7 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
                 out << "try{";
                 out << "for(const auto& env0 : *it) {\n";
-                visitSearch(scan, out);
+                visitLoopBody();
                 out << "}\n";
                 out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
                 out << "}\n";
@@ -637,11 +801,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 << "equalRange" << index << "(key," << ctxName << ");\n";
             if (scan.isPureExistenceCheck()) {
                 out << "if(!range.empty()) {\n";
-                visitSearch(scan, out);
+                visitExistenceBody("range");
                 out << "}\n";
             } else {
                 out << "for(const auto& env" << level << " : range) {\n";
-                visitSearch(scan, out);
+                visitLoopBody();
                 out << "}\n";
             }
             PRINT_END_COMMENT(out);
@@ -684,36 +848,35 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             // declare environment variable
             out << tuple_type << " env" << level << ";\n";
 
-            // special case: counting of number elements in a full relation
-            if (aggregate.getFunction() == RamAggregate::COUNT && aggregate.getRangeQueryColumns() == 0) {
-                // shortcut: use relation size
-                out << "env" << level << "[0] = " << relName << "->"
-                    << "size();\n";
-                visitSearch(aggregate, out);
-                PRINT_END_COMMENT(out);
-                return;
-            }
+            // note: counting a full relation cannot use the relation size, since the
+            // count may differ between configurations
 
             // init result
             std::string init;
+            std::string fun;
             switch (aggregate.getFunction()) {
                 case RamAggregate::MIN:
                     init = "MAX_RAM_DOMAIN";
+                    fun = "LiftedAggregate::MIN";
                     break;
                 case RamAggregate::MAX:
                     init = "MIN_RAM_DOMAIN";
+                    fun = "LiftedAggregate::MAX";
                     break;
                 case RamAggregate::COUNT:
                     init = "0";
+                    fun = "LiftedAggregate::COUNT";
                     break;
                 case RamAggregate::SUM:
                     init = "0";
+                    fun = "LiftedAggregate::SUM";
                     break;
             }
-            out << "RamDomain res = " << init << ";\n";
+            out << "LiftedAggregate res(" << init << ");\n";
 
-            // get range to aggregate
+            // get range to aggregate, and the way of reading the presence conditions of its tuples
             auto keys = aggregate.getRangeQueryColumns();
+            std::string rangePC = "getScanPC";
 
             // check whether there is an index to use
             if (keys == 0) {
@@ -737,6 +900,7 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
                 // get index
                 auto index = synthesiser.toIndex(keys);
+                rangePC = "getEqualRangePC" + index;
                 out << "const " << tuple_type << " key({{";
                 printKeyTuple();
                 out << "}});\n";
@@ -749,59 +913,43 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << "if(!range.empty()) {\n";
             }
 
-            // aggregate result
+            // aggregate result, partitioned by the presence conditions of the tuples
             out << "for(const auto& cur : range) {\n";
 
             // create aggregation code
             if (aggregate.getFunction() == RamAggregate::COUNT) {
                 // count is easy
-                out << "++res\n;";
-            } else if (aggregate.getFunction() == RamAggregate::SUM) {
-                out << "env" << level << " = cur;\n";
-                out << "res += ";
-                visit(*aggregate.getTargetExpression(), out);
-                out << ";\n";
+                out << "res.accumulate(" << fun << ",1," << relName << "->" << rangePC << "(cur));\n";
             } else {
-                // pick function
-                std::string fun = "min";
-                switch (aggregate.getFunction()) {
-                    case RamAggregate::MIN:
-                        fun = "std::min";
-                        break;
-                    case RamAggregate::MAX:
-                        fun = "std::max";
-                        break;
-                    case RamAggregate::COUNT:
-                        assert(false);
-                    case RamAggregate::SUM:
-                        assert(false);
-                }
-
                 out << "env" << level << " = cur;\n";
-                out << "res = " << fun << "(res,";
+                out << "res.accumulate(" << fun << ",";
                 visit(*aggregate.getTargetExpression(), out);
-                out << ");\n";
+                out << "," << relName << "->" << rangePC << "(cur));\n";
             }
 
             // end aggregator loop
             out << "}\n";
 
-            // write result into environment tuple
-            out << "env" << level << "[0] = res;\n";
+            // continue with condition checks and nested body for each partition
+            out << "for(const auto& part : res.vals) {\n";
+            auto pc = declarePC(getPC() + "->conjoin(part.second)", out);
+            out << "if (!" << pc << "->isSAT()) continue;\n";
 
-            // continue with condition checks and nested body
-            out << "{\n";
+            // write result into environment tuple
+            out << "env" << level << "[0] = part.first;\n";
 
+            std::string outerPC = curPC;
+            curPC = pc;
             auto condition = aggregate.getCondition();
             if (condition) {
-                out << "if( ";
-                visit(condition, out);
-                out << ") {\n";
+                curPC = declarePC(pc, out);
+                auto end = visitConditionBegin(*condition, out);
                 visitSearch(aggregate, out);
-                out << "}\n";
+                out << end;
             } else {
                 visitSearch(aggregate, out);
             }
+            curPC = outerPC;
 
             out << "}\n";
 
@@ -819,12 +967,16 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             auto relName = synthesiser.getRelationName(rel);
             auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(rel) + ")";
 
+            // the presence condition of the projected tuple, narrowed down by negations
+            std::string outerPC = curPC;
+            out << "{\n";
+            curPC = declarePC(getPC(), out);
+
             // check condition
             auto condition = project.getCondition();
+            std::string endCondition;
             if (condition) {
-                out << "if (";
-                visit(condition, out);
-                out << ") {\n";
+                endCondition = visitConditionBegin(*condition, out);
             }
 
             // create projected tuple
@@ -837,13 +989,14 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             }
             if (project.hasFilter()) {
                 auto relFilter = synthesiser.getRelationName(project.getFilter());
-                auto ctxFilter = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(project.getFilter()) + ")";
-                out << "if (!" << relFilter << ".contains(tuple," << ctxFilter << ")) {";
+                out << curPC << " = " << curPC << "->conjoin(" << relFilter
+                    << "->getPC(tuple)->negate());\n";
+                out << "if (" << curPC << "->isSAT()) {";
             }
 
             // insert tuple
             out << relName << "->"
-                << "insert(tuple," << ctxName << ");\n";
+                << "insertLifted(tuple," << curPC << "," << ctxName << ");\n";
 
             // end filter
             if (project.hasFilter()) {
@@ -851,7 +1004,18 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             }
 
             // end condition
-            if (condition) {
+            out << endCondition;
+
+            out << "}\n";
+            curPC = outerPC;
+            PRINT_END_COMMENT(out);
+        }
+
+        void visitBranch(const RamBranch& branch, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            for (const RamOperation* cur : branch.getBranches()) {
+                out << "{\n";
+                visit(*cur, out);
                 out << "}\n";
             }
             PRINT_END_COMMENT(out);
@@ -918,19 +1082,19 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
                 // strings
                 case BinaryConstraintOp::MATCH: {
-                    out << "regex_wrapper(symTable.resolve(";
+                    out << "regex_wrapper(";
                     visit(rel.getLHS(), out);
-                    out << "),symTable.resolve(";
+                    out << ",";
                     visit(rel.getRHS(), out);
-                    out << "))";
+                    out << ")";
                     break;
                 }
                 case BinaryConstraintOp::NOT_MATCH: {
-                    out << "!regex_wrapper(symTable.resolve(";
+                    out << "!regex_wrapper(";
                     visit(rel.getLHS(), out);
-                    out << "),symTable.resolve(";
+                    out << ",";
                     visit(rel.getRHS(), out);
-                    out << "))";
+                    out << ")";
                     break;
                 }
                 case BinaryConstraintOp::CONTAINS: {
@@ -1244,27 +1408,48 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             os << "\n#ifdef USE_MPI\n";
             os << "{";
             os << "auto status = souffle::mpi::probe(";
-            // source
-            os << recv.getSourceStratum() + 1 << ", ";
+            // source, being the process of the stratum for the other processes of a partitioned stratum
+            os << "mpiGroup.isLeader() ? " << recv.getSourceStratum() + 1 << " : mpiGroup.getLeader(), ";
             // tag
             os << "tag_" << synthesiser.getRelationName(recv.getRelation());
             os << ");";
-            os << "souffle::mpi::recv<RamDomain>(";
+            os << "souffle::mpi::recvLifted<RamDomain>(";
             // data
             os << "*" << synthesiser.getRelationName(recv.getRelation()) << ", ";
             // arity
             os << recv.getRelation().getArity() << ", ";
             // status
             os << "status";
+            // symbol columns, whose symbols are prefetched
+            const SymbolMask& mask = recv.getRelation().getSymbolMask();
+            std::vector<size_t> symbolColumns;
+            for (size_t i = 0; i < recv.getRelation().getArity(); ++i) {
+                if (mask.isSymbol(i)) {
+                    symbolColumns.push_back(i);
+                }
+            }
+            if (!symbolColumns.empty()) {
+                os << ", symTable, std::vector<size_t>({" << join(symbolColumns, ",") << "})";
+            }
             os << ");";
+            // forward to the other processes of a partitioned stratum
+            os << "if (mpiGroup.isLeader() && mpiGroup.size() > 1) {";
+            os << "souffle::mpi::sendLifted<RamDomain>(";
+            os << "*" << synthesiser.getRelationName(recv.getRelation()) << ", ";
+            os << recv.getRelation().getArity() << ", ";
+            os << "mpiGroup.getHelpers(), ";
+            os << "tag_" << synthesiser.getRelationName(recv.getRelation());
+            os << ");";
+            os << "}";
             os << "}";
             os << "\n#endif\n";
         }
 
         void visitSend(const RamSend& send, std::ostream& os) override {
             os << "\n#ifdef USE_MPI\n";
-            os << "{";
-            os << "souffle::mpi::send<RamDomain>(";
+            // only the process of a partitioned stratum communicates with other strata
+            os << "if (mpiGroup.isLeader()) {";
+            os << "souffle::mpi::sendLifted<RamDomain>(";
             // data
             os << "*" << synthesiser.getRelationName(send.getRelation()) << ", ";
             // arity
@@ -1294,8 +1479,10 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitNotify(const RamNotify&, std::ostream& os) override {
             os << "\n#ifdef USE_MPI\n";
+            os << "if (mpiGroup.isLeader()) {";
             os << "mpi::send(0, SymbolTable::exitTag());";
             os << "mpi::recv(0, SymbolTable::exitTag());";
+            os << "}";
             os << "\n#endif\n";
         }
 
@@ -1305,6 +1492,28 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             os << "\n#endif\n";
         }
 
+        void visitExchange(const RamExchange& exchange, std::ostream& os) override {
+            os << "\n#ifdef USE_MPI\n";
+            os << "souffle::mpi::exchangeLifted<RamDomain>(";
+            os << "*" << synthesiser.getRelationName(exchange.getRelation()) << ", ";
+            os << exchange.getRelation().getArity() << ", ";
+            os << "mpiGroup, ";
+            os << "tag_" << synthesiser.getRelationName(exchange.getRelation());
+            os << ");";
+            os << "\n#endif\n";
+        }
+
+        void visitPartition(const RamPartition& partition, std::ostream& os) override {
+            os << "\n#ifdef USE_MPI\n";
+            os << "souffle::mpi::partitionLifted<RamDomain>(";
+            os << "*" << synthesiser.getRelationName(partition.getRelation()) << ", ";
+            os << partition.getRelation().getArity() << ", ";
+            os << "mpiGroup, ";
+            os << partition.getColumn();
+            os << ");";
+            os << "\n#endif\n";
+        }
+
 #endif
         // -- safety net --
 
@@ -1359,9 +1568,12 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
     // regex wrapper
     os << "private:\n";
-    os << "static inline bool regex_wrapper(const std::string& pattern, const std::string& text) {\n";
+    os << "RegexCache regexCache;\n";
+    os << "inline bool regex_wrapper(RamDomain patternIdx, RamDomain textIdx) {\n";
+    os << "   const std::string& pattern = symTable.resolve(patternIdx);\n";
+    os << "   const std::string& text = symTable.resolve(textIdx);\n";
     os << "   bool result = false; \n";
-    os << "   try { result = std::regex_match(text, std::regex(pattern)); } catch(...) { \n";
+    os << "   try { result = regexCache.match(patternIdx, pattern, text); } catch(...) { \n";
     os << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << \"\\\",\\\"\" "
           "<< text << \"\\\").\\n\";\n}\n";
     os << "   return result;\n";
@@ -1411,6 +1623,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             }
             os << "};";
         }
+        // the processes evaluating the stratum of this process
+        os << "public:\n";
+        os << "souffle::mpi::Group mpiGroup;";
         os << "\n#endif\n";
     }
 #endif
@@ -1527,7 +1742,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         }
     }
     os << "{\n";
-    os << "\tPresenceCondition::init(featSymTable);\n";
+    os << "\tPresenceCondition::init(featSymTable, R\"_(" << Global::config().get("feature-model") << ")_\", R\"_("
+       << Global::config().get("variable-order") << ")_\", R\"_(" << Global::config().get("bdd-reorder")
+       << ")_\");\n";
     os << registerRel;
     os << "}\n";
     // -- destructor --
@@ -1627,6 +1844,13 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     });
     os << "}\n";
 
+    // add code printing presence condition statistics
+    if (Global::config().has("verbose")) {
+        os << "\n// -- presence condition statistics --\n";
+        os << "std::cout << \"pcMap size:  \" << PresenceCondition::getPCCount() << std::endl;\n";
+        os << "PresenceCondition::printStats(std::cout);\n";
+    }
+
     os << "SignalHandler::instance()->reset();\n";
 
     os << "}\n";  // end of runFunction() method
@@ -1702,12 +1926,12 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             os << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
             os << "}\n";
             os << "IODirectives ioDirectives(directiveMap);\n";
+            os << "auto loader = makeRelationLoader(*" << getRelationName(load.getRelation()) << ");\n";
             os << "IOSystem::getInstance().getReader(";
             os << "SymbolMask({" << load.getRelation().getSymbolMask() << "})";
             os << ", symTable, featSymTable, ioDirectives";
             os << ", " << Global::config().has("provenance");
-            os << ")->readAll(*" << getRelationName(load.getRelation());
-            os << ");\n";
+            os << ")->readAll(loader);\n";
             os << "} catch (std::exception& e) {std::cerr << \"Error loading data: \" << e.what() << "
                   "'\\n';}\n";
         }
@@ -1846,9 +2070,34 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     if (Global::config().get("engine") == "mpi") {
         os << "\n#ifdef USE_MPI\n";
         os << "\t\tsouffle::mpi::init(argc, argv);";
+        // the strata, and the strata whose recursive relations are partitioned
+        int strata = 0;
+        std::vector<int> partitioned;
+        visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
+            if (stratum.getIndex() == std::numeric_limits<int>::max()) {
+                return;
+            }
+            ++strata;
+            bool exchanges = false;
+            visitDepthFirst(stratum, [&](const RamExchange&) { exchanges = true; });
+            if (exchanges) {
+                partitioned.push_back(stratum.getIndex());
+            }
+        });
         os << "\t\tint rank = souffle::mpi::commRank();";
-        os << "\t\tint stratum = (rank == 0) ? " << std::numeric_limits<int>::max() << " : rank - 1;";
-        os << "\t\tobj.runAll(opt.getInputFileDir(), opt.getOutputFileDir(), stratum);\n";
+        os << "\t\tstd::vector<int> partitioned({" << join(partitioned, ",") << "});";
+        os << "\t\tint stratum = (rank == 0) ? " << std::numeric_limits<int>::max()
+           << " : souffle::mpi::Group::getStratum(rank, " << strata << ", partitioned);";
+        os << "\t\tif (rank != 0 && stratum >= 0) {";
+        os << "\t\t\tobj.mpiGroup = souffle::mpi::Group::getGroup(rank, stratum, " << strata
+           << ", partitioned, souffle::mpi::commSize());";
+        os << "\t\t}";
+        // the other processes of a partitioned stratum only contribute to its evaluation
+        os << "\t\tif (rank == 0 || rank <= " << strata << ") {";
+        os << "\t\t\tobj.runAll(opt.getInputFileDir(), opt.getOutputFileDir(), stratum);\n";
+        os << "\t\t} else if (stratum >= 0) {";
+        os << "\t\t\tobj.run(stratum);\n";
+        os << "\t\t}";
         os << "\t\tsouffle::mpi::finalize();";
         os << "\n#endif\n";
     } else
@@ -20,6 +20,9 @@
 #include "SymbolTable.h"
 #include "PresenceCondition.h"
 
+#include <string>
+#include <unordered_map>
+
 namespace souffle {
 
 class WriteStream {
@@ -32,20 +35,37 @@ public:
             : symbolMask(symbolMask), symbolTable(symbolTable), featSymTable(featSymT), isProvenance(prov) {}
     template <typename T>
     void writeAll(const T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
-
+#ifdef USE_MPI
+        // request the symbols of the relation at once rather than one by one
+        std::vector<RamDomain> symbols;
+        for (const auto& current : relation) {
+            for (size_t col = 0; col < symbolMask.getArity(); ++col) {
+                if (symbolMask.isSymbol(col)) {
+                    symbols.push_back(current[col]);
+                }
+            }
+        }
+        symbolTable.prefetch(symbols);
+#endif
         for (const auto& current : relation) {
             recordCount++;
             const PresenceCondition* pc = relation.getPC(current);
             writeNext(current, pc);
         }
+        writeEnd();
+    }
+
+    /** Write presence conditions as irredundant covers rather than as composed */
+    void setMinimalConditions(bool minimal) {
+        minimalConditions = minimal;
     }
 
     virtual ~WriteStream() = default;
 
 protected:
     virtual void writeNextTuple(const RamDomain* tuple, const PresenceCondition* pc) = 0;
+    /** Called once all tuples have been written, for writers which buffer the relation */
+    virtual void writeEnd() {}
     template <typename Tuple>
     void writeNext(const Tuple tuple, const PresenceCondition* pc) {
         writeNextTuple(tuple.data, pc);
@@ -54,6 +74,24 @@ protected:
     const SymbolTable& symbolTable;
     const SymbolTable& featSymTable;
     const bool isProvenance;
+
+    /** Obtain the text of a presence condition as written */
+    std::string getConditionText(const PresenceCondition* pc) {
+        if (!minimalConditions) {
+            return pc->getText();
+        }
+        auto pos = minimalTexts.find(pc->getId());
+        if (pos != minimalTexts.end()) {
+            return pos->second;
+        }
+        return minimalTexts[pc->getId()] = pc->getMinimalText();
+    }
+
+private:
+    bool minimalConditions = false;
+
+    /** The minimal texts of the conditions written so far, by id */
+    std::unordered_map<size_t, std::string> minimalTexts;
 };
 
 class WriteStreamFactory {
@@ -0,0 +1,170 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteStreamBinary.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "BinaryFormat.h"
+#include "IODirectives.h"
+#include "PresenceCondition.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStream.h"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Writes a relation in the columnar binary format of BinaryFormat.h. As the
+ * columns are stored one after the other, tuples are buffered until the
+ * relation has been written completely.
+ */
+class WriteFileBinary : public WriteStream {
+public:
+    WriteFileBinary(const SymbolMask& symbolMask, const SymbolTable& symbolTable, const SymbolTable& featSymT,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : WriteStream(symbolMask, symbolTable, featSymT, provenance), fileName(ioDirectives.getFileName()),
+              columns(symbolMask.getArity() + 1) {}
+
+    ~WriteFileBinary() override = default;
+
+protected:
+    void writeNextTuple(const RamDomain* tuple, const PresenceCondition* pc) override {
+        size_t arity = symbolMask.getArity();
+        for (size_t col = 0; col < arity; ++col) {
+            columns[col].push_back(symbolMask.isSymbol(col) ? getSymbol(tuple[col]) : tuple[col]);
+        }
+        if (!pc->isTrue()) {
+            pcCount++;
+        }
+        columns[arity].push_back(getPresenceCondition(pc));
+    }
+
+    void writeEnd() override {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::invalid_argument("Cannot open output file " + fileName);
+        }
+
+        binary::Header header;
+        std::memcpy(header.magic, binary::MAGIC, sizeof(header.magic));
+        header.version = binary::VERSION;
+        header.domainSize = sizeof(RamDomain);
+        header.arity = symbolMask.getArity();
+        header.tuples = columns[0].size();
+        header.symbolOffset = binary::columnOffset(header, header.arity + 1);
+        header.pcOffset = header.symbolOffset + segmentSize(symbols);
+        write(file, &header, sizeof(header));
+
+        for (const auto& column : columns) {
+            write(file, column.data(), column.size() * sizeof(RamDomain));
+            pad(file, column.size() * sizeof(RamDomain));
+        }
+        writeSegment(file, symbols);
+        writeSegment(file, pcs);
+
+        if (!file) {
+            throw std::invalid_argument("Error writing output file " + fileName);
+        }
+    }
+
+private:
+    /** Obtain the number of a symbol within the file */
+    RamDomain getSymbol(RamDomain index) {
+        auto pos = symbolNumbers.find(index);
+        if (pos != symbolNumbers.end()) {
+            return pos->second;
+        }
+        RamDomain number = symbols.size();
+        symbols.push_back(symbolTable.unsafeResolve(index));
+        symbolNumbers[index] = number;
+        return number;
+    }
+
+    /** Obtain the number of a presence condition within the file */
+    RamDomain getPresenceCondition(const PresenceCondition* pc) {
+        auto pos = pcNumbers.find(pc->getId());
+        if (pos != pcNumbers.end()) {
+            return pos->second;
+        }
+        RamDomain number = pcs.size();
+        pcs.push_back(getConditionText(pc));
+        pcNumbers[pc->getId()] = number;
+        return number;
+    }
+
+    static void write(std::ofstream& file, const void* data, uint64_t size) {
+        file.write(reinterpret_cast<const char*>(data), size);
+    }
+
+    static void pad(std::ofstream& file, uint64_t size) {
+        static const char zeros[8] = {0};
+        write(file, zeros, binary::align(size) - size);
+    }
+
+    static uint64_t segmentSize(const std::vector<std::string>& strings) {
+        uint64_t length = 0;
+        for (const auto& cur : strings) {
+            length += cur.size();
+        }
+        return sizeof(uint64_t) * (strings.size() + 2) + binary::align(length);
+    }
+
+    static void writeSegment(std::ofstream& file, const std::vector<std::string>& strings) {
+        std::vector<uint64_t> offsets;
+        offsets.reserve(strings.size() + 2);
+        offsets.push_back(strings.size());
+        offsets.push_back(0);
+        for (const auto& cur : strings) {
+            offsets.push_back(offsets.back() + cur.size());
+        }
+        write(file, offsets.data(), offsets.size() * sizeof(uint64_t));
+        for (const auto& cur : strings) {
+            write(file, cur.data(), cur.size());
+        }
+        pad(file, offsets.back());
+    }
+
+    const std::string fileName;
+
+    /** The attribute columns, followed by the presence condition column */
+    std::vector<std::vector<RamDomain>> columns;
+
+    std::vector<std::string> symbols;
+    std::unordered_map<RamDomain, RamDomain> symbolNumbers;
+
+    std::vector<std::string> pcs;
+    std::unordered_map<RamDomain, RamDomain> pcNumbers;
+};
+
+class WriteFileBinaryFactory : public WriteStreamFactory {
+public:
+    std::unique_ptr<WriteStream> getWriter(const SymbolMask& symbolMask, const SymbolTable& symbolTable,
+            const SymbolTable& featSymT, const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<WriteFileBinary>(symbolMask, symbolTable, featSymT, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~WriteFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
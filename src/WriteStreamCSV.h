@@ -81,7 +81,7 @@ protected:
 
         if (!pc->isTrue()) {
             pcCount++;
-            file << "\t@ " << *pc;
+            file << "\t@ " << getConditionText(pc);
         }
 
         file << "\n";
@@ -136,7 +136,7 @@ protected:
 
         if (!pc->isTrue()) {
             pcCount++;
-            file << "\t@ " << *pc;
+            file << "\t@ " << getConditionText(pc);
         }
         file << "\n";
     }
@@ -191,7 +191,7 @@ protected:
 
         if (!pc->isTrue()) {
             pcCount++;
-            std::cout << "\t@ " << *pc;
+            std::cout << "\t@ " << getConditionText(pc);
         }
         std::cout << "\n";
     }
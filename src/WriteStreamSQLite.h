@@ -13,7 +13,8 @@
  ***********************************************************************/
 
 #pragma once
-#if 0
+
+#include "PresenceCondition.h"
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 #include "WriteStream.h"
@@ -27,11 +28,18 @@
 
 namespace souffle {
 
+/**
+ * Writes a relation to the table _<relation> of an SQLite database, with the symbols of the
+ * tuples stored in a shared symbol table and the presence condition of each tuple stored in
+ * its trailing pc column, which references a shared table of deduplicated presence
+ * conditions. The view <relation> resolves both.
+ */
 class WriteStreamSQLite : public WriteStream {
 public:
     WriteStreamSQLite(const std::string& dbFilename, const std::string& relationName,
-            const SymbolMask& symbolMask, const SymbolTable& symbolTable, const bool provenance)
-            : WriteStream(symbolMask, symbolTable, provenance), dbFilename(dbFilename),
+            const SymbolMask& symbolMask, const SymbolTable& symbolTable, const SymbolTable& featSymT,
+            const bool provenance)
+            : WriteStream(symbolMask, symbolTable, featSymT, provenance), dbFilename(dbFilename),
               relationName(relationName) {
         if (provenance) {
             arity = symbolMask.getArity() - 2;
@@ -49,11 +57,13 @@ public:
         sqlite3_finalize(insertStatement);
         sqlite3_finalize(symbolInsertStatement);
         sqlite3_finalize(symbolSelectStatement);
+        sqlite3_finalize(pcInsertStatement);
+        sqlite3_finalize(pcSelectStatement);
         sqlite3_close(db);
     }
 
 protected:
-    void writeNextTuple(const RamDomain* tuple) override {
+    void writeNextTuple(const RamDomain* tuple, const PresenceCondition* pc) override {
         if (arity == 0) {
             return;
         }
@@ -73,34 +83,8 @@ protected:
                 throwError("SQLite error in sqlite3_bind_text: ");
             }
         }
-        if (sqlite3_step(insertStatement) != SQLITE_DONE) {
-            throwError("SQLite error in sqlite3_step: ");
-        }
-        sqlite3_clear_bindings(insertStatement);
-        sqlite3_reset(insertStatement);
-    }
-
-    void writeNextTuple(const RamRecord* record) override {
-        if (arity == 0) {
-            return;
-        }
-
-        const RamDomain* tuple = record->field;
-        
-        for (size_t i = 0; i < arity; i++) {
-            RamDomain value;
-            if (symbolMask.isSymbol(i)) {
-                value = getSymbolTableID(tuple[i]);
-            } else {
-                value = tuple[i];
-            }
-#if RAM_DOMAIN_SIZE == 64
-            if (sqlite3_bind_int64(insertStatement, i + 1, value) != SQLITE_OK) {
-#else
-            if (sqlite3_bind_int(insertStatement, i + 1, value) != SQLITE_OK) {
-#endif
-                throwError("SQLite error in sqlite3_bind_text: ");
-            }
+        if (sqlite3_bind_int64(insertStatement, arity + 1, getPresenceConditionID(pc)) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_bind_int64: ");
         }
         if (sqlite3_step(insertStatement) != SQLITE_DONE) {
             throwError("SQLite error in sqlite3_step: ");
@@ -169,6 +153,42 @@ private:
         return rowid;
     }
 
+    uint64_t getPresenceConditionIDFromDB(const std::string& text) {
+        if (sqlite3_bind_text(pcSelectStatement, 1, text.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_bind_text: ");
+        }
+        if (sqlite3_step(pcSelectStatement) != SQLITE_ROW) {
+            throwError("SQLite error in sqlite3_step: ");
+        }
+        uint64_t rowid = sqlite3_column_int64(pcSelectStatement, 0);
+        sqlite3_clear_bindings(pcSelectStatement);
+        sqlite3_reset(pcSelectStatement);
+        return rowid;
+    }
+    uint64_t getPresenceConditionID(const PresenceCondition* pc) {
+        auto pos = dbPresenceConditions.find(pc->getId());
+        if (pos != dbPresenceConditions.end()) {
+            return pos->second;
+        }
+
+        std::string text = getConditionText(pc);
+        if (sqlite3_bind_text(pcInsertStatement, 1, text.c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_bind_text: ");
+        }
+        // Either the insert succeeds or the condition has been stored by another relation.
+        uint64_t rowid;
+        if (sqlite3_step(pcInsertStatement) != SQLITE_DONE) {
+            rowid = getPresenceConditionIDFromDB(text);
+        } else {
+            rowid = sqlite3_last_insert_rowid(db);
+        }
+        sqlite3_clear_bindings(pcInsertStatement);
+        sqlite3_reset(pcInsertStatement);
+
+        dbPresenceConditions[pc->getId()] = rowid;
+        return rowid;
+    }
+
     void openDB() {
         if (sqlite3_open(dbFilename.c_str(), &db) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_open");
@@ -182,6 +202,18 @@ private:
         prepareInsertStatement();
         prepareSymbolInsertStatement();
         prepareSymbolSelectStatement();
+        preparePresenceConditionStatements();
+    }
+    void preparePresenceConditionStatements() {
+        const char* tail = nullptr;
+        std::string insertSQL = "INSERT INTO " + pcTableName + " VALUES(null,@V0);";
+        if (sqlite3_prepare_v2(db, insertSQL.c_str(), -1, &pcInsertStatement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        std::string selectSQL = "SELECT id FROM " + pcTableName + " WHERE pc = @V0;";
+        if (sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &pcSelectStatement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
     }
     void prepareSymbolInsertStatement() {
         std::stringstream insertSQL;
@@ -207,7 +239,7 @@ private:
         std::stringstream insertSQL;
         insertSQL << "INSERT INTO _" << relationName << " VALUES ";
         insertSQL << "(@V0";
-        for (unsigned int i = 1; i < arity; i++) {
+        for (unsigned int i = 1; i <= arity; i++) {
             insertSQL << ",@V" << i;
         }
         insertSQL << ");";
@@ -221,6 +253,7 @@ private:
         createRelationTable();
         createRelationView();
         createSymbolTable();
+        createPresenceConditionTable();
     }
 
     void createRelationTable() {
@@ -232,6 +265,7 @@ private:
                 createTableText << ",'" << std::to_string(i) << "' ";
                 createTableText << "INTEGER";
             }
+            createTableText << ",'pc' INTEGER";
         }
         createTableText << ");";
         executeSQL(createTableText.str(), db);
@@ -266,6 +300,15 @@ private:
                             << "'_symtab_" << columnName << "'.id";
             }
         }
+        if (arity > 0) {
+            projectionClause << ",'_pc'.pc AS 'pc'";
+            fromClause << ",'" << pcTableName << "' AS '_pc'";
+            if (!firstWhere) {
+                whereClause << " AND ";
+            }
+            firstWhere = false;
+            whereClause << "'_" << relationName << "'.'pc' = '_pc'.id";
+        }
         createViewText << "SELECT " << projectionClause.str() << " FROM " << fromClause.str();
         if (!firstWhere) {
             createViewText << " WHERE " << whereClause.str();
@@ -279,26 +322,37 @@ private:
         createTableText << "(id INTEGER PRIMARY KEY, symbol TEXT UNIQUE);";
         executeSQL(createTableText.str(), db);
     }
+    void createPresenceConditionTable() {
+        std::stringstream createTableText;
+        createTableText << "CREATE TABLE IF NOT EXISTS '" << pcTableName << "' ";
+        createTableText << "(id INTEGER PRIMARY KEY, pc TEXT UNIQUE);";
+        executeSQL(createTableText.str(), db);
+    }
 
-    const std::string& dbFilename;
-    const std::string& relationName;
+    const std::string dbFilename;
+    const std::string relationName;
     const std::string symbolTableName = "__SymbolTable";
+    const std::string pcTableName = "__PresenceConditions";
     size_t arity;
 
     std::unordered_map<uint64_t, uint64_t> dbSymbolTable;
+    std::unordered_map<RamDomain, uint64_t> dbPresenceConditions;
     sqlite3_stmt* insertStatement = nullptr;
     sqlite3_stmt* symbolInsertStatement = nullptr;
     sqlite3_stmt* symbolSelectStatement = nullptr;
+    sqlite3_stmt* pcInsertStatement = nullptr;
+    sqlite3_stmt* pcSelectStatement = nullptr;
     sqlite3* db = nullptr;
 };
 
 class WriteSQLiteFactory : public WriteStreamFactory {
 public:
     std::unique_ptr<WriteStream> getWriter(const SymbolMask& symbolMask, const SymbolTable& symbolTable,
-            const IODirectives& ioDirectives, const bool provenance) override {
+            const SymbolTable& featSymT, const IODirectives& ioDirectives, const bool provenance) override {
         std::string dbName = ioDirectives.get("dbname");
         std::string relationName = ioDirectives.getRelationName();
-        return std::make_unique<WriteStreamSQLite>(dbName, relationName, symbolMask, symbolTable, provenance);
+        return std::make_unique<WriteStreamSQLite>(
+                dbName, relationName, symbolMask, symbolTable, featSymT, provenance);
     }
     const std::string& getName() const override {
         static const std::string name = "sqlite";
@@ -308,4 +362,3 @@ public:
 };
 
 } /* namespace souffle */
-#endif // 0
\ No newline at end of file
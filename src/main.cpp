@@ -28,9 +28,12 @@
 #include "InterpreterInterface.h"
 #include "ParserDriver.h"
 #include "PrecedenceGraph.h"
+#include "PresenceCondition.h"
+#include "ProductEvaluator.h"
 #include "RamProgram.h"
 #include "RamSemanticChecker.h"
 #include "RamTransformer.h"
+#include "RamTransforms.h"
 #include "RamTranslationUnit.h"
 #include "SymbolTable.h"
 #include "Synthesiser.h"
@@ -200,18 +203,36 @@ int main(int argc, char** argv) {
                             {"live-profile", 'l', "", "", false, "Enable live profiling."},
                             {"profile", 'p', "FILE", "", false,
                                     "Enable profiling, and write profile data to <FILE>."},
+                            {"profile-use", '\0', "FILE", "", false,
+                                    "Order the atoms of rules by the relation statistics in the profile "
+                                    "log <FILE> of a previous run."},
                             {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
 #ifdef USE_PROVENANCE
                             {"provenance", 't', "EXPLAIN", "", false,
                                     "Enable provenance information via guided SLD."},
 #endif
                             {"data-structure", 'd', "type", "", false,
-                                    "Specify data structure (brie/btree/eqrel/rbtset/hashset)."},
+                                    "Specify data structure (brie/btree/eqrel/rbtset/hashset/bdd)."},
                             {"engine", 'e', "[ file | mpi ]", "", false,
                                     "Specify communication engine for distributed execution."},
                             {"hostfile", '\0', "FILE", "", false,
                                     "Specify --hostfile option for call to mpiexec when using mpi as "
                                     "execution engine."},
+                            {"partitions", '\0', "N", "1", false,
+                                    "Evaluate each recursive stratum with N processes when using mpi as "
+                                    "execution engine."},
+                            {"feature-model", '\0', "FILE", "", false,
+                                    "Restrict presence conditions to the configurations satisfying the "
+                                    "feature model formula in <FILE>."},
+                            {"variable-order", '\0', "FILE", "", false,
+                                    "Order the BDD variables of features as listed in <FILE>."},
+                            {"bdd-reorder", '\0', "MODE", "", false,
+                                    "Enable dynamic BDD variable reordering (none/sift/sift-converge/"
+                                    "symm-sift/group-sift/lazy-sift/window2/window3/window4/annealing/"
+                                    "genetic/linear/exact/random)."},
+                            {"products", '\0', "[ auto | all | FILE ]", "", false,
+                                    "Interpret each configuration separately instead of lifted, for all "
+                                    "configurations, those listed in <FILE>, or if estimated to be faster."},
                             {"verbose", 'v', "", "", false, "Verbose output."},
                             {"help", 'h', "", "", false, "Display this help message."}};
                     return std::vector<MainOption>(std::begin(opts), std::end(opts));
@@ -230,6 +251,11 @@ int main(int argc, char** argv) {
             throw std::runtime_error("cannot open file " + std::string(Global::config().get("")));
         }
 
+        /* check that the profile log guiding the join order exists */
+        if (Global::config().has("profile-use") && !existFile(Global::config().get("profile-use"))) {
+            throw std::runtime_error("cannot open profile log " + Global::config().get("profile-use"));
+        }
+
         /* for the jobs option, to determine the number of threads used */
         if (Global::config().has("jobs")) {
 #ifdef _OPENMP
@@ -310,6 +336,11 @@ int main(int argc, char** argv) {
             if (engine != "file" && engine != "mpi") {
                 throw std::invalid_argument("Error: Use of engine '" + engine + "' is not supported.");
             }
+            if (!isNumber(Global::config().get("partitions").c_str()) ||
+                    std::stoi(Global::config().get("partitions")) < 1) {
+                throw std::invalid_argument(
+                        "Wrong parameter " + Global::config().get("partitions") + " for option --partitions!");
+            }
 #ifndef USE_MPI
             if (engine == "mpi") {
                 throw std::invalid_argument("Error: Use of engine '" + engine +
@@ -319,14 +350,34 @@ int main(int argc, char** argv) {
                 throw std::invalid_argument(
                         "Error: Use of hostfile option requires configure option '--enable-" + engine + "'.");
             }
+            if (Global::config().get("partitions") != "1") {
+                throw std::invalid_argument(
+                        "Error: Use of partitions option requires configure option '--enable-" + engine + "'.");
+            }
 #else
             if (engine != "mpi" && Global::config().has("hostfile")) {
                 throw std::invalid_argument(
                         "Error: Use of hostfile option requires execution engine '" + engine + "'.");
             }
+            if (engine != "mpi" && Global::config().get("partitions") != "1") {
+                throw std::invalid_argument(
+                        "Error: Use of partitions option requires execution engine '" + engine + "'.");
+            }
 #endif
         }
 
+        /* product evaluation is only supported by the interpreter */
+        if (Global::config().has("products")) {
+            if (Global::config().has("compile") || Global::config().has("generate")) {
+                throw std::invalid_argument("Error: Use of products option not available for the compiler.");
+            }
+            if (Global::config().has("provenance") || Global::config().has("profile") ||
+                    Global::config().has("live-profile")) {
+                throw std::invalid_argument(
+                        "Error: Use of products option not available with provenance or profiling.");
+            }
+        }
+
         if (Global::config().has("live-profile") && !Global::config().has("profile")) {
             Global::config().set("profile");
         }
@@ -440,6 +491,8 @@ int main(int argc, char** argv) {
             std::make_unique<MaterializeAggregationQueriesTransformer>(),
             std::make_unique<RemoveEmptyRelationsTransformer>(),
             std::make_unique<RemoveRedundantRelationsTransformer>(), std::move(magicPipeline),
+            std::make_unique<ConditionalTransformer>(
+                    Global::config().has("profile-use"), std::make_unique<JoinOrderTransformer>()),
             std::make_unique<AstExecutionPlanChecker>(), std::move(provenancePipeline));
 
     // Set up the debug report if necessary
@@ -461,14 +514,30 @@ int main(int argc, char** argv) {
     // ------- execution -------------
 
     // initialize the PresenceCondition library (and Cudd)
-    PresenceCondition::init(featSymTab);
+    try {
+        PresenceCondition::init(featSymTab, Global::config().get("feature-model"),
+                Global::config().get("variable-order"), Global::config().get("bdd-reorder"));
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        exit(1);
+    }
 
     /* translate AST to RAM */
     std::unique_ptr<RamTranslationUnit> ramTranslationUnit =
             AstTranslator().translateUnit(*astTranslationUnit);
 
+    // RAM optimisation pipeline, shared by the interpreter and the synthesiser
+    auto ramPipeline = std::make_unique<RamPipelineTransformer>(std::make_unique<HoistConditionsTransformer>(),
+            std::make_unique<RemoveRedundantExistenceChecksTransformer>(),
+            std::make_unique<CreateIndicesTransformer>(), std::make_unique<MergeInsertsTransformer>());
+    if (!Global::config().get("debug-report").empty()) {
+        ramPipeline->setDebugReport();
+    }
+    ramPipeline->setVerbosity(Global::config().has("verbose"));
+
     std::vector<std::unique_ptr<RamTransformer>> ramTransforms;
     ramTransforms.push_back(std::make_unique<RamSemanticChecker>());
+    ramTransforms.push_back(std::move(ramPipeline));
 
     for (const auto& transform : ramTransforms) {
         transform->apply(*ramTranslationUnit);
@@ -486,6 +555,15 @@ int main(int argc, char** argv) {
         std::cerr << ramTranslationUnit->getErrorReport();
     }
 
+    // write the debug report, including the sections of the RAM passes
+    if (!Global::config().get("debug-report").empty()) {
+        const DebugReport& debugReport = ramTranslationUnit->getDebugReport();
+        if (!debugReport.empty()) {
+            std::ofstream debugReportStream(Global::config().get("debug-report"));
+            debugReportStream << debugReport;
+        }
+    }
+
     if (!ramTranslationUnit->getProgram()->getMain()) {
         return 0;
     };
@@ -494,6 +572,49 @@ int main(int argc, char** argv) {
             !Global::config().has("generate")) {
         // ------- interpreter -------------
 
+        // decide whether to evaluate each configuration separately
+        std::vector<ProductEvaluator::Configuration> products;
+        if (Global::config().has("products")) {
+            try {
+                const std::string& mode = Global::config().get("products");
+                if (mode == "all" || mode == "auto") {
+                    size_t threads = std::stoi(Global::config().get("jobs"));
+                    if (threads == 0) {
+                        threads = std::thread::hardware_concurrency();
+                    }
+                    double count = PresenceCondition::countConfigurations();
+                    bool preferable = ProductEvaluator::isPreferable(featSymTab.size(), count, threads);
+                    if (Global::config().has("verbose")) {
+                        std::cout << count << " configurations of " << featSymTab.size() << " features, "
+                                  << (preferable ? "product" : "lifted") << " evaluation is preferable"
+                                  << std::endl;
+                    }
+                    if (mode == "all" || preferable) {
+                        if (!PresenceCondition::enumerateConfigurations(
+                                    ProductEvaluator::MAX_PRODUCTS, products)) {
+                            throw std::runtime_error("Error: More than " +
+                                                     std::to_string(ProductEvaluator::MAX_PRODUCTS) +
+                                                     " configurations to be evaluated.");
+                        }
+                    }
+                } else {
+                    products = ProductEvaluator::readConfigurations(mode);
+                }
+            } catch (std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                exit(1);
+            }
+        }
+
+        if (!products.empty()) {
+            if (Global::config().has("verbose")) {
+                std::cout << "Evaluating " << products.size() << " products" << std::endl;
+            }
+            ProductEvaluator(*ramTranslationUnit, std::move(products), PresenceCondition::getFeatureModel())
+                    .execute();
+            return 0;
+        }
+
         // configure interpreter
         std::unique_ptr<Interpreter> interpreter = std::make_unique<Interpreter>(*ramTranslationUnit);
 
@@ -571,10 +692,24 @@ int main(int argc, char** argv) {
                 }
                 // run compiled C++ program if requested.
                 if (!Global::config().has("dl-program")) {
+#ifdef USE_MPI
+                    // one process per stratum and the master process, and further processes for the
+                    // partitioned recursive strata
+                    const auto* sccGraph = astTranslationUnit->getAnalysis<SCCGraph>();
+                    int numberOfProcesses = (int)sccGraph->getNumberOfSCCs() + 1;
+                    if (Global::config().get("engine") == "mpi") {
+                        const int partitions = std::stoi(Global::config().get("partitions"));
+                        for (size_t scc = 0; scc < sccGraph->getNumberOfSCCs(); ++scc) {
+                            if (sccGraph->isRecursive(scc)) {
+                                numberOfProcesses += partitions - 1;
+                            }
+                        }
+                    }
+#endif
                     executeBinary(baseFilename
 #ifdef USE_MPI
                             ,
-                            ((int)astTranslationUnit->getAnalysis<SCCGraph>()->getNumberOfSCCs()) + 1
+                            numberOfProcesses
 #endif
                     );
                 }
@@ -597,6 +732,7 @@ int main(int argc, char** argv) {
                   << "sec\n";
         std::cout << "Features:    "  << PresenceCondition::getFeatCount() << std::endl;
         std::cout << "pcMap size:  "  << PresenceCondition::getPCCount() << std::endl;
+        PresenceCondition::printStats(std::cout);
         std::cout << "Facts:       "  << ReadStream::recordCount << std::endl;
         std::cout << "Facts@PCs:   "  << ReadStream::pcCount << std::endl;
         std::cout << "Records:     "  << WriteStream::recordCount << std::endl;
@@ -99,6 +99,7 @@
 %token EQREL_QUALIFIER           "equivalence relation qualifier"
 %token RBTSET_QUALIFIER          "red-black tree set relation qualifier"
 %token HASHSET_QUALIFIER         "hashset relation qualifier"
+%token BDD_QUALIFIER             "BDD relation qualifier"
 %token OVERRIDABLE_QUALIFIER     "relation qualifier overidable"
 %token INLINE_QUALIFIER          "relation qualifier inline"
 %token TMATCH                    "match predicate"
@@ -376,25 +377,29 @@ qualifiers
         $$ = $1 | INLINE_RELATION;
     }
   | qualifiers BRIE_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
         $$ = $1 | BRIE_RELATION;
     }
   | qualifiers BTREE_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
         $$ = $1 | BTREE_RELATION;
     }
   | qualifiers EQREL_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
         $$ = $1 | EQREL_RELATION;
     }
   | qualifiers RBTSET_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
         $$ = $1 | RBTSET_RELATION;
     }
   | qualifiers HASHSET_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
         $$ = $1 | HASHSET_RELATION;
     }
+  | qualifiers BDD_QUALIFIER {
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|BDD_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/bdd qualifier already set");
+        $$ = $1 | BDD_RELATION;
+    }
   | %empty {
         $$ = 0;
     }
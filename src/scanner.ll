@@ -100,6 +100,7 @@
 "eqrel"                               { return yy::parser::make_EQREL_QUALIFIER(yylloc); }
 "rbtset"                              { return yy::parser::make_RBTSET_QUALIFIER(yylloc); }
 "hashset"                             { return yy::parser::make_HASHSET_QUALIFIER(yylloc); }
+"bdd"                                 { return yy::parser::make_BDD_QUALIFIER(yylloc); }
 "inline"                              { return yy::parser::make_INLINE_QUALIFIER(yylloc); }
 "brie"                                { return yy::parser::make_BRIE_QUALIFIER(yylloc); }
 "btree"                               { return yy::parser::make_BTREE_QUALIFIER(yylloc); }
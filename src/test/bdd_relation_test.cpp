@@ -0,0 +1,207 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file bdd_relation_test.cpp
+ *
+ * Test cases for the lifted relations represented by BDDs
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "pc_test.h"
+
+#include "BddRelation.h"
+#include "InterpreterRelation.h"
+#include "PresenceCondition.h"
+#include "SymbolTable.h"
+
+#include <limits>
+#include <vector>
+
+namespace souffle {
+namespace test {
+
+namespace {
+
+/** The presence condition of a binary tuple, or False if the tuple is not contained */
+const PresenceCondition* getPC(const BddRelation& rel, RamDomain x, RamDomain y) {
+    RamDomain tuple[2] = {x, y};
+    return rel.getPC(tuple);
+}
+
+using Column = BddRelation::Column;
+
+Column domain(size_t index) {
+    return {Column::DOMAIN, RamDomain(index)};
+}
+
+Column constant(RamDomain value) {
+    return {Column::CONSTANT, value};
+}
+
+}  // namespace
+
+TEST(BddRelation, Insert) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    BddRelation rel(2);
+    EXPECT_TRUE(rel.empty());
+
+    // presence conditions of duplicates are disjoined, and False tuples are dropped
+    RamDomain data[] = {3, 1, a->getId(), -7, 2, b->getId(), 3, 1, b->getId(), 2, 2,
+            PresenceCondition::makeFalse()->getId()};
+    std::vector<const RamDomain*> tuples = {&data[0], &data[3], &data[6], &data[9]};
+    rel.insertAll(tuples);
+    EXPECT_EQ(2, rel.size());
+    EXPECT_EQ(a->disjoin(b), getPC(rel, 3, 1));
+    EXPECT_EQ(b, getPC(rel, -7, 2));
+    EXPECT_EQ(PresenceCondition::makeFalse(), getPC(rel, 2, 2));
+    EXPECT_EQ(PresenceCondition::makeFalse(), getPC(rel, 1, 3));
+
+    // union
+    BddRelation other(2);
+    RamDomain tuple[3] = {1, 3, PresenceCondition::makeTrue()->getId()};
+    other.insert(tuple);
+    rel.insert(other);
+    EXPECT_EQ(3, rel.size());
+    EXPECT_EQ(PresenceCondition::makeTrue(), getPC(rel, 1, 3));
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+}
+
+TEST(BddRelation, Size) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+
+    // tuples which differ in the least significant bit only, and one under another condition
+    BddRelation rel(2);
+    RamDomain data[] = {6, 1, a->getId(), 7, 1, a->getId(), 7, 2, a->negate()->getId()};
+    rel.insertAll({&data[0], &data[3], &data[6]});
+    EXPECT_EQ(3, rel.size());
+
+    // a column of any value, and counts beyond the range of size_t
+    BddRelation::Term term(PresenceCondition::makeTrue());
+    BddRelation column(2);
+    column.insert(term, {domain(0), constant(1)});
+    EXPECT_EQ(size_t(1) << BddRelation::BITS, column.size());
+    BddRelation all(2);
+    all.insert(term, {domain(0), domain(1)});
+    EXPECT_EQ(std::numeric_limits<size_t>::max(), all.size());
+}
+
+TEST(BddRelation, Decode) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    BddRelation rel(2);
+    RamDomain t1[3] = {0, MAX_RAM_DOMAIN, a->conjoin(b->negate())->getId()};
+    RamDomain t2[3] = {MIN_RAM_DOMAIN, 5, b->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+
+    std::vector<RamDomain> out;
+    rel.decode(out);
+    EXPECT_EQ(6, out.size());
+    for (size_t i = 0; i < out.size(); i += 3) {
+        EXPECT_EQ(getPC(rel, out[i], out[i + 1])->getId(), out[i + 2]);
+    }
+    EXPECT_EQ(a->conjoin(b->negate()), getPC(rel, 0, MAX_RAM_DOMAIN));
+}
+
+TEST(BddRelation, Join) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    // edges 1 -> 2 under A and 2 -> 3 under B, 2 -> 4 always
+    BddRelation edge(2);
+    RamDomain data[] = {1, 2, a->getId(), 2, 3, b->getId(), 2, 4, PresenceCondition::makeTrue()->getId()};
+    edge.insertAll({&data[0], &data[3], &data[6]});
+
+    // path(x, z) :- edge(x, y), edge(y, z), z != 4.
+    BddRelation::Term term(PresenceCondition::makeTrue());
+    term.conjoin(edge.select({domain(0), domain(1)}));
+    term.conjoin(edge.select({domain(2), domain(3)}));
+    term.conjoin(BddRelation::Term::equal(size_t(1), size_t(2)));
+    term.conjoinNot(BddRelation::Term::equal(size_t(3), RamDomain(4)));
+    term.exists({1, 2});
+
+    BddRelation path(2);
+    path.insert(term, {domain(0), domain(3)});
+    EXPECT_EQ(1, path.size());
+    EXPECT_EQ(a->conjoin(b), getPC(path, 1, 3));
+
+    // projections onto constants and repeated domains, filtered by a known relation
+    BddRelation known(2);
+    RamDomain k[3] = {1, 1, a->getId()};
+    known.insert(k);
+    BddRelation loop(2);
+    loop.insert(term, {domain(0), domain(0)}, &known);
+    loop.insert(term, {constant(7), domain(3)});
+    EXPECT_EQ(1, loop.size());
+    EXPECT_EQ(PresenceCondition::makeFalse(), getPC(loop, 1, 1));
+    EXPECT_EQ(a->conjoin(b), getPC(loop, 7, 3));
+
+    // selection of a constant column
+    EXPECT_TRUE(edge.select({constant(3), {Column::UNBOUND, 0}}).isFalse());
+    EXPECT_FALSE(edge.select({constant(2), {Column::UNBOUND, 0}}).isFalse());
+}
+
+TEST(BddRelation, InterpreterRelation) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+
+    // the tuples of a BDD relation are visible through its indexes
+    InterpreterRelation rel(2, false, true);
+    ASSERT_TRUE(rel.getBdd() != nullptr);
+    RamDomain t1[3] = {4, 2, a->getId()};
+    RamDomain t2[3] = {1, 2, PresenceCondition::makeTrue()->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+    EXPECT_EQ(2, rel.size());
+
+    RamDomain low[3] = {MIN_RAM_DOMAIN, 2, 0};
+    RamDomain high[3] = {MAX_RAM_DOMAIN, 2, 0};
+    size_t count = 0;
+    auto range = rel.getIndex(2)->lowerUpperBound(low, high);
+    for (auto it = range.first; it != range.second; ++it) {
+        EXPECT_EQ(2, (*it)[1]);
+        count++;
+    }
+    EXPECT_EQ(2, count);
+
+    // merging a regular relation into a BDD relation
+    InterpreterRelation regular(2, false);
+    RamDomain t3[3] = {4, 2, a->negate()->getId()};
+    regular.insert(t3);
+    rel.insert(regular);
+    EXPECT_EQ(PresenceCondition::makeTrue(), rel.getBdd()->getPC(t1));
+
+    // single insertions are buffered until the relation is read
+    InterpreterRelation buffered(2, false, true);
+    const size_t inserted = 3000;
+    for (size_t i = 0; i < inserted; i++) {
+        RamDomain tuple[3] = {RamDomain(i), RamDomain(i % 7), a->getId()};
+        buffered.insert(tuple);
+    }
+    EXPECT_EQ(inserted, buffered.size());
+    RamDomain last[3] = {RamDomain(inserted - 1), RamDomain((inserted - 1) % 7), 0};
+    EXPECT_EQ(a, buffered.exists(last, nullptr));
+    buffered.purge();
+    EXPECT_TRUE(buffered.empty());
+}
+
+}  // end namespace test
+}  // end namespace souffle
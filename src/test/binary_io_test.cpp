@@ -0,0 +1,102 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file binary_io_test.cpp
+ *
+ * Test cases for the binary relation format
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "IODirectives.h"
+#include "InterpreterRelation.h"
+#include "PresenceCondition.h"
+#include "ReadStreamBinary.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStreamBinary.h"
+#include "pc_test.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace souffle {
+namespace test {
+
+namespace {
+
+IODirectives directives(const std::string& fileName) {
+    IODirectives ioDirectives;
+    ioDirectives.setIOType("binary");
+    ioDirectives.setFileName(fileName);
+    ioDirectives.setRelationName("r");
+    return ioDirectives;
+}
+
+}  // namespace
+
+TEST(BinaryIO, RoundTrip) {
+    SymbolTable& features = initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const std::string fileName = "binary_io_test.bin";
+
+    // write a relation of a symbol and a number column
+    SymbolTable written;
+    SymbolMask mask({true, false});
+    InterpreterRelation out(2, false);
+    RamDomain t1[3] = {written.lookup("x"), 1, PresenceCondition::makeTrue()->getId()};
+    RamDomain t2[3] = {written.lookup("y"), 2, a->getId()};
+    RamDomain t3[3] = {written.lookup("x"), 3, a->negate()->getId()};
+    out.insert(t1);
+    out.insert(t2);
+    out.insert(t3);
+    WriteFileBinary(mask, written, features, directives(fileName)).writeAll(out);
+
+    // read it into a program with a different symbol table
+    SymbolTable read;
+    read.lookup("z");
+    InterpreterRelation in(2, false);
+    ReadFileBinary(mask, read, features, directives(fileName)).readAll(in);
+    EXPECT_EQ(3, in.size());
+    EXPECT_EQ(3, read.size());
+
+    RamDomain q1[3] = {read.lookup("x"), 1, 0};
+    RamDomain q2[3] = {read.lookup("y"), 2, 0};
+    RamDomain q3[3] = {read.lookup("x"), 3, 0};
+    RamDomain q4[3] = {read.lookup("x"), 2, 0};
+    const RamDomain* found = nullptr;
+    EXPECT_EQ(PresenceCondition::makeTrue(), in.exists(q1, found));
+    EXPECT_EQ(a, in.exists(q2, found));
+    EXPECT_EQ(a->negate(), in.exists(q3, found));
+    EXPECT_EQ(PresenceCondition::makeFalse(), in.exists(q4, found));
+
+    std::remove(fileName.c_str());
+}
+
+TEST(BinaryIO, RejectsOtherFiles) {
+    SymbolTable& features = initPCs();
+    const std::string fileName = "binary_io_test.txt";
+    std::ofstream(fileName) << "1\t2\n3\t4\n5\t6\n7\t8\n9\t10\n11\t12\n13\t14\n";
+
+    SymbolTable symbols;
+    bool rejected = false;
+    try {
+        ReadFileBinary(SymbolMask(2), symbols, features, directives(fileName));
+    } catch (std::invalid_argument&) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+
+    std::remove(fileName.c_str());
+}
+
+}  // namespace test
+}  // namespace souffle
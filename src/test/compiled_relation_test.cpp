@@ -15,6 +15,7 @@
  ***********************************************************************/
 
 #include "CompiledRelation.h"
+#include "pc_test.h"
 #include "test.h"
 
 namespace souffle {
@@ -174,6 +175,8 @@ TEST(IndicesTools, GetPrefix) {
 }
 
 TEST(Relation, Basic) {
+    test::initPCs();
+
     using relation_t = Relation<Auto, 2>;
 
     relation_t data;
@@ -356,6 +359,8 @@ TEST(Relation, Structure_Brie) {
 }
 
 TEST(Relation, BigTuple) {
+    test::initPCs();
+
     using relation_t = Relation<Auto, 5>;
 
     relation_t data;
@@ -389,12 +394,15 @@ TEST(Relation, BigTuple) {
 }
 
 TEST(Relation, Indices) {
+    test::initPCs();
+
     int count = 0;
 
     Relation<Auto, 2, index<0>, index<1>> data;
     using tuple_t = decltype(data)::tuple_type;
 
-    EXPECT_EQ(2 * sizeof(RamDomain), sizeof(tuple_t));
+    // the values are followed by the presence condition column
+    EXPECT_EQ(3 * sizeof(RamDomain), sizeof(tuple_t));
 
     for (int i = 0; i < 5; i++) {
         for (int j = 0; j < 5; j++) {
@@ -487,6 +495,8 @@ TEST(Relation, Indices) {
 }
 
 TEST(Relation, EqualRange) {
+    test::initPCs();
+
     Relation<Auto, 2, index<0, 1>, index<1, 0>> rel;
     using tuple_t = decltype(rel)::tuple_type;
 
@@ -534,8 +544,10 @@ TEST(Relation, EqualRange) {
 }
 
 TEST(Relation, NullArity) {
+    test::initPCs();
+
     Relation<Auto, 0> rel;
-    EXPECT_EQ(0, sizeof(Relation<Auto, 0>::tuple_type));  // strange, but true
+    EXPECT_EQ(sizeof(RamDomain), sizeof(Relation<Auto, 0>::tuple_type));  // just the presence condition
 
     EXPECT_EQ(0, rel.size());
     EXPECT_TRUE(rel.empty());
@@ -577,6 +589,8 @@ int count(const C& c) {
 }
 
 TEST(Relation, SingleIndex) {
+    test::initPCs();
+
     Relation<Auto, 2, index<1, 0>> rel;
 
     EXPECT_TRUE(rel.empty());
@@ -618,6 +632,8 @@ template <typename T>
 void consume(T t) {}
 
 TEST(Relation, SingleIndexEqualRange) {
+    test::initPCs();
+
     using rel_type = Relation<Auto, 3, index<0>>;
     using tuple_type = typename rel_type::tuple_type;
 
@@ -665,6 +681,8 @@ TEST(Relation, SingleIndexEqualRange) {
 }
 
 TEST(Relation, SingleIndexLowerUpperBound) {
+    test::initPCs();
+
     using rel_type = Relation<Auto, 3, index<0>>;
     using tuple_type = typename rel_type::tuple_type;
 
@@ -735,6 +753,8 @@ TEST(Relation, SingleIndexLowerUpperBound) {
 }
 
 TEST(Relation, Partition_0D) {
+    test::initPCs();
+
     using rel_type = Relation<Auto, 0>;
     using tuple_type = typename rel_type::tuple_type;
 
@@ -766,6 +786,8 @@ TEST(Relation, Partition_0D) {
 }
 
 TEST(Relation, Partition_1D) {
+    test::initPCs();
+
     const int N = 1000;
 
     using rel_type = Relation<Auto, 1, index<0>>;
@@ -801,6 +823,8 @@ TEST(Relation, Partition_1D) {
 }
 
 TEST(Relation, Partition_2D) {
+    test::initPCs();
+
     const int N = 1000;
 
     using rel_type = Relation<Auto, 2, index<0, 1>>;
@@ -838,6 +862,8 @@ TEST(Relation, Partition_2D) {
 }
 
 TEST(Relation, PartitionBug_InsertAll) {
+    test::initPCs();
+
     using rel_type = Relation<Auto, 2>;
     using tuple_type = typename rel_type::tuple_type;
 
@@ -871,5 +897,276 @@ TEST(Relation, PartitionBug_InsertAll) {
     EXPECT_EQ(all, is);
 }
 
+namespace {
+
+/** Checks the presence conditions kept by a binary relation, recording the checks in the given test case */
+template <typename Rel>
+void checkLiftedInsert(TestCase& test, Rel& rel) {
+    using tuple_type = typename Rel::tuple_type;
+
+    // the checks below expand to these names
+    auto evaluate = [&](bool condition) { return test.evaluate(condition); };
+    std::ostream& logstream = std::cerr;
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+    const PresenceCondition* ff = PresenceCondition::makeFalse();
+
+    EXPECT_TRUE(rel.insertLifted(tuple_type({{1, 2}}), a));
+    EXPECT_FALSE(rel.insertLifted(tuple_type({{1, 2}}), b));
+    EXPECT_TRUE(rel.insertLifted(tuple_type({{2, 3}}), b));
+    EXPECT_FALSE(rel.insertLifted(tuple_type({{3, 4}}), a->conjoin(a->negate())));
+    EXPECT_EQ(2, rel.size());
+
+    EXPECT_EQ(a->disjoin(b), rel.getPC(tuple_type({{1, 2}})));
+    EXPECT_EQ(b, rel.getPC(tuple_type({{2, 3}})));
+    EXPECT_EQ(ff, rel.getPC(tuple_type({{3, 4}})));
+    EXPECT_EQ(a->disjoin(b), rel.getRangePC(rel));
+
+    // the conditions are found for the tuples of scans as well
+    for (const auto& cur : rel) {
+        EXPECT_EQ(cur[0] == 1 ? a->disjoin(b) : b, rel.getPC(cur));
+    }
+
+    // tuples inserted without a condition are unconditional
+    rel.insert(5, 6);
+    EXPECT_EQ(PresenceCondition::makeTrue(), rel.getPC(tuple_type({{5, 6}})));
+
+    // tuples given by their values are present under the given condition
+    const RamDomain values[] = {7, 8};
+    rel.insert(values, a);
+    EXPECT_EQ(a, rel.getPC(tuple_type({{7, 8}})));
+
+    rel.purge();
+    EXPECT_EQ(ff, rel.getPC(tuple_type({{1, 2}})));
+}
+
+}  // namespace
+
+TEST(Relation, LiftedInsert) {
+    test::initPCs();
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    Relation<Auto, 2> autoRel;
+    checkLiftedInsert(*this, autoRel);
+    Relation<Auto, 2, index<0, 1>, index<1, 0>> directRel;
+    checkLiftedInsert(*this, directRel);
+    Relation<BTree, 2, index<1>> btreeRel;
+    checkLiftedInsert(*this, btreeRel);
+    Relation<Brie, 2> brieRel;
+    checkLiftedInsert(*this, brieRel);
+    Relation<Brie, 2, index<0, 1>, index<1, 0>> brieIndexedRel;
+    checkLiftedInsert(*this, brieIndexedRel);
+    Relation<Rbtset, 2, index<0, 1>, index<1>> rbtsetRel;
+    checkLiftedInsert(*this, rbtsetRel);
+    Relation<Hashset, 2> hashsetRel;
+    checkLiftedInsert(*this, hashsetRel);
+    Relation<Auto, 8, index<0, 1, 2>, index<2, 3, 4>> bigRel;
+    EXPECT_TRUE(bigRel.insertLifted({{1, 2, 3, 4, 5, 6, 7, 8}}, a));
+    EXPECT_FALSE(bigRel.insertLifted({{1, 2, 3, 4, 5, 6, 7, 8}}, b));
+    EXPECT_EQ(a->disjoin(b), bigRel.getPC({{1, 2, 3, 4, 5, 6, 7, 8}}));
+    for (const auto& cur : bigRel.equalRange<2, 3, 4>({{0, 0, 3, 4, 5, 0, 0, 0}})) {
+        EXPECT_EQ(a->disjoin(b), bigRel.getPC(cur));
+    }
+}
+
+namespace {
+
+/** Checks the presence conditions read for the tuples of scans after duplicates widened them */
+template <typename Rel>
+void checkScanPC(TestCase& test, Rel& rel) {
+    using tuple_type = typename Rel::tuple_type;
+
+    // the checks below expand to these names
+    auto evaluate = [&](bool condition) { return test.evaluate(condition); };
+    std::ostream& logstream = std::cerr;
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    rel.insertLifted(tuple_type({{1, 2}}), a);
+    rel.insertLifted(tuple_type({{2, 1}}), b);
+    rel.insertLifted(tuple_type({{1, 2}}), b);
+
+    int count = 0;
+    for (const auto& cur : rel) {
+        EXPECT_EQ(rel.getPC(cur), rel.getScanPC(cur));
+        count++;
+    }
+    EXPECT_EQ(2, count);
+
+    for (const auto& cur : rel.template equalRange<0>(tuple_type({{1, 0}}))) {
+        EXPECT_EQ(a->disjoin(b), rel.template getEqualRangePC<0>(cur));
+    }
+    for (const auto& cur : rel.template equalRange<1>(tuple_type({{0, 2}}))) {
+        EXPECT_EQ(a->disjoin(b), rel.template getEqualRangePC<1>(cur));
+    }
+    for (const auto& cur : rel.template equalRange<0, 1>(tuple_type({{2, 1}}))) {
+        EXPECT_EQ(b, (rel.template getEqualRangePC<0, 1>(cur)));
+    }
+}
+
+}  // namespace
+
+TEST(Relation, ScanPC) {
+    test::initPCs();
+
+    Relation<Auto, 2, index<0, 1>, index<1>> autoRel;
+    checkScanPC(*this, autoRel);
+    Relation<Auto, 2, index<0, 1>, index<1, 0>> directRel;
+    checkScanPC(*this, directRel);
+    Relation<Auto, 2, index<1, 0>, index<0, 1>> reversedRel;
+    checkScanPC(*this, reversedRel);
+    Relation<BTree, 2, index<0, 1>, index<1>> btreeRel;
+    checkScanPC(*this, btreeRel);
+    Relation<Brie, 2, index<0, 1>, index<1, 0>> brieRel;
+    checkScanPC(*this, brieRel);
+    Relation<Rbtset, 2, index<0, 1>, index<1>> rbtsetRel;
+    checkScanPC(*this, rbtsetRel);
+
+    // tuples too large for direct indices are referenced by all indices
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+    Relation<Auto, 8, index<0, 1, 2>, index<2, 3, 4>> bigRel;
+    bigRel.insertLifted({{1, 2, 3, 4, 5, 6, 7, 8}}, a);
+    bigRel.insertLifted({{1, 2, 3, 4, 5, 6, 7, 8}}, b);
+    for (const auto& cur : bigRel) {
+        EXPECT_EQ(a->disjoin(b), bigRel.getScanPC(cur));
+    }
+    for (const auto& cur : bigRel.equalRange<2, 3, 4>({{0, 0, 3, 4, 5, 0, 0, 0}})) {
+        EXPECT_EQ(a->disjoin(b), (bigRel.getEqualRangePC<2, 3, 4>(cur)));
+    }
+}
+
+namespace {
+
+/** Merges relations through the overload for relations of the same implementation */
+template <template <typename T, typename I, bool d> class IndexFactory, unsigned arity, typename Primary,
+        typename... Indices>
+void mergeSameType(detail::DirectIndexedRelation<IndexFactory, arity, Primary, Indices...>& rel,
+        const detail::DirectIndexedRelation<IndexFactory, arity, Primary, Indices...>& other) {
+    rel.insertAll(other);
+}
+
+/** Merges relations through the overload for relations of the same implementation */
+template <unsigned arity, typename Index, template <typename T, typename I, bool d> class IndexFactory>
+void mergeSameType(detail::SingleIndexRelation<arity, Index, IndexFactory>& rel,
+        const detail::SingleIndexRelation<arity, Index, IndexFactory>& other) {
+    rel.insertAll(other);
+}
+
+/** Checks that merging relations of the same implementation keeps the conditions of duplicates */
+template <typename Rel>
+void checkLiftedInsertAll(TestCase& test) {
+    using tuple_type = typename Rel::tuple_type;
+
+    // the checks below expand to these names
+    auto evaluate = [&](bool condition) { return test.evaluate(condition); };
+    std::ostream& logstream = std::cerr;
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    Rel rel;
+    Rel other;
+    rel.insertLifted(tuple_type({{1, 2}}), a);
+    other.insertLifted(tuple_type({{1, 2}}), b);
+    other.insertLifted(tuple_type({{2, 3}}), b);
+
+    // merging into an empty relation copies the conditions
+    Rel copy;
+    mergeSameType(copy, other);
+    EXPECT_EQ(b, copy.getPC(tuple_type({{1, 2}})));
+    EXPECT_EQ(b, copy.getPC(tuple_type({{2, 3}})));
+
+    mergeSameType(rel, other);
+    EXPECT_EQ(2, rel.size());
+    EXPECT_EQ(a->disjoin(b), rel.getPC(tuple_type({{1, 2}})));
+    EXPECT_EQ(b, rel.getPC(tuple_type({{2, 3}})));
+}
+
+}  // namespace
+
+TEST(Relation, LiftedInsertAll) {
+    test::initPCs();
+
+    checkLiftedInsertAll<Relation<Auto, 2, index<0, 1>, index<1, 0>>>(*this);
+    checkLiftedInsertAll<Relation<BTree, 2, index<0, 1>, index<1, 0>>>(*this);
+    checkLiftedInsertAll<Relation<Brie, 2, index<0, 1>, index<1, 0>>>(*this);
+    checkLiftedInsertAll<Relation<BTree, 2>>(*this);
+    checkLiftedInsertAll<Relation<Brie, 2>>(*this);
+}
+
+TEST(Relation, LiftedInsertNullary) {
+    test::initPCs();
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    Relation<Auto, 0> rel;
+    EXPECT_EQ(PresenceCondition::makeFalse(), rel.getPC({{}}));
+
+    EXPECT_TRUE(rel.insertLifted({{}}, a));
+    EXPECT_FALSE(rel.insertLifted({{}}, b));
+    EXPECT_EQ(a->disjoin(b), rel.getPC({{}}));
+
+    Relation<Auto, 0> other;
+    other.insert();
+    other.insertAll(rel);
+    EXPECT_EQ(PresenceCondition::makeTrue(), other.getPC({{}}));
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_EQ(PresenceCondition::makeFalse(), rel.getPC({{}}));
+}
+
+TEST(Relation, LiftedInsertEqRel) {
+    test::initPCs();
+
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    Relation<EqRel, 2> rel;
+    rel.insertLifted({{1, 2}}, a);
+    rel.insertLifted({{1, 2}}, b);
+    EXPECT_EQ(a->disjoin(b), rel.getPC({{1, 2}}));
+
+    // pairs only implied by the closure are unconditional
+    EXPECT_EQ(PresenceCondition::makeTrue(), rel.getPC({{2, 1}}));
+    EXPECT_EQ(PresenceCondition::makeFalse(), rel.getPC({{1, 3}}));
+}
+
+TEST(Relation, LiftedInsertParallel) {
+    test::initPCs();
+
+    const int N = 1000;
+    const int K = 8;
+
+    std::vector<const PresenceCondition*> pcs;
+    const PresenceCondition* all = PresenceCondition::makeFalse();
+    for (int i = 0; i < K; i++) {
+        pcs.push_back(PresenceCondition::parse("F" + std::to_string(i)));
+        all = all->disjoin(pcs.back());
+    }
+
+    // every tuple is inserted once under each condition, concurrently
+    Relation<Auto, 2, index<0, 1>, index<1, 0>> rel;
+    Relation<Brie, 2> brie;
+#pragma omp parallel for
+    for (int i = 0; i < N * K; i++) {
+        rel.insertLifted({{i % N, 0}}, pcs[i / N]);
+        brie.insertLifted({{i % N, 0}}, pcs[i / N]);
+    }
+
+    EXPECT_EQ(N, rel.size());
+    EXPECT_EQ(N, brie.size());
+    for (const auto& cur : rel) {
+        EXPECT_EQ(all, rel.getPC(cur));
+        EXPECT_EQ(all, brie.getPC(cur));
+    }
+}
+
 }  // namespace ram
 }  // end namespace souffle
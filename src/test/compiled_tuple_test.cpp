@@ -28,12 +28,13 @@ using namespace std;
 TEST(Tuple, Basic) {
     Tuple<int, 3> t = {{1, 3, 2}};
 
-    EXPECT_EQ(3 * sizeof(int), sizeof(t));
+    // the values are followed by the presence condition column
+    EXPECT_EQ(4 * sizeof(int), sizeof(t));
 
     std::cout << t << "\n";
 
     Tuple<int, 2> t2 = {{1, 5}};
-    EXPECT_EQ(2 * sizeof(int), sizeof(t2));
+    EXPECT_EQ(3 * sizeof(int), sizeof(t2));
     std::cout << t2 << "\n";
 }
 
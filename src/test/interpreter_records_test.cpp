@@ -0,0 +1,87 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file interpreter_records_test.cpp
+ *
+ * Test cases for the records of the interpreter
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "InterpreterRecords.h"
+
+#include <vector>
+
+namespace souffle {
+namespace test {
+
+TEST(InterpreterRecords, PackUnpack) {
+    RamDomain a[] = {1, 2, 3};
+    RamDomain b[] = {1, 2, 4};
+
+    RamDomain refA = pack(a, 3);
+    RamDomain refB = pack(b, 3);
+    EXPECT_FALSE(isNull(refA));
+    EXPECT_FALSE(isNull(refB));
+    EXPECT_NE(refA, refB);
+
+    // equal tuples obtain the same reference
+    RamDomain c[] = {1, 2, 3};
+    EXPECT_EQ(refA, pack(c, 3));
+
+    const RamDomain* tuple = unpack(refB, 3);
+    EXPECT_EQ(1, tuple[0]);
+    EXPECT_EQ(2, tuple[1]);
+    EXPECT_EQ(4, tuple[2]);
+
+    // references of different arities are independent
+    RamDomain d[] = {1, 2};
+    EXPECT_EQ(1, unpack(pack(d, 2), 2)[0]);
+    EXPECT_EQ(3, unpack(refA, 3)[2]);
+}
+
+TEST(InterpreterRecords, ManyRecords) {
+    // exceed the first blocks of the store
+    const RamDomain N = 100000;
+    std::vector<RamDomain> refs(N);
+    for (RamDomain i = 0; i < N; i++) {
+        RamDomain tuple[] = {i, -i};
+        refs[i] = pack(tuple, 2);
+    }
+    for (RamDomain i = 0; i < N; i++) {
+        const RamDomain* tuple = unpack(refs[i], 2);
+        EXPECT_EQ(i, tuple[0]);
+        EXPECT_EQ(-i, tuple[1]);
+    }
+}
+
+TEST(InterpreterRecords, ParallelPack) {
+    // all threads pack the same records
+    const int N = 10000;
+    const int T = 4;
+    std::vector<std::vector<RamDomain>> refs(T, std::vector<RamDomain>(N));
+#pragma omp parallel for num_threads(T)
+    for (int t = 0; t < T; t++) {
+        for (int i = 0; i < N; i++) {
+            RamDomain tuple[] = {i, i + 1, 7};
+            refs[t][i] = pack(tuple, 3);
+        }
+    }
+    for (int t = 1; t < T; t++) {
+        EXPECT_EQ(refs[0], refs[t]);
+    }
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(i + 1, unpack(refs[0][i], 3)[1]);
+    }
+}
+
+}  // namespace test
+}  // namespace souffle
@@ -0,0 +1,223 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file interpreter_relation_test.cpp
+ *
+ * Test cases for the lifted relations of the interpreter
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "pc_test.h"
+
+#include "InterpreterRelation.h"
+#include "PresenceCondition.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace souffle {
+namespace test {
+
+namespace {
+
+/** The presence condition of a tuple, or False if the tuple is not contained */
+const PresenceCondition* getPC(const InterpreterRelation& rel, RamDomain x, RamDomain y) {
+    RamDomain tuple[3] = {x, y, 0};
+    const RamDomain* out = nullptr;
+    return rel.exists(tuple, out);
+}
+
+}  // namespace
+
+TEST(InterpreterRelation, BatchInsert) {
+    initPCs();
+    RamDomain tt = PresenceCondition::makeTrue()->getId();
+    RamDomain ff = PresenceCondition::makeFalse()->getId();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    InterpreterRelation rel(2, false);
+    rel.getIndex(2);
+
+    // duplicates within a batch have their presence conditions disjoined
+    std::vector<RamDomain> data = {3, 1, a->getId(), 1, 2, tt, 3, 1, b->getId(), 2, 2, ff};
+    std::vector<const RamDomain*> tuples;
+    for (size_t i = 0; i < data.size(); i += 3) {
+        tuples.push_back(&data[i]);
+    }
+    rel.insertAll(tuples);
+    EXPECT_EQ(2, rel.size());
+    EXPECT_EQ(a->disjoin(b), getPC(rel, 3, 1));
+    EXPECT_EQ(PresenceCondition::makeFalse(), getPC(rel, 2, 2));
+
+    // so do duplicates of contained tuples, and new tuples reach all indexes
+    InterpreterRelation other(2, false);
+    RamDomain t1[3] = {1, 2, a->getId()};
+    RamDomain t2[3] = {4, 2, b->getId()};
+    other.insert(t1);
+    other.insert(t2);
+    rel.insert(other);
+    EXPECT_EQ(3, rel.size());
+    EXPECT_EQ(PresenceCondition::makeTrue(), getPC(rel, 1, 2));
+
+    RamDomain low[3] = {MIN_RAM_DOMAIN, 2, 0};
+    RamDomain high[3] = {MAX_RAM_DOMAIN, 2, 0};
+    auto range = rel.getIndex(2)->lowerUpperBound(low, high);
+    size_t count = 0;
+    for (auto it = range.first; it != range.second; ++it) {
+        count++;
+    }
+    EXPECT_EQ(2, count);
+}
+
+TEST(InterpreterRelation, Partition) {
+    initPCs();
+    RamDomain tt = PresenceCondition::makeTrue()->getId();
+
+    // the parts cover all tuples once, across the blocks of the relation
+    InterpreterRelation rel(3, false);
+    EXPECT_TRUE(rel.partition(4).empty());
+    const RamDomain count = 1000;
+    for (RamDomain i = 0; i < count; i++) {
+        RamDomain tuple[4] = {i, i % 3, i % 5, tt};
+        rel.insert(tuple);
+    }
+    for (size_t num : {size_t(1), size_t(7), size_t(400), size_t(2000)}) {
+        auto parts = rel.partition(num);
+        EXPECT_TRUE(parts.size() <= num);
+        std::vector<bool> seen(count, false);
+        for (auto& part : parts) {
+            EXPECT_FALSE(part.empty());
+            for (const RamDomain* cur : part) {
+                EXPECT_FALSE(seen[cur[0]]);
+                seen[cur[0]] = true;
+            }
+        }
+        EXPECT_EQ(size_t(count), size_t(std::count(seen.begin(), seen.end(), true)));
+    }
+
+    // nullary relations form a single part
+    InterpreterRelation nullary(0, false);
+    RamDomain unit[1] = {tt};
+    nullary.insert(unit);
+    EXPECT_EQ(1, nullary.partition(4).size());
+}
+
+TEST(InterpreterRelation, IndexSummaries) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* notA = a->negate();
+
+    InterpreterRelation rel(2, false);
+    InterpreterIndex* idx = rel.getIndex(1);
+    RamDomain t1[3] = {1, 1, a->getId()};
+    RamDomain t2[3] = {1, 2, a->getId()};
+    RamDomain t3[3] = {2, 1, notA->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+    rel.insert(t3);
+
+    // ranges are skipped if none of their tuples is compatible
+    RamDomain one[3] = {1, 0, 0};
+    RamDomain two[3] = {2, 0, 0};
+    RamDomain three[3] = {3, 0, 0};
+    EXPECT_TRUE(idx->mayMatch(one, a));
+    EXPECT_FALSE(idx->mayMatch(one, notA));
+    EXPECT_TRUE(idx->mayMatch(two, notA));
+    EXPECT_FALSE(idx->mayMatch(three, PresenceCondition::makeTrue()));
+
+    // widening the condition of a contained tuple widens its range
+    RamDomain t4[3] = {1, 2, notA->getId()};
+    rel.insert(t4);
+    EXPECT_TRUE(idx->mayMatch(one, notA));
+    EXPECT_TRUE(idx->mayMatch(one, notA));
+
+    // partial orders do not end in the presence condition column and are not summarised
+    InterpreterIndex partial(InterpreterIndexOrder({1}));
+    partial.insert(t3);
+    EXPECT_TRUE(partial.mayMatch(one, a));
+
+    rel.purge();
+    EXPECT_FALSE(idx->mayMatch(one, a));
+}
+
+TEST(InterpreterRelation, EquivalencePaths) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    InterpreterRelation rel(2, true);
+    RamDomain t1[3] = {1, 2, a->getId()};
+    RamDomain t2[3] = {2, 3, b->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+
+    // pairs are present under the conditions of the paths connecting them
+    EXPECT_EQ(9, rel.size());
+    EXPECT_EQ(a, getPC(rel, 1, 1));
+    EXPECT_EQ(a, getPC(rel, 2, 1));
+    EXPECT_EQ(a->disjoin(b), getPC(rel, 2, 2));
+    EXPECT_EQ(a->conjoin(b), getPC(rel, 1, 3));
+    EXPECT_EQ(a->conjoin(b), getPC(rel, 3, 1));
+
+    // a second path adds its condition
+    RamDomain t3[3] = {1, 3, b->negate()->getId()};
+    rel.insert(t3);
+    EXPECT_EQ(a->conjoin(b)->disjoin(b->negate()), getPC(rel, 1, 3));
+
+    // extending a new relation by a full one yields the pairs of the merged components
+    InterpreterRelation delta(2, true);
+    RamDomain t4[3] = {3, 4, PresenceCondition::makeTrue()->getId()};
+    delta.insert(t4);
+    delta.extend(rel);
+    EXPECT_EQ(b->disjoin(a->conjoin(b->negate())), getPC(delta, 2, 4));
+    rel.insert(delta);
+    EXPECT_EQ(16, rel.size());
+    EXPECT_EQ(getPC(delta, 2, 4), getPC(rel, 4, 2));
+
+    delta.purge();
+    EXPECT_EQ(0, delta.size());
+}
+
+TEST(InterpreterRelation, EquivalenceIncremental) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+    const PresenceCondition* c = PresenceCondition::parse("C");
+    const PresenceCondition* tt = PresenceCondition::makeTrue();
+    std::vector<std::vector<RamDomain>> edges = {{1, 2, a->getId()}, {3, 4, b->getId()},
+            {2, 3, c->getId()}, {4, 1, a->negate()->getId()}, {5, 5, b->getId()},
+            {2, 4, a->conjoin(b)->getId()}, {5, 1, c->negate()->getId()}, {6, 2, a->getId()},
+            {1, 2, a->getId()}, {3, 6, b->disjoin(c)->getId()}, {7, 8, tt->getId()}, {8, 1, tt->getId()},
+            {3, 7, tt->getId()}};
+
+    // inserting edges one at a time yields the pairs of inserting them as a batch
+    InterpreterRelation single(2, true);
+    InterpreterRelation batch(2, true);
+    std::vector<const RamDomain*> tuples;
+    for (const auto& edge : edges) {
+        single.insert(edge.data());
+        tuples.push_back(edge.data());
+    }
+    batch.insertAll(tuples);
+
+    EXPECT_EQ(batch.size(), single.size());
+    for (RamDomain x = 1; x <= 8; x++) {
+        for (RamDomain y = 1; y <= 8; y++) {
+            EXPECT_EQ(getPC(batch, x, y), getPC(single, x, y));
+        }
+    }
+}
+
+}  // namespace test
+}  // namespace souffle
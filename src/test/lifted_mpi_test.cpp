@@ -0,0 +1,133 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file lifted_mpi_test.cpp
+ *
+ * Tests the exchange of lifted relations between MPI processes; run on
+ * a single process, only the encoding of presence conditions is tested.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "LiftedMpi.h"
+#include "Mpi.h"
+#include "PresenceCondition.h"
+#include "SymbolTable.h"
+
+#include <array>
+#include <vector>
+
+namespace souffle {
+namespace test {
+
+namespace {
+
+/** A relation of pairs with presence conditions, as exchanged by the lifted functions */
+class PairRelation {
+public:
+    using tuple_type = std::array<RamDomain, 2>;
+
+    size_t size() const {
+        return tuples.size();
+    }
+
+    std::vector<tuple_type>::const_iterator begin() const {
+        return tuples.begin();
+    }
+
+    std::vector<tuple_type>::const_iterator end() const {
+        return tuples.end();
+    }
+
+    void insert(const RamDomain* tuple, const PresenceCondition* pc) {
+        tuples.push_back({{tuple[0], tuple[1]}});
+        pcs.push_back(pc);
+    }
+
+    const PresenceCondition* getPC(const tuple_type& tuple) const {
+        for (size_t i = 0; i < tuples.size(); ++i) {
+            if (tuples[i] == tuple) {
+                return pcs[i];
+            }
+        }
+        return PresenceCondition::makeFalse();
+    }
+
+private:
+    std::vector<tuple_type> tuples;
+    std::vector<const PresenceCondition*> pcs;
+};
+
+/** The tag of the exchanged relation, beyond the tags of the symbol table */
+const int RELATION_TAG = SymbolTable::numberOfTags() + 1;
+
+}  // namespace
+
+TEST(LiftedMpi, Exchange) {
+    SymbolTable features;
+    const int rank = mpi::commRank();
+    if (rank > 1) {
+        return;
+    }
+    PresenceCondition::init(features);
+
+    if (mpi::commSize() == 1) {
+        // conditions are decoded to the same canonical conditions
+        const PresenceCondition* a = PresenceCondition::parse("A");
+        const PresenceCondition* b = PresenceCondition::parse("B");
+        std::vector<const PresenceCondition*> pcs = {PresenceCondition::makeTrue(),
+                PresenceCondition::makeFalse(), a, a->negate(), a->conjoin(b->negate()),
+                a->disjoin(b), a->conjoin(b)->disjoin(a->negate()->conjoin(b->negate()))};
+        std::vector<RamDomain> buffer;
+        for (const PresenceCondition* pc : pcs) {
+            pc->serialise(buffer);
+        }
+        size_t pos = 0;
+        for (const PresenceCondition* pc : pcs) {
+            EXPECT_EQ(pc, PresenceCondition::deserialise(buffer, pos));
+        }
+        EXPECT_EQ(buffer.size(), pos);
+        return;
+    }
+
+    if (rank == 1) {
+        // conditions over features numbered by the root process
+        const PresenceCondition* a = PresenceCondition::parse("A");
+        const PresenceCondition* b = PresenceCondition::parse("B");
+        PairRelation rel;
+        std::vector<RamDomain> t1 = {1, 2};
+        std::vector<RamDomain> t2 = {2, 3};
+        std::vector<RamDomain> t3 = {3, 4};
+        rel.insert(t1.data(), a);
+        rel.insert(t2.data(), a->conjoin(b->negate()));
+        rel.insert(t3.data(), a);
+
+        // the root process serves symbol requests until this process is done with them
+        mpi::send(0, SymbolTable::exitTag());
+        mpi::recv(0, SymbolTable::exitTag());
+        mpi::sendLifted<RamDomain>(rel, 2, {0}, RELATION_TAG);
+        return;
+    }
+
+    features.handleMpiMessages(1);
+    auto status = mpi::probe(1, RELATION_TAG);
+    PairRelation rel;
+    mpi::recvLifted<RamDomain>(rel, 2, status);
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+    EXPECT_EQ(3, rel.size());
+    EXPECT_EQ(a, rel.getPC({{1, 2}}));
+    EXPECT_EQ(a->conjoin(b->negate()), rel.getPC({{2, 3}}));
+    EXPECT_EQ(a, rel.getPC({{3, 4}}));
+}
+
+}  // namespace test
+}  // namespace souffle
@@ -0,0 +1,3 @@
+#!/bin/sh
+# Runs the exchange of lifted relations on two MPI processes
+exec ${MPIRUN:-mpirun} -np 2 ./test/lifted_mpi_test
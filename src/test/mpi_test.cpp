@@ -16,6 +16,7 @@
 
 #include <vector>
 
+#include "LiftedMpi.h"
 #include "Mpi.h"
 #include "test.h"
 
@@ -31,5 +32,41 @@ TEST(mpi, mpi) {
         EXPECT_EQ(mpi::commSize(), 1);
     }
 }
+TEST(mpi, GroupStrata) {
+    // three strata, of which strata 0 and 2 are partitioned
+    std::vector<int> partitioned = {0, 2};
+    EXPECT_EQ(mpi::Group::getStratum(1, 3, partitioned), 0);
+    EXPECT_EQ(mpi::Group::getStratum(3, 3, partitioned), 2);
+    EXPECT_EQ(mpi::Group::getStratum(4, 3, partitioned), 0);
+    EXPECT_EQ(mpi::Group::getStratum(5, 3, partitioned), 2);
+    EXPECT_EQ(mpi::Group::getStratum(6, 3, partitioned), 0);
+    EXPECT_EQ(mpi::Group::getStratum(4, 3, {}), -1);
+
+    auto group = mpi::Group::getGroup(6, 0, 3, partitioned, 7);
+    EXPECT_EQ(group.size(), 3);
+    EXPECT_EQ(group.getLeader(), 1);
+    EXPECT_EQ(group.getPosition(), 2);
+    EXPECT_FALSE(group.isLeader());
+    EXPECT_EQ(group.getHelpers(), std::set<int>({4, 6}));
+
+    auto single = mpi::Group::getGroup(2, 1, 3, partitioned, 7);
+    EXPECT_EQ(single.size(), 1);
+    EXPECT_TRUE(single.isLeader());
+    EXPECT_TRUE(single.getHelpers().empty());
+}
+
+TEST(mpi, GroupOwners) {
+    auto group = mpi::Group::getGroup(1, 0, 1, {0}, 4);
+    std::vector<int> owned(group.size());
+    for (RamDomain value = 0; value < 1000; ++value) {
+        size_t owner = group.getOwner(value);
+        EXPECT_LT(owner, group.size());
+        owned[owner]++;
+    }
+    // consecutive values are spread over all processes
+    for (int count : owned) {
+        EXPECT_LT(200, count);
+    }
+}
 }  // namespace test
 }  // namespace souffle
@@ -0,0 +1,36 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2013, 2014, Oracle and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file pc_test.h
+ *
+ * Set-up of the presence condition subsystem shared by unit tests
+ *
+ ***********************************************************************/
+#pragma once
+
+#include "PresenceCondition.h"
+#include "SymbolTable.h"
+
+namespace souffle {
+namespace test {
+
+/** Initialises the presence condition subsystem once for all test cases, returning the feature table */
+inline SymbolTable& initPCs() {
+    static SymbolTable features;
+    static bool initialised = false;
+    if (!initialised) {
+        PresenceCondition::init(features);
+        initialised = true;
+    }
+    return features;
+}
+
+}  // end namespace test
+}  // end namespace souffle
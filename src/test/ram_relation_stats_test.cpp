@@ -8,33 +8,50 @@
 
 /************************************************************************
  *
- * @file ram_relation_stats_test.h
+ * @file ram_relation_stats_test.cpp
  *
  * Tests for the ram relation statistics extraction utility.
  *
  ***********************************************************************/
 
+#include "CompiledRelation.h"
 #include "IOSystem.h"
-#include "Interpreter.h"
+#include "InterpreterRelation.h"
+#include "PresenceCondition.h"
 #include "ReadStream.h"
+#include "RelationStats.h"
+#include "SymbolTable.h"
+#include "pc_test.h"
 #include "test.h"
 
 #include <fstream>
 #include <memory>
 
-using namespace souffle;
-
+namespace souffle {
 namespace test {
 
+namespace {
+
+/** Inserts a tuple present in all configurations into an interpreter relation */
+template <typename... Args>
+void insert(InterpreterRelation& rel, Args... args) {
+    RamDomain tuple[] = {RamDomain(args)..., PresenceCondition::makeTrue()->getId()};
+    rel.insert(tuple);
+}
+
+}  // namespace
+
 TEST(Stats, Basic) {
+    initPCs();
+
     // create a table
-    InterpreterRelation rel(3);
+    InterpreterRelation rel(3, false);
 
     // add some values
-    rel.insert(1, 1, 1);
-    rel.insert(1, 2, 1);
-    rel.insert(1, 3, 2);
-    rel.insert(1, 4, 2);
+    insert(rel, 1, 1, 1);
+    insert(rel, 1, 2, 1);
+    insert(rel, 1, 3, 2);
+    insert(rel, 1, 4, 2);
 
     RelationStats stats = RelationStats::extractFrom(rel);
 
@@ -44,12 +61,14 @@ TEST(Stats, Basic) {
 }
 
 TEST(Stats, Function) {
+    initPCs();
+
     // create a table
-    InterpreterRelation rel(2);
+    InterpreterRelation rel(2, false);
 
     // add some values
     for (int i = 0; i < 10000; i++) {
-        rel.insert(i, i % 5);
+        insert(rel, i, i % 5);
     }
 
     RelationStats stats = RelationStats::extractFrom(rel, 100);
@@ -61,9 +80,70 @@ TEST(Stats, Function) {
     EXPECT_EQ(500, stats.getEstimatedCardinality(1));
 }
 
+TEST(Stats, PresenceConditions) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const PresenceCondition* b = PresenceCondition::parse("B");
+
+    InterpreterRelation rel(1, false);
+    RamDomain t1[] = {1, a->getId()};
+    RamDomain t2[] = {2, b->getId()};
+    RamDomain t3[] = {3, a->getId()};
+    RamDomain t4[] = {4, PresenceCondition::makeTrue()->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+    rel.insert(t3);
+    rel.insert(t4);
+
+    RelationStats stats = RelationStats::extractFrom(rel);
+
+    EXPECT_EQ(4, stats.getCardinality());
+    EXPECT_EQ(3, stats.getNumPCs());
+    EXPECT_EQ(1, stats.getNumTruePCs());
+}
+
+TEST(Stats, FeatureModel) {
+    initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    PresenceCondition* model = PresenceCondition::parse("A \\/ B");
+    PresenceCondition::setFeatureModel(model);
+
+    // tuples present in all valid configurations carry the feature model
+    InterpreterRelation rel(1, false);
+    RamDomain t1[] = {1, a->getId()};
+    RamDomain t2[] = {2, PresenceCondition::makeTrue()->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+
+    RelationStats stats = RelationStats::extractFrom(rel);
+    PresenceCondition::setFeatureModel(nullptr);
+
+    EXPECT_EQ(2, stats.getNumPCs());
+    EXPECT_EQ(1, stats.getNumTruePCs());
+}
+
+TEST(Stats, Compiled) {
+    initPCs();
+
+    ram::Relation<ram::BTree, 2> rel;
+    for (int i = 0; i < 1000; i++) {
+        rel.insert(i, i % 10);
+    }
+
+    RelationStats stats = RelationStats::extractFrom(rel);
+
+    EXPECT_EQ(2, stats.getArity());
+    EXPECT_EQ(1000, stats.getCardinality());
+    EXPECT_EQ(1000, stats.getEstimatedCardinality(0));
+    EXPECT_EQ(10, stats.getEstimatedCardinality(1));
+    EXPECT_EQ(1, stats.getNumPCs());
+}
+
 TEST(Stats, Convergence) {
+    SymbolTable& features = initPCs();
+
     // load a table
-    InterpreterRelation rel(2);
+    InterpreterRelation rel(2, false);
 
     SymbolTable symTable;
 
@@ -81,16 +161,16 @@ TEST(Stats, Convergence) {
         if (!in.is_open()) return;
 
         std::unique_ptr<ReadStream> reader =
-                IOSystem::getInstance().getReader(mask, symTable, ioDirectives, false);
+                IOSystem::getInstance().getReader(mask, symTable, features, ioDirectives, false);
         reader->readAll(rel);
     }
 
     std::cout << rel.size() << "\n";
 
-    InterpreterRelation rel2(3);
+    InterpreterRelation rel2(3, false);
 
     for (const auto& cur : rel) {
-        rel2.insert(cur[0], cur[1], 1);
+        insert(rel2, cur[0], cur[1], 1);
     }
 
     RelationStats full = RelationStats::extractFrom(rel2);
@@ -118,3 +198,4 @@ TEST(Stats, Convergence) {
 }
 
 }  // end namespace test
+}  // end namespace souffle
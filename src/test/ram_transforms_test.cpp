@@ -0,0 +1,199 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_transforms_test.cpp
+ *
+ * Tests the RAM transformation passes.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "BinaryConstraintOps.h"
+#include "RamCondition.h"
+#include "RamOperation.h"
+#include "RamProgram.h"
+#include "RamStatement.h"
+#include "RamTransforms.h"
+#include "RamValue.h"
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+std::unique_ptr<RamRelation> relation(const std::string& name, unsigned arity) {
+    return std::make_unique<RamRelation>(name, arity);
+}
+
+std::unique_ptr<RamCondition> equal(std::unique_ptr<RamValue> lhs, std::unique_ptr<RamValue> rhs) {
+    return std::make_unique<RamBinaryRelation>(BinaryConstraintOp::EQ, std::move(lhs), std::move(rhs));
+}
+
+/** Builds the loop nest SCAN a AS t0 / SCAN b AS t1 / PROJECT (t0.0) INTO target */
+std::unique_ptr<RamProject> projection(const std::string& target) {
+    auto project = std::make_unique<RamProject>(relation(target, 1), 2);
+    project->addArg(std::make_unique<RamElementAccess>(0, 0));
+    return project;
+}
+
+std::unique_ptr<RamInsert> insert(std::unique_ptr<RamProject> project) {
+    auto inner = std::make_unique<RamScan>(relation("b", 2), std::move(project), false);
+    return std::make_unique<RamInsert>(std::make_unique<RamScan>(relation("a", 2), std::move(inner), false));
+}
+
+const RamScan& outerScan(const RamStatement& stmt) {
+    return static_cast<const RamScan&>(static_cast<const RamInsert&>(stmt).getOperation());
+}
+
+const RamScan& innerScan(const RamStatement& stmt) {
+    return static_cast<const RamScan&>(outerScan(stmt).getOperation());
+}
+
+}  // namespace
+
+TEST(HoistConditions, MovesConjunctsToBindingLevel) {
+    auto project = projection("c");
+    project->addCondition(
+            equal(std::make_unique<RamElementAccess>(0, 0), std::make_unique<RamElementAccess>(0, 1)),
+                *project);
+    project->addCondition(
+            equal(std::make_unique<RamElementAccess>(1, 0), std::make_unique<RamElementAccess>(1, 1)),
+                *project);
+    RamProgram program(insert(std::move(project)));
+
+    EXPECT_TRUE(HoistConditionsTransformer::hoistConditions(program));
+
+    const RamStatement& stmt = *program.getMain();
+    EXPECT_TRUE(outerScan(stmt).getCondition() != nullptr);
+    EXPECT_EQ(0, outerScan(stmt).getCondition()->getLevel());
+    EXPECT_TRUE(innerScan(stmt).getCondition() != nullptr);
+    EXPECT_EQ(1, innerScan(stmt).getCondition()->getLevel());
+    EXPECT_TRUE(innerScan(stmt).getOperation().getCondition() == nullptr);
+
+    // nothing left to hoist
+    EXPECT_FALSE(HoistConditionsTransformer::hoistConditions(program));
+}
+
+TEST(CreateIndices, TurnsHoistedEqualitiesIntoRangePatterns) {
+    auto project = projection("c");
+    project->addCondition(
+            equal(std::make_unique<RamElementAccess>(1, 1), std::make_unique<RamElementAccess>(0, 0)),
+                *project);
+    RamProgram program(insert(std::move(project)));
+
+    EXPECT_TRUE(HoistConditionsTransformer::hoistConditions(program));
+    EXPECT_EQ(0, innerScan(*program.getMain()).getRangeQueryColumns());
+
+    EXPECT_TRUE(CreateIndicesTransformer::createIndices(program));
+    EXPECT_EQ(2, innerScan(*program.getMain()).getRangeQueryColumns());
+    EXPECT_TRUE(innerScan(*program.getMain()).getCondition() == nullptr);
+}
+
+TEST(RemoveRedundantExistenceChecks, NegationOfUnwrittenRelation) {
+    auto makeProgram = [](std::unique_ptr<RamStatement> load) {
+        auto project = projection("c");
+        auto negation = std::make_unique<RamNotExists>(relation("d", 1));
+        negation->addArg(std::make_unique<RamElementAccess>(1, 0));
+        project->addCondition(std::move(negation), *project);
+        auto seq = std::make_unique<RamSequence>();
+        seq->add(std::move(load));
+        seq->add(insert(std::move(project)));
+        return std::make_unique<RamProgram>(std::move(seq));
+    };
+
+    // d is never written
+    auto program = makeProgram(nullptr);
+    EXPECT_TRUE(RemoveRedundantExistenceChecksTransformer::removeRedundantExistenceChecks(*program));
+    const auto& stmts = static_cast<const RamSequence*>(program->getMain())->getStatements();
+    EXPECT_TRUE(innerScan(*stmts[0]).getOperation().getCondition() == nullptr);
+
+    // d is loaded
+    program = makeProgram(std::make_unique<RamLoad>(relation("d", 1), std::vector<IODirectives>()));
+    EXPECT_FALSE(RemoveRedundantExistenceChecksTransformer::removeRedundantExistenceChecks(*program));
+}
+
+TEST(RemoveRedundantExistenceChecks, RepeatedConjuncts) {
+    auto project = projection("c");
+    for (int i = 0; i < 2; i++) {
+        project->addCondition(
+                equal(std::make_unique<RamElementAccess>(1, 0), std::make_unique<RamElementAccess>(0, 1)),
+                *project);
+    }
+    RamProgram program(insert(std::move(project)));
+
+    EXPECT_TRUE(RemoveRedundantExistenceChecksTransformer::removeRedundantExistenceChecks(program));
+    const RamCondition* condition = innerScan(*program.getMain()).getOperation().getCondition();
+    EXPECT_TRUE(condition != nullptr);
+    EXPECT_TRUE(dynamic_cast<const RamBinaryRelation*>(condition) != nullptr);
+}
+
+TEST(MergeInserts, SharedOuterScan) {
+    auto seq = std::make_unique<RamSequence>();
+    seq->add(insert(projection("c")));
+    seq->add(insert(projection("d")));
+    RamProgram program(std::move(seq));
+
+    EXPECT_TRUE(MergeInsertsTransformer::mergeInserts(program));
+    const auto& stmts = static_cast<const RamSequence*>(program.getMain())->getStatements();
+    EXPECT_EQ(1, stmts.size());
+    const auto* branch = dynamic_cast<const RamBranch*>(&outerScan(*stmts[0]).getOperation());
+    EXPECT_TRUE(branch != nullptr);
+    EXPECT_EQ(2, branch->getBranches().size());
+    EXPECT_EQ(3, outerScan(*stmts[0]).getDepth());
+}
+
+TEST(MergeInserts, DebugInfo) {
+    auto seq = std::make_unique<RamSequence>();
+    seq->add(std::make_unique<RamDebugInfo>(insert(projection("c")), "c(x) :- a(x,_), b(_,_)."));
+    seq->add(std::make_unique<RamDebugInfo>(insert(projection("d")), "d(x) :- a(x,_), b(_,_)."));
+    RamProgram program(std::move(seq));
+
+    // the merged statement reports both rules
+    EXPECT_TRUE(MergeInsertsTransformer::mergeInserts(program));
+    const auto& stmts = static_cast<const RamSequence*>(program.getMain())->getStatements();
+    EXPECT_EQ(1, stmts.size());
+    const auto* debugInfo = dynamic_cast<const RamDebugInfo*>(stmts[0]);
+    EXPECT_TRUE(debugInfo != nullptr);
+    EXPECT_EQ("c(x) :- a(x,_), b(_,_).\nd(x) :- a(x,_), b(_,_).", debugInfo->getMessage());
+
+    // a rule without debug information takes the one of the merged rule
+    auto mixed = std::make_unique<RamSequence>();
+    mixed->add(insert(projection("c")));
+    mixed->add(std::make_unique<RamDebugInfo>(insert(projection("d")), "d(x) :- a(x,_), b(_,_)."));
+    RamProgram mixedProgram(std::move(mixed));
+
+    EXPECT_TRUE(MergeInsertsTransformer::mergeInserts(mixedProgram));
+    const auto& mixedStmts = static_cast<const RamSequence*>(mixedProgram.getMain())->getStatements();
+    EXPECT_EQ(1, mixedStmts.size());
+    debugInfo = dynamic_cast<const RamDebugInfo*>(mixedStmts[0]);
+    EXPECT_TRUE(debugInfo != nullptr);
+    EXPECT_EQ("d(x) :- a(x,_), b(_,_).", debugInfo->getMessage());
+}
+
+TEST(MergeInserts, DependentInserts) {
+    // the second insert reads the relation written by the first one
+    auto project = projection("d");
+    auto negation = std::make_unique<RamNotExists>(relation("c", 1));
+    negation->addArg(std::make_unique<RamElementAccess>(0, 0));
+    project->addCondition(std::move(negation), *project);
+
+    auto seq = std::make_unique<RamSequence>();
+    seq->add(insert(projection("c")));
+    seq->add(insert(std::move(project)));
+    RamProgram program(std::move(seq));
+
+    EXPECT_FALSE(MergeInsertsTransformer::mergeInserts(program));
+    EXPECT_EQ(2, static_cast<const RamSequence*>(program.getMain())->getStatements().size());
+}
+
+}  // end namespace test
+}  // end namespace souffle
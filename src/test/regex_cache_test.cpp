@@ -0,0 +1,60 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file regex_cache_test.cpp
+ *
+ * Tests the cache of compiled match patterns.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "RegexCache.h"
+
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(RegexCache, AgreesWithRegexMatch) {
+    const std::vector<std::string> patterns = {"abc", "abc.*", ".*abc", ".*abc.*", ".*", "", "a.c", "a*",
+            "(ab)+", ".*b.*c", "[a-c]+"};
+    const std::vector<std::string> texts = {
+            "", "abc", "abcd", "xabc", "xabcx", "ab", "a\nabc", "abc\n", "aac", "ababab", "bbb"};
+
+    RegexCache cache;
+    for (int round = 0; round < 2; round++) {
+        for (size_t i = 0; i < patterns.size(); i++) {
+            for (const auto& text : texts) {
+                EXPECT_EQ(std::regex_match(text, std::regex(patterns[i])),
+                        cache.match(i, patterns[i], text));
+            }
+        }
+    }
+}
+
+TEST(RegexCache, InvalidPattern) {
+    RegexCache cache;
+    for (int round = 0; round < 2; round++) {
+        bool thrown = false;
+        try {
+            cache.match(0, "b.*[", "abba");
+        } catch (const std::regex_error&) {
+            thrown = true;
+        }
+        EXPECT_TRUE(thrown);
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,96 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file sqlite_io_test.cpp
+ *
+ * Test cases for the presence conditions of the SQLite output
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "InterpreterRelation.h"
+#include "PresenceCondition.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStreamSQLite.h"
+#include "pc_test.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace souffle {
+namespace test {
+
+namespace {
+
+/** Runs a query, returning its rows with the columns separated by commas */
+std::vector<std::string> query(sqlite3* db, const std::string& sql) {
+    std::vector<std::string> rows;
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK) {
+        return rows;
+    }
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+        std::string row;
+        for (int i = 0; i < sqlite3_column_count(statement); i++) {
+            const unsigned char* text = sqlite3_column_text(statement, i);
+            row += (i == 0 ? "" : ",") + std::string(text ? reinterpret_cast<const char*>(text) : "");
+        }
+        rows.push_back(row);
+    }
+    sqlite3_finalize(statement);
+    return rows;
+}
+
+}  // namespace
+
+TEST(SQLiteIO, PresenceConditions) {
+    SymbolTable& features = initPCs();
+    const PresenceCondition* a = PresenceCondition::parse("A");
+    const std::string dbName = "sqlite_io_test.db";
+    std::remove(dbName.c_str());
+
+    // write a relation of a symbol and a number column
+    SymbolTable symbols;
+    SymbolMask mask({true, false});
+    InterpreterRelation rel(2, false);
+    RamDomain t1[3] = {symbols.lookup("x"), 1, PresenceCondition::makeTrue()->getId()};
+    RamDomain t2[3] = {symbols.lookup("y"), 2, a->getId()};
+    RamDomain t3[3] = {symbols.lookup("x"), 3, a->getId()};
+    rel.insert(t1);
+    rel.insert(t2);
+    rel.insert(t3);
+    WriteStreamSQLite(dbName, "r", mask, symbols, features, false).writeAll(rel);
+
+    sqlite3* db = nullptr;
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(dbName.c_str(), &db));
+
+    // the view resolves the symbols and presence conditions of the tuples
+    std::vector<std::string> rows = query(db, "SELECT \"0\", \"1\", pc FROM r ORDER BY \"1\";");
+    EXPECT_EQ(3, rows.size());
+    EXPECT_EQ("x,1,True", rows[0]);
+    EXPECT_EQ("y,2,A", rows[1]);
+    EXPECT_EQ("x,3,A", rows[2]);
+
+    // each condition is stored once
+    rows = query(db, "SELECT COUNT(*) FROM __PresenceConditions;");
+    EXPECT_EQ(1, rows.size());
+    EXPECT_EQ("2", rows[0]);
+
+    sqlite3_close(db);
+    std::remove(dbName.c_str());
+}
+
+}  // namespace test
+}  // namespace souffle
@@ -140,4 +140,51 @@ TEST(SymbolTable, Inserts) {
     if (ECHO_TIME) std::cout << "Time to insert " << N << " new elements: " << n << " ns" << std::endl;
 }
 
+TEST(SymbolTable, BulkLookup) {
+    SymbolTable table({"a", "b"});
+
+    std::vector<RamDomain> indices = table.lookup(std::vector<std::string>({"c", "a", "d", "c"}));
+
+    EXPECT_EQ(4, indices.size());
+    EXPECT_EQ(2, indices[0]);
+    EXPECT_EQ(0, indices[1]);
+    EXPECT_EQ(3, indices[2]);
+    EXPECT_EQ(2, indices[3]);
+    EXPECT_EQ(4, table.size());
+}
+
+TEST(SymbolTable, Move) {
+    SymbolTable a;
+    for (int i = 0; i < 5000; i++) {
+        a.insert(std::to_string(i));
+    }
+
+    SymbolTable b(std::move(a));
+    EXPECT_EQ(5000, b.size());
+    EXPECT_EQ(0, a.size());
+    EXPECT_STREQ("4321", b.resolve(4321));
+    EXPECT_EQ(4321, b.lookup("4321"));
+
+    a = std::move(b);
+    EXPECT_EQ(5000, a.size());
+    EXPECT_EQ(4999, a.lookupExisting("4999"));
+}
+
+TEST(SymbolTable, ParallelLookup) {
+    const int N = 20000;
+    SymbolTable table;
+    std::vector<RamDomain> indices(2 * N);
+
+#pragma omp parallel for
+    for (int i = 0; i < 2 * N; i++) {
+        indices[i] = table.lookup(std::to_string(i % N));
+    }
+
+    EXPECT_EQ(N, table.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(indices[i], indices[i + N]);
+        EXPECT_EQ(std::to_string(i), table.resolve(indices[i]));
+    }
+}
+
 }  // end namespace test
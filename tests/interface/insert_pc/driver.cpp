@@ -0,0 +1,105 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for inserting and retrieving tuples with presence
+ * conditions using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    // create an instance of program "insert_pc"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("insert_pc")) {
+        // get input relation "edge"
+        if (Relation* edge = prog->getRelation("edge")) {
+            // load data into relation "edge", each edge present under a condition
+            std::vector<std::array<std::string, 3>> myData = {
+                    {"A", "B", "F1"}, {"B", "C", "F2"}, {"C", "D", "!F1"}};
+            for (auto input : myData) {
+                tuple t(edge);
+                t << input[0] << input[1];
+                t.setPC(PresenceCondition::parse(input[2]));
+                edge->insert(t);
+            }
+
+            // run program
+            prog->run();
+
+            // get output relation "path"
+            if (Relation* path = prog->getRelation("path")) {
+                // print the paths present in each configuration
+                std::vector<std::vector<std::string>> configurations = {{}, {"F1"}, {"F2"}, {"F1", "F2"}};
+                for (const auto& features : configurations) {
+                    std::cout << "{";
+                    for (size_t i = 0; i < features.size(); i++) {
+                        std::cout << (i == 0 ? "" : ",") << features[i];
+                    }
+                    std::cout << "}:";
+                    path->forEachIn(PresenceCondition::toConfiguration(features), [](const tuple& t) {
+                        std::string src, dest;
+                        tuple output(t);
+                        output >> src >> dest;
+                        std::cout << " " << src << "-" << dest;
+                    });
+                    std::cout << "\n";
+                }
+
+                // look up the conditions of single paths
+                const PresenceCondition* f1 = PresenceCondition::parse("F1");
+                const PresenceCondition* f2 = PresenceCondition::parse("F2");
+                tuple ac(path);
+                ac << "A" << "C";
+                std::cout << "A-C " << (path->getPC(ac) == f1->conjoin(f2) ? "under F1 and F2" : "wrong")
+                          << "\n";
+                tuple ad(path);
+                ad << "A" << "D";
+                std::cout << "A-D " << (path->getPC(ad)->isSAT() ? "present" : "absent") << "\n";
+
+                // features not known to the program are rejected
+                try {
+                    PresenceCondition::toConfiguration({"F3"});
+                    std::cout << "F3 accepted\n";
+                } catch (std::invalid_argument& e) {
+                    std::cout << e.what() << "\n";
+                }
+            } else {
+                error("cannot find relation path");
+            }
+
+            // free program analysis
+            delete prog;
+
+        } else {
+            error("cannot find relation edge");
+        }
+    } else {
+        error("cannot find program insert_pc");
+    }
+}